@@ -6,12 +6,17 @@
 /// This implements blocking and non-blocking broadcasting functions. Two
 /// function names are overloaded accross Omega data types: I4, I8, R4, R8,
 /// Real, bool, and std::string: 1) Broadcast for blocking mode and 2) mpiIbcast
-/// for non- blocking mode.
+/// for non- blocking mode. The BroadcastPack class packs many values of mixed
+/// type into a single buffer so they can be sent with one (blocking or
+/// non-blocking) broadcast.
 //
 //===----------------------------------------------------------------------===//
 
 #include "Broadcast.h"
 
+#include <cstring>
+#include <limits>
+
 namespace OMEGA {
 
 //------------------------------------------------------------------------------
@@ -185,20 +190,395 @@ int Broadcast(std::vector<R8> &Value, const int RankBcast) {
 
 //------------------------------------------------------------------------------
 // Broadcast bool array
-// Elements of vector<bool> seem to be non-addressable
-// int Broadcast(std::vector<bool> &Value, const MachEnv *InEnv, const int
-// RankBcast ) {
-//    int RetVal;
-//
-//    RetVal = MPI_Bcast((void *)Value.data(), Value.size(), MPI_C_BOOL,
-//    RankBcast, InEnv->getComm());
-//
-//    return RetVal;
-//} // end Broadcast
-//
-// int Broadcast(std::vector<bool> &Value, const int RankBcast
-//) {
-//    return Broadcast(Value, MachEnv::getDefaultEnv(), RankBcast);
-//}
+// Elements of vector<bool> are not addressable so the values are copied to
+// a temporary byte array for the broadcast
+int Broadcast(std::vector<bool> &Value, const MachEnv *InEnv,
+              const int RankBcast) {
+   int RetVal, Root, VecSize;
+   MPI_Comm Comm = InEnv->getComm();
+   int MyTask    = InEnv->getMyTask();
+
+   Root = (RankBcast < 0) ? InEnv->getMasterTask() : RankBcast;
+   if (MyTask == Root)
+      VecSize = Value.size();
+   RetVal = MPI_Bcast(&VecSize, 1, MPI_INT, Root, Comm);
+
+   std::vector<char> Bytes(Value.begin(), Value.end());
+   Bytes.resize(VecSize);
+   RetVal = MPI_Bcast(Bytes.data(), VecSize, MPI_CHAR, Root, Comm);
+   Value.assign(Bytes.begin(), Bytes.end());
+
+   return RetVal;
+} // end Broadcast
+
+int Broadcast(std::vector<bool> &Value, const int RankBcast) {
+   return Broadcast(Value, MachEnv::getDefaultEnv(), RankBcast);
+}
+
+//------------------------------------------------------------------------------
+// BroadcastPack constructors and destructor
+BroadcastPack::BroadcastPack(const MachEnv *InEnv, const int RankBcast)
+    : Env(InEnv), Request(MPI_REQUEST_NULL), Pending(false) {
+   Root   = (RankBcast < 0) ? InEnv->getMasterTask() : RankBcast;
+   IsRoot = (InEnv->getMyTask() == Root);
+}
+
+BroadcastPack::BroadcastPack(const int RankBcast)
+    : BroadcastPack(MachEnv::getDefaultEnv(), RankBcast) {}
+
+BroadcastPack::~BroadcastPack() {
+   if (Pending)
+      wait();
+}
+
+//------------------------------------------------------------------------------
+// Add values of each supported type to the pack
+void BroadcastPack::add(I4 &Value) { Entries.push_back({PackI4, &Value}); }
+void BroadcastPack::add(I8 &Value) { Entries.push_back({PackI8, &Value}); }
+void BroadcastPack::add(R4 &Value) { Entries.push_back({PackR4, &Value}); }
+void BroadcastPack::add(R8 &Value) { Entries.push_back({PackR8, &Value}); }
+void BroadcastPack::add(bool &Value) { Entries.push_back({PackBool, &Value}); }
+void BroadcastPack::add(std::string &Value) {
+   Entries.push_back({PackString, &Value});
+}
+void BroadcastPack::add(std::vector<I4> &Value) {
+   Entries.push_back({PackVecI4, &Value});
+}
+void BroadcastPack::add(std::vector<I8> &Value) {
+   Entries.push_back({PackVecI8, &Value});
+}
+void BroadcastPack::add(std::vector<R4> &Value) {
+   Entries.push_back({PackVecR4, &Value});
+}
+void BroadcastPack::add(std::vector<R8> &Value) {
+   Entries.push_back({PackVecR8, &Value});
+}
+void BroadcastPack::add(std::vector<bool> &Value) {
+   Entries.push_back({PackVecBool, &Value});
+}
+
+//------------------------------------------------------------------------------
+// Removes all entries from the pack
+void BroadcastPack::clear() {
+   if (Pending)
+      wait();
+   Entries.clear();
+   Buffer.clear();
+}
+
+//------------------------------------------------------------------------------
+// Prepares a broadcast. The lengths of any strings and vectors are broadcast
+// first so that the receiving tasks can resize them, then the buffer is
+// sized and, on the root task, filled with the packed values.
+int BroadcastPack::start() {
+
+   int RetVal = MPI_SUCCESS;
+
+   // Collect the lengths of variable-length entries on the root task
+   std::vector<I8> Lengths;
+   for (const PackEntry &Entry : Entries) {
+      switch (Entry.Type) {
+      case PackString:
+         Lengths.push_back(static_cast<std::string *>(Entry.Ptr)->size());
+         break;
+      case PackVecI4:
+         Lengths.push_back(static_cast<std::vector<I4> *>(Entry.Ptr)->size());
+         break;
+      case PackVecI8:
+         Lengths.push_back(static_cast<std::vector<I8> *>(Entry.Ptr)->size());
+         break;
+      case PackVecR4:
+         Lengths.push_back(static_cast<std::vector<R4> *>(Entry.Ptr)->size());
+         break;
+      case PackVecR8:
+         Lengths.push_back(static_cast<std::vector<R8> *>(Entry.Ptr)->size());
+         break;
+      case PackVecBool:
+         Lengths.push_back(
+             static_cast<std::vector<bool> *>(Entry.Ptr)->size());
+         break;
+      default:
+         break;
+      }
+   }
+
+   if (!Lengths.empty()) {
+      RetVal = MPI_Bcast(Lengths.data(), Lengths.size(), MPI_INT64_T, Root,
+                         Env->getComm());
+      if (RetVal != MPI_SUCCESS)
+         return RetVal;
+   }
+
+   // Resize variable-length entries on receiving tasks and compute the
+   // total size of the buffer
+   std::size_t NBytes = 0;
+   int LenIndex       = 0;
+   for (const PackEntry &Entry : Entries) {
+      switch (Entry.Type) {
+      case PackI4:
+         NBytes += sizeof(I4);
+         break;
+      case PackI8:
+         NBytes += sizeof(I8);
+         break;
+      case PackR4:
+         NBytes += sizeof(R4);
+         break;
+      case PackR8:
+         NBytes += sizeof(R8);
+         break;
+      case PackBool:
+         NBytes += sizeof(char);
+         break;
+      case PackString:
+         static_cast<std::string *>(Entry.Ptr)->resize(Lengths[LenIndex]);
+         NBytes += Lengths[LenIndex++] * sizeof(char);
+         break;
+      case PackVecI4:
+         static_cast<std::vector<I4> *>(Entry.Ptr)->resize(Lengths[LenIndex]);
+         NBytes += Lengths[LenIndex++] * sizeof(I4);
+         break;
+      case PackVecI8:
+         static_cast<std::vector<I8> *>(Entry.Ptr)->resize(Lengths[LenIndex]);
+         NBytes += Lengths[LenIndex++] * sizeof(I8);
+         break;
+      case PackVecR4:
+         static_cast<std::vector<R4> *>(Entry.Ptr)->resize(Lengths[LenIndex]);
+         NBytes += Lengths[LenIndex++] * sizeof(R4);
+         break;
+      case PackVecR8:
+         static_cast<std::vector<R8> *>(Entry.Ptr)->resize(Lengths[LenIndex]);
+         NBytes += Lengths[LenIndex++] * sizeof(R8);
+         break;
+      case PackVecBool:
+         static_cast<std::vector<bool> *>(Entry.Ptr)->resize(
+             Lengths[LenIndex]);
+         NBytes += Lengths[LenIndex++] * sizeof(char);
+         break;
+      }
+   }
+
+   // MPI counts are limited to int
+   if (NBytes > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+      return -1;
+
+   Buffer.resize(NBytes);
+   if (IsRoot)
+      pack();
+
+   return RetVal;
+
+} // end start
+
+//------------------------------------------------------------------------------
+// Copies all values into the buffer on the root task
+void BroadcastPack::pack() {
+
+   char *Pos = Buffer.data();
+
+   // Copies a contiguous block of values into the buffer
+   auto copyIn = [&Pos](const void *Src, std::size_t NBytes) {
+      if (NBytes > 0)
+         std::memcpy(Pos, Src, NBytes);
+      Pos += NBytes;
+   };
+
+   for (const PackEntry &Entry : Entries) {
+      switch (Entry.Type) {
+      case PackI4:
+         copyIn(Entry.Ptr, sizeof(I4));
+         break;
+      case PackI8:
+         copyIn(Entry.Ptr, sizeof(I8));
+         break;
+      case PackR4:
+         copyIn(Entry.Ptr, sizeof(R4));
+         break;
+      case PackR8:
+         copyIn(Entry.Ptr, sizeof(R8));
+         break;
+      case PackBool:
+         *Pos++ = *static_cast<bool *>(Entry.Ptr) ? 1 : 0;
+         break;
+      case PackString: {
+         auto *Str = static_cast<std::string *>(Entry.Ptr);
+         copyIn(Str->data(), Str->size());
+         break;
+      }
+      case PackVecI4: {
+         auto *Vec = static_cast<std::vector<I4> *>(Entry.Ptr);
+         copyIn(Vec->data(), Vec->size() * sizeof(I4));
+         break;
+      }
+      case PackVecI8: {
+         auto *Vec = static_cast<std::vector<I8> *>(Entry.Ptr);
+         copyIn(Vec->data(), Vec->size() * sizeof(I8));
+         break;
+      }
+      case PackVecR4: {
+         auto *Vec = static_cast<std::vector<R4> *>(Entry.Ptr);
+         copyIn(Vec->data(), Vec->size() * sizeof(R4));
+         break;
+      }
+      case PackVecR8: {
+         auto *Vec = static_cast<std::vector<R8> *>(Entry.Ptr);
+         copyIn(Vec->data(), Vec->size() * sizeof(R8));
+         break;
+      }
+      case PackVecBool: {
+         auto *Vec = static_cast<std::vector<bool> *>(Entry.Ptr);
+         for (bool Val : *Vec)
+            *Pos++ = Val ? 1 : 0;
+         break;
+      }
+      }
+   }
+
+} // end pack
+
+//------------------------------------------------------------------------------
+// Copies all values out of the buffer on the receiving tasks
+void BroadcastPack::unpack() {
+
+   const char *Pos = Buffer.data();
+
+   // Copies a contiguous block of values out of the buffer
+   auto copyOut = [&Pos](void *Dst, std::size_t NBytes) {
+      if (NBytes > 0)
+         std::memcpy(Dst, Pos, NBytes);
+      Pos += NBytes;
+   };
+
+   for (const PackEntry &Entry : Entries) {
+      switch (Entry.Type) {
+      case PackI4:
+         copyOut(Entry.Ptr, sizeof(I4));
+         break;
+      case PackI8:
+         copyOut(Entry.Ptr, sizeof(I8));
+         break;
+      case PackR4:
+         copyOut(Entry.Ptr, sizeof(R4));
+         break;
+      case PackR8:
+         copyOut(Entry.Ptr, sizeof(R8));
+         break;
+      case PackBool:
+         *static_cast<bool *>(Entry.Ptr) = (*Pos++ != 0);
+         break;
+      case PackString: {
+         auto *Str = static_cast<std::string *>(Entry.Ptr);
+         copyOut(&(*Str)[0], Str->size());
+         break;
+      }
+      case PackVecI4: {
+         auto *Vec = static_cast<std::vector<I4> *>(Entry.Ptr);
+         copyOut(Vec->data(), Vec->size() * sizeof(I4));
+         break;
+      }
+      case PackVecI8: {
+         auto *Vec = static_cast<std::vector<I8> *>(Entry.Ptr);
+         copyOut(Vec->data(), Vec->size() * sizeof(I8));
+         break;
+      }
+      case PackVecR4: {
+         auto *Vec = static_cast<std::vector<R4> *>(Entry.Ptr);
+         copyOut(Vec->data(), Vec->size() * sizeof(R4));
+         break;
+      }
+      case PackVecR8: {
+         auto *Vec = static_cast<std::vector<R8> *>(Entry.Ptr);
+         copyOut(Vec->data(), Vec->size() * sizeof(R8));
+         break;
+      }
+      case PackVecBool: {
+         auto *Vec = static_cast<std::vector<bool> *>(Entry.Ptr);
+         for (std::size_t i = 0; i < Vec->size(); ++i)
+            (*Vec)[i] = (*Pos++ != 0);
+         break;
+      }
+      }
+   }
+
+} // end unpack
+
+//------------------------------------------------------------------------------
+// Broadcasts all values in the pack with a single blocking broadcast of the
+// packed buffer
+int BroadcastPack::broadcast() {
+
+   if (Pending)
+      return -1;
+
+   int RetVal = start();
+   if (RetVal != MPI_SUCCESS)
+      return RetVal;
+
+   RetVal = MPI_Bcast(Buffer.data(), Buffer.size(), MPI_CHAR, Root,
+                      Env->getComm());
+   if (RetVal == MPI_SUCCESS && !IsRoot)
+      unpack();
+
+   return RetVal;
+
+} // end broadcast
+
+//------------------------------------------------------------------------------
+// Starts a non-blocking broadcast of the packed buffer. Any lengths of
+// strings and vectors are broadcast before this routine returns.
+int BroadcastPack::ibroadcast() {
+
+   if (Pending)
+      return -1;
+
+   int RetVal = start();
+   if (RetVal != MPI_SUCCESS)
+      return RetVal;
+
+   RetVal  = MPI_Ibcast(Buffer.data(), Buffer.size(), MPI_CHAR, Root,
+                        Env->getComm(), &Request);
+   Pending = (RetVal == MPI_SUCCESS);
+
+   return RetVal;
+
+} // end ibroadcast
+
+//------------------------------------------------------------------------------
+// Tests for completion of a non-blocking broadcast, unpacking the values
+// if complete
+int BroadcastPack::test(bool &Done) {
+
+   Done = !Pending;
+   if (!Pending)
+      return MPI_SUCCESS;
+
+   int Flag   = 0;
+   int RetVal = MPI_Test(&Request, &Flag, MPI_STATUS_IGNORE);
+   if (RetVal == MPI_SUCCESS && Flag) {
+      Pending = false;
+      Done    = true;
+      if (!IsRoot)
+         unpack();
+   }
+
+   return RetVal;
+
+} // end test
+
+//------------------------------------------------------------------------------
+// Waits for a non-blocking broadcast to complete and unpacks the values
+int BroadcastPack::wait() {
+
+   if (!Pending)
+      return MPI_SUCCESS;
+
+   int RetVal = MPI_Wait(&Request, MPI_STATUS_IGNORE);
+   Pending    = false;
+   if (RetVal == MPI_SUCCESS && !IsRoot)
+      unpack();
+
+   return RetVal;
+
+} // end wait
 
 } // namespace OMEGA
@@ -6,7 +6,8 @@
 /// \brief Defines MPI broadcasting functions
 ///
 /// This header defines functions to broadcast Values from one MPI rank
-/// to another.
+/// to another, as well as a BroadcastPack class for broadcasting many
+/// values of mixed type in a single collective.
 //
 //===----------------------------------------------------------------------===//
 
@@ -14,6 +15,9 @@
 #include "MachEnv.h"
 #include "mpi.h"
 
+#include <string>
+#include <vector>
+
 namespace OMEGA {
 
 // blocking broadcast scalar
@@ -63,11 +67,102 @@ int Broadcast(std::vector<R8> &Value,
               const int RankBcast  = -1);
 int Broadcast(std::vector<R8> &Value, const int RankBcast);
 
-// NOTE: Elements of vector<bool> seem to be non-addressable
-// int Broadcast(std::vector<bool> &Value,
-//              const MachEnv *InEnv = MachEnv::getDefaultEnv(),
-//              const int RankBcast = -1);
-// int Broadcast(std::vector<bool> &Value, const int RankBcast);
+// Elements of vector<bool> are not addressable so the values are copied
+// to a byte buffer for the broadcast. The vector is resized on all tasks.
+int Broadcast(std::vector<bool> &Value,
+              const MachEnv *InEnv = MachEnv::getDefaultEnv(),
+              const int RankBcast  = -1);
+int Broadcast(std::vector<bool> &Value, const int RankBcast);
+
+/// A BroadcastPack collects a number of values of mixed type so that they
+/// can be broadcast together in a single collective. Values are added by
+/// reference, packed into one contiguous buffer on the root task, broadcast
+/// and unpacked into the same variables on all other tasks. Strings and
+/// vectors are resized on the receiving tasks; if any are present, their
+/// lengths are broadcast first in one additional small collective. All tasks
+/// must add the same sequence of value types. The broadcast can be blocking
+/// (broadcast) or non-blocking (ibroadcast followed by test or wait), in
+/// which case the values must not be accessed until the broadcast completes.
+class BroadcastPack {
+
+ public:
+   /// Creates an empty pack for broadcasting within an environment from
+   /// the given task (master task by default)
+   BroadcastPack(const MachEnv *InEnv = MachEnv::getDefaultEnv(),
+                 const int RankBcast  = -1);
+   BroadcastPack(const int RankBcast);
+
+   /// Completes any outstanding non-blocking broadcast
+   ~BroadcastPack();
+
+   /// Adds a value to the pack
+   void add(I4 &Value);
+   void add(I8 &Value);
+   void add(R4 &Value);
+   void add(R8 &Value);
+   void add(bool &Value);
+   void add(std::string &Value);
+   void add(std::vector<I4> &Value);
+   void add(std::vector<I8> &Value);
+   void add(std::vector<R4> &Value);
+   void add(std::vector<R8> &Value);
+   void add(std::vector<bool> &Value);
+
+   /// Broadcasts all values in the pack, blocking until complete
+   int broadcast();
+
+   /// Starts a non-blocking broadcast of all values in the pack
+   int ibroadcast();
+
+   /// Checks whether a non-blocking broadcast has completed and if so
+   /// unpacks the values
+   int test(bool &Done ///< [out] true if the broadcast is complete
+   );
+
+   /// Waits for a non-blocking broadcast to complete and unpacks the values
+   int wait();
+
+   /// Removes all values from the pack so it can be reused
+   void clear();
+
+ private:
+   /// Types of values that can be packed
+   enum PackType {
+      PackI4,
+      PackI8,
+      PackR4,
+      PackR8,
+      PackBool,
+      PackString,
+      PackVecI4,
+      PackVecI8,
+      PackVecR4,
+      PackVecR8,
+      PackVecBool
+   };
+
+   /// Each entry holds the type and address of a packed value
+   struct PackEntry {
+      PackType Type;
+      void *Ptr;
+   };
+
+   const MachEnv *Env; ///< environment for the broadcast
+   int Root;           ///< task broadcasting the values
+   bool IsRoot;        ///< true if this task is the root task
+
+   std::vector<PackEntry> Entries; ///< values in the pack
+   std::vector<char> Buffer;       ///< contiguous buffer of packed values
+   MPI_Request Request;            ///< request for non-blocking broadcast
+   bool Pending;                   ///< true if non-blocking bcast is active
+
+   /// Broadcasts lengths of strings and vectors and sizes the buffer
+   int start();
+
+   /// Copies values into the buffer (root) or from the buffer (others)
+   void pack();
+   void unpack();
+};
 
 // non-blocking broadcast scalar:
 
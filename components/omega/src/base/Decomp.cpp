@@ -19,14 +19,18 @@
 #include "IO.h"
 #include "Logging.h"
 #include "MachEnv.h"
+#include "Timer.h"
 #include "mpi.h"
 #include "parmetis.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <set>
 #include <string>
 #include <vector>
 
+#include <sys/stat.h>
+
 namespace OMEGA {
 
 // create the static class members
@@ -50,48 +54,516 @@ bool Decomp::validVertexID(I4 InVertexID) {
 }
 
 //------------------------------------------------------------------------------
-// Local routine that searches a std::vector<I4> for a particular entry and
-// returns the index of that entry. If not found, the size is returned
-// (corresponding to the last index + 1)
+// Local routine that exchanges variable-length lists of I4 values among all
+// tasks in a communicator. On input, SendLists[Task] contains the values
+// destined for Task. On output, RecvLists[Task] contains the values received
+// from Task. The list lengths are first exchanged with an all-to-all so that
+// the data can be sent with a single all-to-all-v call.
+
+int exchangeLists(
+    const std::vector<std::vector<I4>> &SendLists, // [in] values for each task
+    std::vector<std::vector<I4>> &RecvLists, // [out] values from each task
+    MPI_Comm Comm                            // [in] communicator to use
+) {
+
+   int Err = 0;
+
+   I4 NumTasks = SendLists.size();
+
+   // Exchange list lengths and compute the offsets of each list in the
+   // contiguous send and receive buffers
+   std::vector<I4> SendCounts(NumTasks, 0);
+   std::vector<I4> RecvCounts(NumTasks, 0);
+   std::vector<I4> SendDispls(NumTasks, 0);
+   std::vector<I4> RecvDispls(NumTasks, 0);
+   for (int Task = 0; Task < NumTasks; ++Task)
+      SendCounts[Task] = SendLists[Task].size();
+
+   Err = MPI_Alltoall(SendCounts.data(), 1, MPI_INT32_T, RecvCounts.data(), 1,
+                      MPI_INT32_T, Comm);
+   if (Err != 0) {
+      LOG_ERROR("Decomp: Error exchanging list sizes");
+      return Err;
+   }
+
+   I4 SendSize = 0;
+   I4 RecvSize = 0;
+   for (int Task = 0; Task < NumTasks; ++Task) {
+      SendDispls[Task] = SendSize;
+      RecvDispls[Task] = RecvSize;
+      SendSize += SendCounts[Task];
+      RecvSize += RecvCounts[Task];
+   }
+
+   // Pack the send lists, exchange and unpack the received lists
+   std::vector<I4> SendBuf(std::max(SendSize, 1));
+   std::vector<I4> RecvBuf(std::max(RecvSize, 1));
+   for (int Task = 0; Task < NumTasks; ++Task)
+      std::copy(SendLists[Task].begin(), SendLists[Task].end(),
+                SendBuf.begin() + SendDispls[Task]);
+
+   Err = MPI_Alltoallv(SendBuf.data(), SendCounts.data(), SendDispls.data(),
+                       MPI_INT32_T, RecvBuf.data(), RecvCounts.data(),
+                       RecvDispls.data(), MPI_INT32_T, Comm);
+   if (Err != 0) {
+      LOG_ERROR("Decomp: Error exchanging lists");
+      return Err;
+   }
+
+   RecvLists.resize(NumTasks);
+   for (int Task = 0; Task < NumTasks; ++Task)
+      RecvLists[Task].assign(RecvBuf.begin() + RecvDispls[Task],
+                             RecvBuf.begin() + RecvDispls[Task] +
+                                 RecvCounts[Task]);
+
+   return Err;
+
+} // end function exchangeLists
+
+//------------------------------------------------------------------------------
+// Local routine that retrieves rows of an index array stored in the initial
+// linear distribution. Each task requests the rows for a list of global IDs
+// from the task that holds them (the ID's home task in the linear
+// distribution) and the home task replies with the requested rows. This
+// replaces a broadcast of every chunk to all tasks with a single pair of
+// all-to-all exchanges. On output, RowData contains RowSize entries for each
+// requested ID in the same order as GlobIDs.
+
+int fetchLinearRows(
+    const std::vector<I4> &GlobIDs,  // [in] 1-based IDs of the needed rows
+    const std::vector<I4> &InitData, // [in] local rows in linear distrb
+    I4 RowSize,                      // [in] number of entries in each row
+    I4 NChunk,                       // [in] num rows per task in linear dstrb
+    std::vector<I4> &RowData,        // [out] rows for each requested ID
+    MPI_Comm Comm                    // [in] communicator to use
+) {
+
+   int Err = 0;
+
+   I4 NumTasks;
+   I4 MyTask;
+   MPI_Comm_size(Comm, &NumTasks);
+   MPI_Comm_rank(Comm, &MyTask);
+
+   // Sort the requests by home task
+   std::vector<std::vector<I4>> ReqLists(NumTasks);
+   std::vector<std::vector<I4>> QryLists(NumTasks);
+   for (I4 GlobID : GlobIDs)
+      ReqLists[(GlobID - 1) / NChunk].push_back(GlobID);
+
+   Err = exchangeLists(ReqLists, QryLists, Comm);
+   if (Err != 0)
+      return Err;
+
+   // Reply to each query with the rows for each requested ID
+   std::vector<std::vector<I4>> SendLists(NumTasks);
+   std::vector<std::vector<I4>> RecvLists(NumTasks);
+   I4 RowStart = MyTask * NChunk;
+   for (int Task = 0; Task < NumTasks; ++Task) {
+      SendLists[Task].reserve(QryLists[Task].size() * RowSize);
+      for (I4 QryID : QryLists[Task]) {
+         auto RowBegin = InitData.begin() + (QryID - 1 - RowStart) * RowSize;
+         SendLists[Task].insert(SendLists[Task].end(), RowBegin,
+                                RowBegin + RowSize);
+      }
+   }
+
+   Err = exchangeLists(SendLists, RecvLists, Comm);
+   if (Err != 0)
+      return Err;
+
+   // Replies from each task are in request order, so walk the original
+   // list and take the next row from the appropriate reply
+   std::vector<I4> NextRow(NumTasks, 0);
+   RowData.resize(GlobIDs.size() * RowSize);
+   I4 RowAdd = 0;
+   for (I4 GlobID : GlobIDs) {
+      I4 Task   = (GlobID - 1) / NChunk;
+      auto Next = RecvLists[Task].begin() + NextRow[Task] * RowSize;
+      std::copy(Next, Next + RowSize, RowData.begin() + RowAdd);
+      ++NextRow[Task];
+      RowAdd += RowSize;
+   }
+
+   return Err;
+
+} // end function fetchLinearRows
+
+//------------------------------------------------------------------------------
+// Local routine that builds a location directory in the initial linear
+// distribution. Each task sends the global ID and local address of each of
+// its owned entries to the task holding that ID in the linear distribution.
+// On output, LocInit contains the (task, local address) pair for every
+// entry in the local chunk of the linear distribution so that the location
+// can later be retrieved by any task with fetchLinearRows.
+
+int fillLocDirectory(
+    const ArrayHost1DI4 &LocalIDs, // [in] global ID of local entries
+    I4 NOwned,                     // [in] number of owned entries (first)
+    I4 NChunk,                     // [in] num entries per task in linear dstrb
+    std::vector<I4> &LocInit,      // [out] task, local add in linear dstrb
+    MPI_Comm Comm                  // [in] communicator to use
+) {
+
+   int Err = 0;
+
+   I4 NumTasks;
+   I4 MyTask;
+   MPI_Comm_size(Comm, &NumTasks);
+   MPI_Comm_rank(Comm, &MyTask);
+
+   // Send the ID and local address of each owned entry to its home task
+   std::vector<std::vector<I4>> SendLists(NumTasks);
+   std::vector<std::vector<I4>> RecvLists(NumTasks);
+   for (int Local = 0; Local < NOwned; ++Local) {
+      I4 GlobID = LocalIDs(Local);
+      I4 Task   = (GlobID - 1) / NChunk;
+      SendLists[Task].push_back(GlobID);
+      SendLists[Task].push_back(Local);
+   }
+
+   Err = exchangeLists(SendLists, RecvLists, Comm);
+   if (Err != 0)
+      return Err;
+
+   // Store the location of each entry in the local chunk
+   I4 Start = MyTask * NChunk;
+   for (int Task = 0; Task < NumTasks; ++Task) {
+      const std::vector<I4> &Recv = RecvLists[Task];
+      for (int n = 0; n < Recv.size(); n += 2) {
+         I4 Add               = Recv[n] - 1 - Start;
+         LocInit[2 * Add]     = Task;
+         LocInit[2 * Add + 1] = Recv[n + 1];
+      }
+   }
+
+   return Err;
+
+} // end function fillLocDirectory
 
-I4 srchVector(const std::vector<I4> &InVector, // vector to search
-              I4 Value                         // value to search for
+//------------------------------------------------------------------------------
+// Local routine that reads the number of active levels in each cell
+// (maxLevelCell) from the mesh file into the initial linear distribution.
+// Returns non-zero if the field is not present in the mesh file.
+
+int readCellLevels(const int MeshFileID, // [in] file ID for open mesh file
+                   const int MeshSysID,  // [in] IO system for mesh file
+                   const MachEnv *InEnv, // [in] machine env for MPI layout
+                   I4 NCellsGlobal,      // [in] total number of cells
+                   std::vector<I4> &LevelsInit // [out] levels in linear dstrb
 ) {
 
-   // first use the std::find routine to determine the iterator location
-   auto it = std::find(InVector.begin(), InVector.end(), Value);
-   // now translate the iterator into an actual vector index
-   I4 LocIndx = std::distance(InVector.begin(), it);
+   int Err = 0;
+
+   TimerScope FuncTimer("Decomp:readCellLevels");
+
+   if (!IO::existsVar(MeshFileID, "maxLevelCell"))
+      return 1;
+
+   I4 NumTasks    = InEnv->getNumTasks();
+   I4 MyTask      = InEnv->getMyTask();
+   I4 NCellsChunk = (NCellsGlobal - 1) / NumTasks + 1;
+   I4 CellStart   = std::min(MyTask * NCellsChunk, NCellsGlobal);
+   I4 NCellsLocal =
+       std::min(CellStart + NCellsChunk, NCellsGlobal) - CellStart;
+
+   std::vector<I4> Dims{NCellsGlobal};
+   std::vector<I4> Offset(NCellsChunk, -1);
+   for (int Cell = 0; Cell < NCellsLocal; ++Cell)
+      Offset[Cell] = CellStart + Cell;
+
+   I4 LevelsDecomp;
+   Err = IO::createDecomp(LevelsDecomp, IO::IOTypeI4, 1, Dims, NCellsChunk,
+                          Offset, IO::RearrBox, MeshSysID);
+   if (Err != 0) {
+      LOG_ERROR("Decomp: error creating maxLevelCell IO decomposition");
+      return Err;
+   }
+
+   LevelsInit.resize(NCellsChunk);
+   int LevelsID;
+   Err = IO::readArray(LevelsInit.data(), NCellsChunk, "maxLevelCell",
+                       MeshFileID, LevelsDecomp, LevelsID);
+   if (Err != 0)
+      LOG_ERROR("Decomp: error reading maxLevelCell");
+
+   IO::destroyDecomp(LevelsDecomp);
 
-   return LocIndx;
+   return Err;
 
-} // end function srchVector (std::vector)
+} // end function readCellLevels
 
 //------------------------------------------------------------------------------
-// A search routine for vectors in which the vector is a YAKL array rather
-// than a std::vector. It searches for a value and returns the first index of
-// that // entry. If not found, the size is returned (corresponding to the
-// last index + 1)
+// Local routine that computes the METIS vertex and edge weights for the
+// locally-held cells in the initial linear distribution. Each cell is
+// weighted by its number of active levels. For LevelsMemory a second
+// constraint with unit weight balances the cell count (and memory). Each
+// edge of the adjacency graph is weighted by the levels shared by the two
+// cells, which is the volume exchanged in a halo update across that edge.
+// Edge weights are in the order of the pruned adjacency graph.
+
+int computePartWeights(
+    PartWeight Weight,                      // [in] partition weighting
+    const std::vector<I4> &CellsOnCellInit, // [in] cell nbrs in linear dstrb
+    const std::vector<I4> &LevelsInit,      // [in] levels in linear dstrb
+    I4 NCellsLocal,                         // [in] num local cells
+    I4 NCellsGlobal,                        // [in] total number of cells
+    I4 MaxEdges,                            // [in] max edges on a cell
+    I4 NCellsChunk,                         // [in] cells per task in dstrb
+    MPI_Comm Comm,                          // [in] communicator to use
+    idx_t &NConstraints,                    // [out] num balance constraints
+    std::vector<idx_t> &VrtxWgt,            // [out] weights of local cells
+    std::vector<idx_t> &EdgeWgt             // [out] weights of local edges
+) {
+
+   int Err = 0;
+
+   NConstraints = (Weight == PartWeightLevelsMemory) ? 2 : 1;
+
+   VrtxWgt.resize(NCellsLocal * NConstraints);
+   for (int Cell = 0; Cell < NCellsLocal; ++Cell) {
+      VrtxWgt[Cell * NConstraints] = std::max(LevelsInit[Cell], 1);
+      if (NConstraints > 1)
+         VrtxWgt[Cell * NConstraints + 1] = 1;
+   }
+
+   // Retrieve the levels for every neighbor, which may be held by
+   // another task in the linear distribution
+   std::vector<I4> NbrIDs;
+   NbrIDs.reserve(NCellsLocal * MaxEdges);
+   for (int Cell = 0; Cell < NCellsLocal; ++Cell) {
+      for (int Edge = 0; Edge < MaxEdges; ++Edge) {
+         I4 NbrCell = CellsOnCellInit[Cell * MaxEdges + Edge];
+         if (NbrCell > 0 && NbrCell <= NCellsGlobal)
+            NbrIDs.push_back(NbrCell);
+      }
+   }
+
+   std::vector<I4> NbrLevels;
+   Err = fetchLinearRows(NbrIDs, LevelsInit, 1, NCellsChunk, NbrLevels, Comm);
+   if (Err != 0) {
+      LOG_ERROR("Decomp: Error retrieving neighbor levels");
+      return Err;
+   }
+
+   EdgeWgt.resize(NbrIDs.size());
+   I4 Add = 0;
+   for (int Cell = 0; Cell < NCellsLocal; ++Cell) {
+      for (int Edge = 0; Edge < MaxEdges; ++Edge) {
+         I4 NbrCell = CellsOnCellInit[Cell * MaxEdges + Edge];
+         if (NbrCell > 0 && NbrCell <= NCellsGlobal) {
+            EdgeWgt[Add] =
+                std::max(std::min(LevelsInit[Cell], NbrLevels[Add]), 1);
+            ++Add;
+         }
+      }
+   }
 
-I4 srchVector(ArrayHost1DI4 InVector, // vector to search
-              I4 Value                // value to search for
+   return Err;
+
+} // end function computePartWeights
+
+//------------------------------------------------------------------------------
+// Local routine that partitions the global adjacency graph in two levels to
+// match the node layout of the machine environment. The graph is first
+// partitioned across nodes with target partition weights proportional to the
+// number of tasks on each node. The subgraph of each node is then extracted
+// and partitioned among the tasks on that node, which are assigned in task
+// order. Since most cut edges then lie between tasks on the same node, most
+// halo traffic stays within a node. Every task performs the same serial
+// partitions so no communication is needed. On exit, CellTask holds the task
+// assigned to each cell.
+
+int partGraphByNode(
+    const MachEnv *InEnv,           // [in] machine env with node layout
+    idx_t NCells,                   // [in] number of cells (vertices)
+    idx_t NConstraints,             // [in] number of balance constraints
+    std::vector<idx_t> &AdjAdd,     // [in] start of each cell in Adjacency
+    std::vector<idx_t> &Adjacency,  // [in] neighbors of each cell
+    idx_t *VrtxWgtPtr,              // [in] vertex weights or nullptr
+    idx_t *EdgeWgtPtr,              // [in] edge weights or nullptr
+    std::vector<idx_t> &CellTask    // [out] task assigned to each cell
 ) {
 
-   // extract the vector length
-   I4 VecSize  = InVector.totElems();
-   I4 LocIndex = VecSize; // set default to size (return value if not found)
+   int MetisErr = METIS_OK;
+
+   I4 NumTasks = InEnv->getNumTasks();
+   I4 NumNodes = InEnv->getNumNodes();
+
+   // List the tasks on each node in task order
+   std::vector<std::vector<I4>> NodeTasks(NumNodes);
+   for (int Task = 0; Task < NumTasks; ++Task)
+      NodeTasks[InEnv->getTaskNode(Task)].push_back(Task);
+
+   // Partition the cells across nodes, weighting each node by its tasks
+   std::vector<idx_t> CellNode(NCells, 0);
+   idx_t Edgecut = 0;
+   if (NumNodes > 1) {
+      idx_t NParts = NumNodes;
+      std::vector<real_t> TpWgts(NParts * NConstraints);
+      for (int Node = 0; Node < NumNodes; ++Node) {
+         for (int Con = 0; Con < NConstraints; ++Con)
+            TpWgts[Node * NConstraints + Con] =
+                static_cast<real_t>(NodeTasks[Node].size()) / NumTasks;
+      }
+      MetisErr = METIS_PartGraphKway(
+          &NCells, &NConstraints, AdjAdd.data(), Adjacency.data(), VrtxWgtPtr,
+          nullptr, EdgeWgtPtr, &NParts, TpWgts.data(), nullptr, nullptr,
+          &Edgecut, CellNode.data());
+      if (MetisErr != METIS_OK)
+         return MetisErr;
+   }
+
+   // Partition the subgraph of each node among the tasks on that node.
+   // SubIndex maps each cell to its address in the subgraph of its node.
+   std::vector<idx_t> SubIndex(NCells, -1);
+   for (int Node = 0; Node < NumNodes; ++Node) {
 
-   // Loop over elements, searching for Value
-   for (int n = 0; n < VecSize; ++n) {
-      if (InVector(n) == Value) { // found value
-         LocIndex = n;
-         break;
+      std::vector<idx_t> SubCells;
+      for (int Cell = 0; Cell < NCells; ++Cell) {
+         if (CellNode[Cell] == Node) {
+            SubIndex[Cell] = SubCells.size();
+            SubCells.push_back(Cell);
+         }
+      }
+      idx_t NSub   = SubCells.size();
+      idx_t NParts = NodeTasks[Node].size();
+      std::vector<idx_t> SubPart(NSub + 1, 0);
+
+      if (NParts > 1 && NSub > 0) {
+         // Extract the edges and weights between cells on this node
+         std::vector<idx_t> SubAdjAdd(NSub + 1, 0);
+         std::vector<idx_t> SubAdj;
+         std::vector<idx_t> SubVrtxWgt;
+         std::vector<idx_t> SubEdgeWgt;
+         for (int Sub = 0; Sub < NSub; ++Sub) {
+            idx_t Cell     = SubCells[Sub];
+            SubAdjAdd[Sub] = SubAdj.size();
+            for (idx_t Add = AdjAdd[Cell]; Add < AdjAdd[Cell + 1]; ++Add) {
+               idx_t NbrCell = Adjacency[Add];
+               if (CellNode[NbrCell] != Node)
+                  continue;
+               SubAdj.push_back(SubIndex[NbrCell]);
+               if (EdgeWgtPtr != nullptr)
+                  SubEdgeWgt.push_back(EdgeWgtPtr[Add]);
+            }
+            if (VrtxWgtPtr != nullptr) {
+               for (int Con = 0; Con < NConstraints; ++Con)
+                  SubVrtxWgt.push_back(VrtxWgtPtr[Cell * NConstraints + Con]);
+            }
+         }
+         SubAdjAdd[NSub] = SubAdj.size();
+         SubAdj.push_back(0); // guarantees a valid pointer for empty graphs
+         SubEdgeWgt.push_back(0);
+
+         MetisErr = METIS_PartGraphKway(
+             &NSub, &NConstraints, SubAdjAdd.data(), SubAdj.data(),
+             VrtxWgtPtr ? SubVrtxWgt.data() : nullptr, nullptr,
+             EdgeWgtPtr ? SubEdgeWgt.data() : nullptr, &NParts, nullptr,
+             nullptr, nullptr, &Edgecut, SubPart.data());
+         if (MetisErr != METIS_OK)
+            return MetisErr;
       }
+
+      for (int Sub = 0; Sub < NSub; ++Sub)
+         CellTask[SubCells[Sub]] = NodeTasks[Node][SubPart[Sub]];
    }
 
-   return LocIndex;
+   return MetisErr;
+
+} // end function partGraphByNode
+
+//------------------------------------------------------------------------------
+// Local constants and routines for the decomposition cache. The cache is a
+// single binary file written with MPI-IO. It begins with a header of 8-byte
+// integers: CacheHeaderBase entries (a magic number, version and the length
+// of the cache key) followed by the key itself. The header is followed by an
+// (offset, length) pair for each task and then the packed decomposition data
+// for each task.
+
+constexpr I8 CacheMagic      = 0x4F6D656761446563; // "OmegaDec"
+constexpr I8 CacheVersion    = 5;
+constexpr I4 CacheHeaderBase = 3;
+
+//------------------------------------------------------------------------------
+// Computes the part of the cache key that identifies the mesh file. Hashing
+// the full file would read every byte of a mesh that may be many GB, so the
+// key is built from inexpensive metadata instead: the size and modification
+// time of the file and the mesh dimensions in its header. The file status
+// is only queried on the first task and broadcast so that all tasks use the
+// same key.
+
+int meshFileKey(const std::string &MeshFileName, // [in] mesh file
+                MPI_Comm Comm,                   // [in] communicator to use
+                std::vector<I8> &MeshKey         // [out] key for mesh file
+) {
 
-} // end function srchVector (YAKL)
+   int Err = 0;
+
+   I4 MyTask;
+   MPI_Comm_rank(Comm, &MyTask);
+
+   // File status flag, size in bytes and modification time in seconds
+   I8 FileInfo[3] = {0, 0, 0};
+   if (MyTask == 0) {
+      struct stat FileStat;
+      if (stat(MeshFileName.c_str(), &FileStat) == 0) {
+         FileInfo[1] = static_cast<I8>(FileStat.st_size);
+         FileInfo[2] = static_cast<I8>(FileStat.st_mtime);
+      } else {
+         FileInfo[0] = 1;
+      }
+   }
+   MPI_Bcast(FileInfo, 3, MPI_INT64_T, 0, Comm);
+   if (FileInfo[0] != 0) {
+      LOG_ERROR("Decomp: Error querying status of mesh file {}",
+                MeshFileName);
+      return -1;
+   }
+
+   // Read the mesh dimensions from the file header
+   int FileID;
+   Err = IO::openFile(FileID, MeshFileName, IO::ModeRead);
+   if (Err != 0) {
+      LOG_ERROR("Decomp: Error opening mesh file {} for cache key",
+                MeshFileName);
+      return Err;
+   }
+   MeshKey = {FileInfo[1],
+              FileInfo[2],
+              IO::getDimLength(FileID, "nCells"),
+              IO::getDimLength(FileID, "nEdges"),
+              IO::getDimLength(FileID, "nVertices"),
+              IO::getDimLength(FileID, "maxEdges")};
+   Err = IO::closeFile(FileID);
+
+   return Err;
+
+} // end function meshFileKey
+
+//------------------------------------------------------------------------------
+// Appends the contents of a host index array to a cache buffer
+
+template <class ArrayType>
+void packCacheArray(std::vector<I4> &Buf,  // [inout] buffer to append to
+                    const ArrayType &Array // [in] host array to pack
+) {
+   Buf.insert(Buf.end(), Array.data(), Array.data() + Array.totElems());
+} // end function packCacheArray
+
+//------------------------------------------------------------------------------
+// Extracts the contents of a host index array from a cache buffer starting
+// at BufAdd. The array must already be allocated with the correct size.
+
+template <class ArrayType>
+void unpackCacheArray(const std::vector<I4> &Buf, // [in] buffer to read
+                      I8 &BufAdd,       // [inout] current buffer address
+                      ArrayType &Array  // [out] host array to fill
+) {
+   std::copy(Buf.begin() + BufAdd, Buf.begin() + BufAdd + Array.totElems(),
+             Array.data());
+   BufAdd += Array.totElems();
+} // end function unpackCacheArray
 
 // Routines needed for creating the decomposition
 //------------------------------------------------------------------------------
@@ -101,6 +573,7 @@ I4 srchVector(ArrayHost1DI4 InVector, // vector to search
 // and redistributed later after the decomposition is complete.
 
 int readMesh(const int MeshFileID, // file ID for open mesh file
+             const int MeshSysID,  // IO system for mesh file
              const MachEnv *InEnv, // input machine environment for MPI layout
              I4 &NCellsGlobal,     // total number of cells
              I4 &NEdgesGlobal,     // total number of edges
@@ -120,12 +593,11 @@ int readMesh(const int MeshFileID, // file ID for open mesh file
 
    int Err = 0;
 
+   TimerScope FuncTimer("Decomp:readMesh");
+
    // Retrieve some info on the MPI layout
-   MPI_Comm Comm = InEnv->getComm();
-   I4 NumTasks   = InEnv->getNumTasks();
-   I4 MyTask     = InEnv->getMyTask();
-   I4 MasterTask = InEnv->getMasterTask();
-   bool IsMaster = InEnv->isMasterTask();
+   I4 NumTasks = InEnv->getNumTasks();
+   I4 MyTask   = InEnv->getMyTask();
 
    // Read in mesh size information - these are dimension lengths in
    // the input mesh file
@@ -223,19 +695,19 @@ int readMesh(const int MeshFileID, // file ID for open mesh file
    I4 OnEdgeDecomp2;
    I4 OnVertexDecomp;
    Err = IO::createDecomp(OnCellDecomp, IO::IOTypeI4, NDims, OnCellDims,
-                          OnCellSize, OnCellOffset, Rearr);
+                          OnCellSize, OnCellOffset, Rearr, MeshSysID);
    if (Err != 0)
       LOG_CRITICAL("Decomp: error creating OnCell IO decomposition");
    Err = IO::createDecomp(OnEdgeDecomp, IO::IOTypeI4, NDims, OnEdgeDims,
-                          OnEdgeSize, OnEdgeOffset, Rearr);
+                          OnEdgeSize, OnEdgeOffset, Rearr, MeshSysID);
    if (Err != 0)
       LOG_CRITICAL("Decomp: error creating OnEdge IO decomposition");
    Err = IO::createDecomp(OnEdgeDecomp2, IO::IOTypeI4, NDims, OnEdgeDims2,
-                          OnEdgeSize2, OnEdgeOffset2, Rearr);
+                          OnEdgeSize2, OnEdgeOffset2, Rearr, MeshSysID);
    if (Err != 0)
       LOG_CRITICAL("Decomp: error creating OnEdg2 IO decomposition");
    Err = IO::createDecomp(OnVertexDecomp, IO::IOTypeI4, NDims, OnVertexDims,
-                          OnVertexSize, OnVertexOffset, Rearr);
+                          OnVertexSize, OnVertexOffset, Rearr, MeshSysID);
    if (Err != 0)
       LOG_CRITICAL("Decomp: error creating Vertex IO decomposition");
 
@@ -329,6 +801,13 @@ int Decomp::init() {
    std::string MeshFileName = "OmegaMesh.nc";
    std::string DecompMethod = "MetisKWay";
    PartMethod Method        = getPartMethodFromStr(DecompMethod);
+   std::string CellOrdering = "None";
+   std::string Weighting    = "None";
+   DecompOptions Options;
+   Options.CacheFileName = ""; // empty string disables the decomp cache
+   Options.Order         = getCellOrderFromStr(CellOrdering);
+   Options.MeshIOTasks   = 0; // zero uses the default IO layout
+   Options.Weight        = getPartWeightFromStr(Weighting);
 
    // Retrieve the default machine environment
    MachEnv *DefEnv = MachEnv::getDefaultEnv();
@@ -338,7 +817,7 @@ int Decomp::init() {
 
    // Create the default decomposition
    Decomp DefDecomp("Default", DefEnv, NParts, Method, InHaloWidth,
-                    MeshFileName);
+                    MeshFileName, Options);
 
    // Retrieve this environment and set pointer to DefaultDecomp
    Decomp::DefaultDecomp = Decomp::get("Default");
@@ -352,26 +831,140 @@ int Decomp::init() {
 // NPart partitions of the mesh.
 
 Decomp::Decomp(
-    const std::string &Name,        //< [in] Name for new decomposition
-    const MachEnv *InEnv,           //< [in] MachEnv for the new partition
-    I4 NParts,                      //< [in] num of partitions for new decomp
-    PartMethod Method,              //< [in] method for partitioning
-    I4 InHaloWidth,                 //< [in] width of halo in new decomp
-    const std::string &MeshFileName //< [in] name of file with mesh info
+    const std::string &Name,         //< [in] Name for new decomposition
+    const MachEnv *InEnv,            //< [in] MachEnv for the new partition
+    I4 NParts,                       //< [in] num of partitions for new decomp
+    PartMethod Method,               //< [in] method for partitioning
+    I4 InHaloWidth,                  //< [in] width of halo in new decomp
+    const std::string &MeshFileName, //< [in] name of file with mesh info
+    const DecompOptions &Options     //< [in] optional decomp settings
 ) {
 
    int Err = 0; // internal error code
 
+   TimerScope FuncTimer("Decomp:create");
+
+   HaloWidth = InHaloWidth;
+
+   const std::string &CacheFileName = Options.CacheFileName;
+
+   // If a cache file has been requested, compute the key that identifies
+   // this decomposition and attempt to read the decomposition from the cache
+   bool UseCache   = !CacheFileName.empty();
+   bool CacheFound = false;
+   std::vector<I8> CacheKey;
+   if (UseCache) {
+      Err = meshFileKey(MeshFileName, InEnv->getComm(), CacheKey);
+      if (Err == 0) {
+         // The node layout is part of the key since it determines the
+         // partition with PartMethodMetisKWayNode. The node size is the
+         // largest number of tasks on a node, as limited by setNodeSize.
+         I4 NumTasks = InEnv->getNumTasks();
+         I4 NumNodes = InEnv->getNumNodes();
+         std::vector<I8> NodeTasks(NumNodes, 0);
+         for (int Task = 0; Task < NumTasks; ++Task)
+            ++NodeTasks[InEnv->getTaskNode(Task)];
+         I8 NodeSize = *std::max_element(NodeTasks.begin(), NodeTasks.end());
+         CacheKey.insert(CacheKey.end(),
+                         {NParts, NumTasks, HaloWidth, static_cast<I8>(Method),
+                          static_cast<I8>(Options.Order),
+                          static_cast<I8>(Options.Weight),
+                          NumNodes, NodeSize});
+         CacheFound = (readCache(InEnv, CacheFileName, CacheKey) == 0);
+      } else {
+         LOG_ERROR("Decomp: Error computing mesh key, cache not used");
+         UseCache = false;
+      }
+   }
+
+   // Otherwise read the mesh and partition it, saving the result in the
+   // cache if requested
+   if (!CacheFound) {
+      Err = partitionMesh(InEnv, Method, MeshFileName, Options.Order,
+                          Options.MeshIOTasks, Options.Weight);
+      if (Err != 0) {
+         LOG_CRITICAL("Decomp: Error creating decomposition from mesh");
+         return;
+      }
+      if (UseCache) {
+         Err = writeCache(InEnv, CacheFileName, CacheKey);
+         if (Err != 0)
+            LOG_ERROR("Decomp: Error writing decomposition cache {}",
+                      CacheFileName);
+      }
+   }
+
+   // Create device copies of all arrays
+
+   NCellsHalo = NCellsHaloH.createDeviceCopy();
+   CellID     = CellIDH.createDeviceCopy();
+   CellLoc    = CellLocH.createDeviceCopy();
+
+   NEdgesHalo = NEdgesHaloH.createDeviceCopy();
+   EdgeID     = EdgeIDH.createDeviceCopy();
+   EdgeLoc    = EdgeLocH.createDeviceCopy();
+
+   NVerticesHalo = NVerticesHaloH.createDeviceCopy();
+   VertexID      = VertexIDH.createDeviceCopy();
+   VertexLoc     = VertexLocH.createDeviceCopy();
+
+   CellsOnCell    = CellsOnCellH.createDeviceCopy();
+   EdgesOnCell    = EdgesOnCellH.createDeviceCopy();
+   VerticesOnCell = VerticesOnCellH.createDeviceCopy();
+   NEdgesOnCell   = NEdgesOnCellH.createDeviceCopy();
+
+   CellsOnEdge    = CellsOnEdgeH.createDeviceCopy();
+   EdgesOnEdge    = EdgesOnEdgeH.createDeviceCopy();
+   VerticesOnEdge = VerticesOnEdgeH.createDeviceCopy();
+   NEdgesOnEdge   = NEdgesOnEdgeH.createDeviceCopy();
+
+   CellsOnVertex = CellsOnVertexH.createDeviceCopy();
+   EdgesOnVertex = EdgesOnVertexH.createDeviceCopy();
+
+   // Assign this as the default decomposition
+   AllDecomps.emplace(Name, *this);
+
+} // end decomposition constructor
+
+//------------------------------------------------------------------------------
+// Reads the mesh connectivity from a mesh file, partitions the cells with the
+// requested method and distributes all cell, edge and vertex index arrays
+// to the new decomposition. On exit, all host index arrays contain local
+// addresses. Device copies are created by the constructor.
+
+int Decomp::partitionMesh(
+    const MachEnv *InEnv,            //< [in] MachEnv for the new partition
+    PartMethod Method,               //< [in] method for partitioning
+    const std::string &MeshFileName, //< [in] name of file with mesh info
+    CellOrder Order,                 //< [in] method for ordering owned cells
+    I4 MeshIOTasks,                  //< [in] IO tasks for mesh read (0=default)
+    PartWeight Weight                //< [in] weighting of partition
+) {
+
+   int Err = 0; // internal error code
+
+   TimerScope FuncTimer("Decomp:partitionMesh");
+
    // Retrieve some info on the MPI layout
    MPI_Comm Comm = InEnv->getComm();
-   I4 NumTasks   = InEnv->getNumTasks();
-   I4 MyTask     = InEnv->getMyTask();
-   I4 MasterTask = InEnv->getMasterTask();
-   bool IsMaster = InEnv->isMasterTask();
+
+   // If requested, read the mesh with a separate IO system that spreads
+   // the reads over more IO tasks than the default output layout. The
+   // mesh IO system is passed explicitly to the IO routines and the
+   // default IO system is not changed.
+   int MeshSysID = IO::SysID;
+   if (MeshIOTasks > 0) {
+      Err = IO::createSystem(Comm, MeshIOTasks, 0, 0, IO::RearrBox, MeshSysID);
+      if (Err != 0) {
+         LOG_ERROR("Decomp: error creating mesh IO system, using default");
+         MeshSysID = IO::SysID;
+      }
+   }
 
    // Open the mesh file for reading (assume IO has already been initialized)
    int FileID;
-   Err = IO::openFile(FileID, MeshFileName, IO::ModeRead);
+   Err = IO::openFile(FileID, MeshFileName, IO::ModeRead, IO::DefaultFileFmt,
+                      IO::IfExists::Fail, IO::Precision::Double, MeshSysID);
    if (Err != 0)
       LOG_CRITICAL("Decomp: error opening mesh file");
 
@@ -384,40 +977,81 @@ Decomp::Decomp(
    std::vector<I4> VerticesOnEdgeInit;
    std::vector<I4> CellsOnVertexInit;
    std::vector<I4> EdgesOnVertexInit;
-   HaloWidth = InHaloWidth;
 
-   Err = readMesh(FileID, InEnv, NCellsGlobal, NEdgesGlobal, NVerticesGlobal,
-                  MaxEdges, MaxCellsOnEdge, VertexDegree, CellsOnCellInit,
-                  EdgesOnCellInit, VerticesOnCellInit, CellsOnEdgeInit,
-                  EdgesOnEdgeInit, VerticesOnEdgeInit, CellsOnVertexInit,
-                  EdgesOnVertexInit);
+   Err = readMesh(FileID, MeshSysID, InEnv, NCellsGlobal, NEdgesGlobal,
+                  NVerticesGlobal, MaxEdges, MaxCellsOnEdge, VertexDegree,
+                  CellsOnCellInit, EdgesOnCellInit, VerticesOnCellInit,
+                  CellsOnEdgeInit, EdgesOnEdgeInit, VerticesOnEdgeInit,
+                  CellsOnVertexInit, EdgesOnVertexInit);
    if (Err != 0)
       LOG_CRITICAL("Decomp: Error reading mesh connectivity");
 
-   // Close file
+   // Read the active levels in each cell if needed for weighting. If they
+   // are not available, the partition is not weighted.
+   std::vector<I4> LevelsInit;
+   if (Weight != PartWeightNone) {
+      Err =
+          readCellLevels(FileID, MeshSysID, InEnv, NCellsGlobal, LevelsInit);
+      if (Err != 0) {
+         LOG_WARN("Decomp: maxLevelCell not available, partition will not "
+                  "be weighted");
+         Weight = PartWeightNone;
+      }
+   }
+
+   // Close file and free the mesh IO system if one was created
    Err = IO::closeFile(FileID);
+   if (MeshSysID != IO::SysID) {
+      Err = IO::destroySystem(MeshSysID);
+      if (Err != 0)
+         LOG_ERROR("Decomp: error freeing mesh IO system");
+   }
 
    // Use the mesh adjacency information to create a partition of cells
    switch (Method) { // branch depending on method chosen
 
    //---------------------------------------------------------------------------
-   // ParMetis KWay method
+   // Metis KWay method
    case PartMethodMetisKWay: {
 
-      Err = partCellsKWay(InEnv, CellsOnCellInit);
+      Err = partCellsKWay(InEnv, CellsOnCellInit, Weight, LevelsInit, false);
       if (Err != 0) {
          LOG_CRITICAL("Decomp: Error partitioning cells KWay");
-         return;
+         return Err;
       }
       break;
    } // end case MethodKWay
 
+   //---------------------------------------------------------------------------
+   // Metis KWay method partitioned across nodes and then within each node
+   case PartMethodMetisKWayNode: {
+
+      Err = partCellsKWay(InEnv, CellsOnCellInit, Weight, LevelsInit, true);
+      if (Err != 0) {
+         LOG_CRITICAL("Decomp: Error partitioning cells KWay by node");
+         return Err;
+      }
+      break;
+   } // end case MethodKWayNode
+
+   //---------------------------------------------------------------------------
+   // ParMetis KWay method on the distributed adjacency graph
+   case PartMethodParMetisKWay: {
+
+      Err = partCellsParKWay(InEnv, CellsOnCellInit, Weight, LevelsInit);
+      if (Err != 0) {
+         LOG_CRITICAL("Decomp: Error partitioning cells ParKWay");
+         return Err;
+      }
+      break;
+   } // end case MethodParKWay
+
       //---------------------------------------------------------------------------
       // Unknown partitioning method
 
    default:
       LOG_CRITICAL("Decomp: Unknown or unsupported decomposition method");
-      return;
+      return -1;
 
    } // End switch on Method
 
@@ -429,14 +1063,21 @@ Decomp::Decomp(
                              VerticesOnCellInit);
    if (Err != 0) {
       LOG_CRITICAL("Decomp: Error rearranging XxOnCell arrays");
-      return;
+      return Err;
+   }
+
+   // Optionally renumber the owned cells for better memory locality
+   Err = reorderCells(InEnv, Order);
+   if (Err != 0) {
+      LOG_CRITICAL("Decomp: Error reordering cells");
+      return Err;
    }
 
    // Partition the edges
    Err = partEdges(InEnv, CellsOnEdgeInit);
    if (Err != 0) {
       LOG_CRITICAL("Decomp: Error partitioning edges");
-      return;
+      return Err;
    }
 
    // Edge partitioning complete. Redistribute the initial XXOnEdge arrays
@@ -445,14 +1086,14 @@ Decomp::Decomp(
                              VerticesOnEdgeInit);
    if (Err != 0) {
       LOG_CRITICAL("Decomp: Error rearranging XxOnEdge arrays");
-      return;
+      return Err;
    }
 
    // Partition the vertices
    Err = partVertices(InEnv, CellsOnVertexInit);
    if (Err != 0) {
       LOG_CRITICAL("Decomp: Error partitioning vertices");
-      return;
+      return Err;
    }
 
    // Vertex partitioning complete. Redistribute the initial XXOnVertex arrays
@@ -460,7 +1101,7 @@ Decomp::Decomp(
    Err = rearrangeVertexArrays(InEnv, CellsOnVertexInit, EdgesOnVertexInit);
    if (Err != 0) {
       LOG_CRITICAL("Decomp: Error rearranging XxOnVertex arrays");
-      return;
+      return Err;
    }
 
    // Convert global addresses to local addresses. Create the global to
@@ -624,37 +1265,382 @@ Decomp::Decomp(
       }
    }
 
-   // Create device copies of all arrays
+   return Err;
 
-   NCellsHalo = NCellsHaloH.createDeviceCopy();
-   CellID     = CellIDH.createDeviceCopy();
-   CellLoc    = CellLocH.createDeviceCopy();
+} // end function partitionMesh
 
-   NEdgesHalo = NEdgesHaloH.createDeviceCopy();
-   EdgeID     = EdgeIDH.createDeviceCopy();
-   EdgeLoc    = EdgeLocH.createDeviceCopy();
+//------------------------------------------------------------------------------
+// Renumbers the owned cells on each task to improve memory locality using
+// the reverse Cuthill-McKee (RCM) ordering of the local owned-cell graph.
+// Halo cells keep their layer-by-layer ordering by global ID. This must be
+// called after rearrangeCellArrays (while the XxOnCell arrays still hold
+// global IDs) and before the edges and vertices are partitioned so that
+// the edge and vertex orderings, which follow the cell ordering, inherit
+// the improved locality. The new local addresses of owned cells are then
+// communicated so that the CellLoc of halo cells on other tasks is updated.
+
+int Decomp::reorderCells(
+    const MachEnv *InEnv, // [in] input machine environment with MPI info
+    CellOrder Order       // [in] method for reordering owned cells
+) {
 
-   NVerticesHalo = NVerticesHaloH.createDeviceCopy();
-   VertexID      = VertexIDH.createDeviceCopy();
-   VertexLoc     = VertexLocH.createDeviceCopy();
+   int Err = 0;
 
-   CellsOnCell    = CellsOnCellH.createDeviceCopy();
-   EdgesOnCell    = EdgesOnCellH.createDeviceCopy();
-   VerticesOnCell = VerticesOnCellH.createDeviceCopy();
-   NEdgesOnCell   = NEdgesOnCellH.createDeviceCopy();
+   TimerScope FuncTimer("Decomp:reorderCells");
 
-   CellsOnEdge    = CellsOnEdgeH.createDeviceCopy();
-   EdgesOnEdge    = EdgesOnEdgeH.createDeviceCopy();
-   VerticesOnEdge = VerticesOnEdgeH.createDeviceCopy();
-   NEdgesOnEdge   = NEdgesOnEdgeH.createDeviceCopy();
+   if (Order == CellOrderNone)
+      return Err;
+   if (Order != CellOrderRCM) {
+      LOG_ERROR("Decomp: Unknown or unsupported cell ordering");
+      return -1;
+   }
 
-   CellsOnVertex = CellsOnVertexH.createDeviceCopy();
-   EdgesOnVertex = EdgesOnVertexH.createDeviceCopy();
+   MPI_Comm Comm  = InEnv->getComm();
+   I4 NumTasks    = InEnv->getNumTasks();
+   I4 MyTask      = InEnv->getMyTask();
+   I4 NCellsChunk = (NCellsGlobal - 1) / NumTasks + 1;
 
-   // Assign this as the default decomposition
-   AllDecomps.emplace(Name, *this);
+   // Owned cells are sorted by global ID on entry, so a binary search
+   // locates the local address of each owned neighbor
+   std::vector<I4> OwnedIDs(CellIDH.data(), CellIDH.data() + NCellsOwned);
+   std::vector<std::vector<I4>> OwnedNbrs(NCellsOwned);
+   for (int Cell = 0; Cell < NCellsOwned; ++Cell) {
+      for (int Edge = 0; Edge < NEdgesOnCellH(Cell); ++Edge) {
+         I4 NbrID = CellsOnCellH(Cell, Edge);
+         auto It  = std::lower_bound(OwnedIDs.begin(), OwnedIDs.end(), NbrID);
+         if (It != OwnedIDs.end() && *It == NbrID)
+            OwnedNbrs[Cell].push_back(std::distance(OwnedIDs.begin(), It));
+      }
+   }
 
-} // end decomposition constructor
+   // Cuthill-McKee ordering: a breadth-first traversal of each connected
+   // component starting from a cell of minimum degree, visiting neighbors
+   // in order of increasing degree. The order is reversed at the end.
+   auto ByDegree = [&OwnedNbrs](I4 Cell1, I4 Cell2) {
+      return OwnedNbrs[Cell1].size() < OwnedNbrs[Cell2].size();
+   };
+   std::vector<I4> ByMinDegree(NCellsOwned);
+   for (int Cell = 0; Cell < NCellsOwned; ++Cell)
+      ByMinDegree[Cell] = Cell;
+   std::stable_sort(ByMinDegree.begin(), ByMinDegree.end(), ByDegree);
+
+   std::vector<I4> NewOrder; // old local address for each new address
+   NewOrder.reserve(NCellsOwned);
+   std::vector<bool> Visited(NCellsOwned, false);
+   for (I4 Start : ByMinDegree) {
+      if (Visited[Start])
+         continue;
+      Visited[Start] = true;
+      I4 QueueHead   = NewOrder.size();
+      NewOrder.push_back(Start);
+      while (QueueHead < static_cast<I4>(NewOrder.size())) {
+         I4 Cell = NewOrder[QueueHead];
+         ++QueueHead;
+         std::vector<I4> NewNbrs;
+         for (I4 Nbr : OwnedNbrs[Cell]) {
+            if (!Visited[Nbr]) {
+               Visited[Nbr] = true;
+               NewNbrs.push_back(Nbr);
+            }
+         }
+         std::stable_sort(NewNbrs.begin(), NewNbrs.end(), ByDegree);
+         NewOrder.insert(NewOrder.end(), NewNbrs.begin(), NewNbrs.end());
+      }
+   }
+   std::reverse(NewOrder.begin(), NewOrder.end());
+
+   // Permute the owned entries of the cell arrays
+   ArrayHost1DI4 OldCellID       = CellIDH.createHostCopy();
+   ArrayHost2DI4 OldCellsOnCell  = CellsOnCellH.createHostCopy();
+   ArrayHost2DI4 OldEdgesOnCell  = EdgesOnCellH.createHostCopy();
+   ArrayHost2DI4 OldVrtxOnCell   = VerticesOnCellH.createHostCopy();
+   ArrayHost1DI4 OldNEdgesOnCell = NEdgesOnCellH.createHostCopy();
+   for (int Cell = 0; Cell < NCellsOwned; ++Cell) {
+      I4 OldCell          = NewOrder[Cell];
+      CellIDH(Cell)       = OldCellID(OldCell);
+      NEdgesOnCellH(Cell) = OldNEdgesOnCell(OldCell);
+      CellLocH(Cell, 0)   = MyTask;
+      CellLocH(Cell, 1)   = Cell;
+      for (int Edge = 0; Edge < MaxEdges; ++Edge) {
+         CellsOnCellH(Cell, Edge)    = OldCellsOnCell(OldCell, Edge);
+         EdgesOnCellH(Cell, Edge)    = OldEdgesOnCell(OldCell, Edge);
+         VerticesOnCellH(Cell, Edge) = OldVrtxOnCell(OldCell, Edge);
+      }
+   }
+
+   // The local address of owned cells has changed, so update the location
+   // of all halo cells from the new owned locations on remote tasks
+   std::vector<I4> CellLocInit(2 * NCellsChunk, 0);
+   Err = fillLocDirectory(CellIDH, NCellsOwned, NCellsChunk, CellLocInit,
+                          Comm);
+   if (Err != 0) {
+      LOG_ERROR("Decomp: Error registering reordered cell locations");
+      return Err;
+   }
+
+   std::vector<I4> HaloIDs(CellIDH.data() + NCellsOwned,
+                           CellIDH.data() + NCellsAll);
+   std::vector<I4> HaloLocs;
+   Err = fetchLinearRows(HaloIDs, CellLocInit, 2, NCellsChunk, HaloLocs, Comm);
+   if (Err != 0) {
+      LOG_ERROR("Decomp: Error retrieving reordered cell locations");
+      return Err;
+   }
+   for (int Halo = 0; Halo < NCellsAll - NCellsOwned; ++Halo) {
+      CellLocH(NCellsOwned + Halo, 0) = HaloLocs[2 * Halo];
+      CellLocH(NCellsOwned + Halo, 1) = HaloLocs[2 * Halo + 1];
+   }
+
+   return Err;
+
+} // end function reorderCells
+
+//------------------------------------------------------------------------------
+// Writes the decomposition on this task to a cache file that can be read by
+// later runs using the same mesh, partition and halo width. All tasks write
+// their data to a single file using collective MPI-IO.
+
+int Decomp::writeCache(
+    const MachEnv *InEnv,             //< [in] MachEnv for the partition
+    const std::string &CacheFileName, //< [in] name of cache file
+    const std::vector<I8> &CacheKey   //< [in] key identifying this decomp
+) {
+
+   int Err = 0;
+
+   TimerScope FuncTimer("Decomp:writeCache");
+
+   MPI_Comm Comm = InEnv->getComm();
+   I4 NumTasks   = InEnv->getNumTasks();
+   I4 MyTask     = InEnv->getMyTask();
+
+   // Pack the size variables and all host index arrays into a buffer
+   std::vector<I4> Buf{NCellsGlobal,   NCellsOwned,     NCellsAll,
+                       NCellsSize,     MaxEdges,        NEdgesGlobal,
+                       NEdgesOwned,    NEdgesAll,       NEdgesSize,
+                       MaxCellsOnEdge, NVerticesGlobal, NVerticesOwned,
+                       NVerticesAll,   NVerticesSize,   VertexDegree};
+   packCacheArray(Buf, NCellsHaloH);
+   packCacheArray(Buf, CellIDH);
+   packCacheArray(Buf, CellLocH);
+   packCacheArray(Buf, NEdgesHaloH);
+   packCacheArray(Buf, EdgeIDH);
+   packCacheArray(Buf, EdgeLocH);
+   packCacheArray(Buf, NVerticesHaloH);
+   packCacheArray(Buf, VertexIDH);
+   packCacheArray(Buf, VertexLocH);
+   packCacheArray(Buf, CellsOnCellH);
+   packCacheArray(Buf, EdgesOnCellH);
+   packCacheArray(Buf, NEdgesOnCellH);
+   packCacheArray(Buf, VerticesOnCellH);
+   packCacheArray(Buf, CellsOnEdgeH);
+   packCacheArray(Buf, EdgesOnEdgeH);
+   packCacheArray(Buf, NEdgesOnEdgeH);
+   packCacheArray(Buf, VerticesOnEdgeH);
+   packCacheArray(Buf, CellsOnVertexH);
+   packCacheArray(Buf, EdgesOnVertexH);
+
+   // Determine the byte offset of this task's data in the file. The data
+   // for all tasks follows the header and the table of (offset, length).
+   I8 HeaderSize = CacheHeaderBase + CacheKey.size();
+   I8 DataStart  = (HeaderSize + 2 * NumTasks) * sizeof(I8);
+   I8 MyBytes   = Buf.size() * sizeof(I4);
+   I8 MyOffset  = 0;
+   MPI_Exscan(&MyBytes, &MyOffset, 1, MPI_INT64_T, MPI_SUM, Comm);
+   if (MyTask == 0) // Exscan result is undefined on the first task
+      MyOffset = 0;
+   I8 MyEntry[2] = {DataStart + MyOffset, static_cast<I8>(Buf.size())};
+
+   // Create the file, removing any previous contents
+   MPI_File FileHandle;
+   Err = MPI_File_open(Comm, CacheFileName.c_str(),
+                       MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL,
+                       &FileHandle);
+   if (Err != MPI_SUCCESS) {
+      LOG_ERROR("Decomp: Error creating cache file {}", CacheFileName);
+      return Err;
+   }
+   MPI_File_set_size(FileHandle, 0);
+
+   // The first task writes the header. All tasks write their table entry
+   // and data.
+   std::vector<I8> Header{CacheMagic, CacheVersion,
+                          static_cast<I8>(CacheKey.size())};
+   Header.insert(Header.end(), CacheKey.begin(), CacheKey.end());
+   I4 HeaderCount = (MyTask == 0) ? Header.size() : 0;
+
+   Err = MPI_File_write_at_all(FileHandle, 0, Header.data(), HeaderCount,
+                               MPI_INT64_T, MPI_STATUS_IGNORE);
+   if (Err == MPI_SUCCESS)
+      Err = MPI_File_write_at_all(
+          FileHandle, (HeaderSize + 2 * MyTask) * sizeof(I8), MyEntry, 2,
+          MPI_INT64_T, MPI_STATUS_IGNORE);
+   if (Err == MPI_SUCCESS)
+      Err = MPI_File_write_at_all(FileHandle, MyEntry[0], Buf.data(),
+                                  Buf.size(), MPI_INT32_T, MPI_STATUS_IGNORE);
+   MPI_File_close(&FileHandle);
+
+   if (Err != MPI_SUCCESS) {
+      LOG_ERROR("Decomp: Error writing cache file {}", CacheFileName);
+      return Err;
+   }
+
+   LOG_INFO("Decomp: wrote decomposition cache {}", CacheFileName);
+
+   return Err;
+
+} // end function writeCache
+
+//------------------------------------------------------------------------------
+// Reads a decomposition from a cache file written by writeCache. Returns a
+// non-zero value if the file does not exist or was created with a different
+// key (mesh, partition or halo width), in which case the decomposition must
+// be recomputed. The decision is consistent across all tasks.
+
+int Decomp::readCache(
+    const MachEnv *InEnv,             //< [in] MachEnv for the partition
+    const std::string &CacheFileName, //< [in] name of cache file
+    const std::vector<I8> &CacheKey   //< [in] key identifying this decomp
+) {
+
+   int Err = 0;
+
+   TimerScope FuncTimer("Decomp:readCache");
+
+   MPI_Comm Comm = InEnv->getComm();
+   I4 MyTask     = InEnv->getMyTask();
+
+   MPI_File FileHandle;
+   Err = MPI_File_open(Comm, CacheFileName.c_str(), MPI_MODE_RDONLY,
+                       MPI_INFO_NULL, &FileHandle);
+   if (Err != MPI_SUCCESS) {
+      LOG_INFO("Decomp: no decomposition cache {} found", CacheFileName);
+      return 1;
+   }
+
+   // Read the header and check that the key matches. The stored key length
+   // must match before the key itself is read. All tasks read the same
+   // header so they reach the same decision.
+   I8 HeaderSize = CacheHeaderBase + CacheKey.size();
+   std::vector<I8> Header(HeaderSize, 0);
+   Err = MPI_File_read_at_all(FileHandle, 0, Header.data(), CacheHeaderBase,
+                              MPI_INT64_T, MPI_STATUS_IGNORE);
+   bool KeyMatch = (Err == MPI_SUCCESS && Header[0] == CacheMagic &&
+                    Header[1] == CacheVersion &&
+                    Header[2] == static_cast<I8>(CacheKey.size()));
+   if (KeyMatch) {
+      Err = MPI_File_read_at_all(FileHandle, CacheHeaderBase * sizeof(I8),
+                                 Header.data() + CacheHeaderBase,
+                                 CacheKey.size(), MPI_INT64_T,
+                                 MPI_STATUS_IGNORE);
+      KeyMatch = (Err == MPI_SUCCESS &&
+                  std::equal(CacheKey.begin(), CacheKey.end(),
+                             Header.begin() + CacheHeaderBase));
+   }
+   if (!KeyMatch) {
+      MPI_File_close(&FileHandle);
+      LOG_INFO("Decomp: decomposition cache {} does not match, recomputing",
+               CacheFileName);
+      return 1;
+   }
+
+   // Read the table entry and data for this task
+   I8 MyEntry[2] = {0, 0};
+
+   Err = MPI_File_read_at_all(FileHandle,
+                              (HeaderSize + 2 * MyTask) * sizeof(I8),
+                              MyEntry, 2, MPI_INT64_T, MPI_STATUS_IGNORE);
+   std::vector<I4> Buf(MyEntry[1]);
+   if (Err == MPI_SUCCESS)
+      Err = MPI_File_read_at_all(FileHandle, MyEntry[0], Buf.data(),
+                                 MyEntry[1], MPI_INT32_T, MPI_STATUS_IGNORE);
+   MPI_File_close(&FileHandle);
+
+   // Extract the size variables and check that the buffer is large enough
+   // to hold all of the arrays
+   I4 NScalars  = 15;
+   I8 BufSize   = Buf.size();
+   int LocalErr = (Err == MPI_SUCCESS && BufSize >= NScalars) ? 0 : 1;
+   if (LocalErr == 0) {
+      NCellsGlobal    = Buf[0];
+      NCellsOwned     = Buf[1];
+      NCellsAll       = Buf[2];
+      NCellsSize      = Buf[3];
+      MaxEdges        = Buf[4];
+      NEdgesGlobal    = Buf[5];
+      NEdgesOwned     = Buf[6];
+      NEdgesAll       = Buf[7];
+      NEdgesSize      = Buf[8];
+      MaxCellsOnEdge  = Buf[9];
+      NVerticesGlobal = Buf[10];
+      NVerticesOwned  = Buf[11];
+      NVerticesAll    = Buf[12];
+      NVerticesSize   = Buf[13];
+      VertexDegree    = Buf[14];
+      I8 NeededSize   = NScalars + 3 * HaloWidth +
+                        NCellsSize * (4 + 3 * MaxEdges) +
+                        NEdgesSize * (6 + MaxCellsOnEdge + 2 * MaxEdges) +
+                        NVerticesSize * (3 + 2 * VertexDegree);
+      if (BufSize != NeededSize)
+         LocalErr = 1;
+   }
+
+   int AnyErr = 0;
+   MPI_Allreduce(&LocalErr, &AnyErr, 1, MPI_INT, MPI_MAX, Comm);
+   if (AnyErr != 0) {
+      LOG_ERROR("Decomp: Error reading decomposition cache {}", CacheFileName);
+      return -1;
+   }
+
+   // Allocate and fill all host index arrays
+   NCellsHaloH     = ArrayHost1DI4("NCellsHalo", HaloWidth);
+   CellIDH         = ArrayHost1DI4("CellID", NCellsSize);
+   CellLocH        = ArrayHost2DI4("CellLoc", NCellsSize, 2);
+   NEdgesHaloH     = ArrayHost1DI4("NEdgesHalo", HaloWidth);
+   EdgeIDH         = ArrayHost1DI4("EdgeID", NEdgesSize);
+   EdgeLocH        = ArrayHost2DI4("EdgeLoc", NEdgesSize, 2);
+   NVerticesHaloH  = ArrayHost1DI4("NVerticesHalo", HaloWidth);
+   VertexIDH       = ArrayHost1DI4("VertexID", NVerticesSize);
+   VertexLocH      = ArrayHost2DI4("VertexLoc", NVerticesSize, 2);
+   CellsOnCellH    = ArrayHost2DI4("CellsOnCell", NCellsSize, MaxEdges);
+   EdgesOnCellH    = ArrayHost2DI4("EdgesOnCell", NCellsSize, MaxEdges);
+   NEdgesOnCellH   = ArrayHost1DI4("NEdgesOnCell", NCellsSize);
+   VerticesOnCellH = ArrayHost2DI4("VerticesOnCell", NCellsSize, MaxEdges);
+   CellsOnEdgeH    = ArrayHost2DI4("CellsOnEdge", NEdgesSize, MaxCellsOnEdge);
+   EdgesOnEdgeH    = ArrayHost2DI4("EdgesOnEdge", NEdgesSize, 2 * MaxEdges);
+   NEdgesOnEdgeH   = ArrayHost1DI4("NEdgesOnEdge", NEdgesSize);
+   VerticesOnEdgeH = ArrayHost2DI4("VerticesOnEdge", NEdgesSize, 2);
+   CellsOnVertexH  =
+       ArrayHost2DI4("CellsOnVertex", NVerticesSize, VertexDegree);
+   EdgesOnVertexH  =
+       ArrayHost2DI4("EdgesOnVertex", NVerticesSize, VertexDegree);
+
+   I8 BufAdd = NScalars;
+   unpackCacheArray(Buf, BufAdd, NCellsHaloH);
+   unpackCacheArray(Buf, BufAdd, CellIDH);
+   unpackCacheArray(Buf, BufAdd, CellLocH);
+   unpackCacheArray(Buf, BufAdd, NEdgesHaloH);
+   unpackCacheArray(Buf, BufAdd, EdgeIDH);
+   unpackCacheArray(Buf, BufAdd, EdgeLocH);
+   unpackCacheArray(Buf, BufAdd, NVerticesHaloH);
+   unpackCacheArray(Buf, BufAdd, VertexIDH);
+   unpackCacheArray(Buf, BufAdd, VertexLocH);
+   unpackCacheArray(Buf, BufAdd, CellsOnCellH);
+   unpackCacheArray(Buf, BufAdd, EdgesOnCellH);
+   unpackCacheArray(Buf, BufAdd, NEdgesOnCellH);
+   unpackCacheArray(Buf, BufAdd, VerticesOnCellH);
+   unpackCacheArray(Buf, BufAdd, CellsOnEdgeH);
+   unpackCacheArray(Buf, BufAdd, EdgesOnEdgeH);
+   unpackCacheArray(Buf, BufAdd, NEdgesOnEdgeH);
+   unpackCacheArray(Buf, BufAdd, VerticesOnEdgeH);
+   unpackCacheArray(Buf, BufAdd, CellsOnVertexH);
+   unpackCacheArray(Buf, BufAdd, EdgesOnVertexH);
+
+   LOG_INFO("Decomp: read decomposition from cache {}", CacheFileName);
+
+   return Err;
+
+} // end function readCache
 
 // Destructor
 //------------------------------------------------------------------------------
@@ -721,17 +1707,20 @@ Decomp *Decomp::get(const std::string Name ///< [in] Name of environment
 
 int Decomp::partCellsKWay(
     const MachEnv *InEnv, // [in] input machine environment with MPI info
-    const std::vector<I4> &CellsOnCellInit // [in] cell nbrs in linear distrb
+    const std::vector<I4> &CellsOnCellInit, // [in] cell nbrs in linear distrb
+    PartWeight Weight,                      // [in] partition weighting
+    const std::vector<I4> &LevelsInit,      // [in] levels in linear distrb
+    bool ByNode                             // [in] partition nodes first
 ) {
 
    int Err = 0; // initialize return code
 
+   TimerScope FuncTimer("Decomp:partCells");
+
    // Retrieve some info on the MPI layout
    MPI_Comm Comm = InEnv->getComm();
    I4 NumTasks   = InEnv->getNumTasks();
    I4 MyTask     = InEnv->getMyTask();
-   I4 MasterTask = InEnv->getMasterTask();
-   bool IsMaster = InEnv->isMasterTask();
 
    // TEMPORARY:
    // Due to difficulties with ParMetis, we use serial Metis for now with
@@ -799,7 +1788,6 @@ int Decomp::partCellsKWay(
 
    // NConstraints is the number of balancing constraints, mostly for
    // use when multiple vertex weights are assigned. Must be at least 1.
-   // We do not yet support weighted partitions
    idx_t NConstraints = 1;
 
    // Arrays needed for weighted decompositions. If no weighting used
@@ -808,6 +1796,58 @@ int Decomp::partCellsKWay(
    idx_t *EdgeWgtPtr{nullptr};
    idx_t *VrtxSize{nullptr};
 
+   // For weighted partitions, compute the weights for the local cells in
+   // the linear distribution and gather them on all tasks. The local edge
+   // weights follow the same pruned order used for the global adjacency.
+   std::vector<idx_t> VrtxWgt;
+   std::vector<idx_t> EdgeWgt;
+   if (Weight != PartWeightNone) {
+      I4 CellStart   = std::min(MyTask * NCellsChunk, NCellsGlobal);
+      I4 NCellsLocal =
+          std::min(CellStart + NCellsChunk, NCellsGlobal) - CellStart;
+      std::vector<idx_t> VrtxWgtLoc;
+      std::vector<idx_t> EdgeWgtLoc;
+      Err = computePartWeights(Weight, CellsOnCellInit, LevelsInit,
+                               NCellsLocal, NCellsGlobal, MaxEdges,
+                               NCellsChunk, Comm, NConstraints, VrtxWgtLoc,
+                               EdgeWgtLoc);
+      if (Err != 0) {
+         LOG_CRITICAL("Decomp: Error computing partition weights");
+         return Err;
+      }
+
+      std::vector<int> VrtxCounts(NumTasks);
+      std::vector<int> EdgeCounts(NumTasks);
+      int VrtxCount = VrtxWgtLoc.size();
+      int EdgeCount = EdgeWgtLoc.size();
+      MPI_Allgather(&VrtxCount, 1, MPI_INT, VrtxCounts.data(), 1, MPI_INT,
+                    Comm);
+      MPI_Allgather(&EdgeCount, 1, MPI_INT, EdgeCounts.data(), 1, MPI_INT,
+                    Comm);
+      std::vector<int> VrtxDispls(NumTasks, 0);
+      std::vector<int> EdgeDispls(NumTasks, 0);
+      for (int Task = 1; Task < NumTasks; ++Task) {
+         VrtxDispls[Task] = VrtxDispls[Task - 1] + VrtxCounts[Task - 1];
+         EdgeDispls[Task] = EdgeDispls[Task - 1] + EdgeCounts[Task - 1];
+      }
+
+      VrtxWgt.resize(NCellsGlobal * NConstraints);
+      EdgeWgt.resize(Add + 1);
+      Err = MPI_Allgatherv(VrtxWgtLoc.data(), VrtxCount, MPI_INT32_T,
+                           VrtxWgt.data(), VrtxCounts.data(),
+                           VrtxDispls.data(), MPI_INT32_T, Comm);
+      if (Err == 0)
+         Err = MPI_Allgatherv(EdgeWgtLoc.data(), EdgeCount, MPI_INT32_T,
+                              EdgeWgt.data(), EdgeCounts.data(),
+                              EdgeDispls.data(), MPI_INT32_T, Comm);
+      if (Err != 0) {
+         LOG_CRITICAL("Decomp: Error communicating partition weights");
+         return Err;
+      }
+      VrtxWgtPtr = VrtxWgt.data();
+      EdgeWgtPtr = EdgeWgt.data();
+   }
+
    // Use default metis options
    idx_t *Options{nullptr};
 
@@ -823,13 +1863,20 @@ int Decomp::partCellsKWay(
    std::vector<idx_t> CellTask(NCellsGlobal);
    idx_t Edgecut = 0;
 
-   // Call METIS routine to partition the mesh
+   // Call METIS routine to partition the mesh, either directly into one
+   // partition per task or across nodes and then tasks within each node.
    // METIS routines are C code that expect pointers, so we use the
    // idiom &Var[0] to extract the pointer to the data in std::vector
-   int MetisErr = METIS_PartGraphKway(&NCellsGlobal, &NConstraints, &AdjAdd[0],
-                                      &Adjacency[0], VrtxWgtPtr, VrtxSize,
-                                      EdgeWgtPtr, &NumTasks, TpWgts, Ubvec,
-                                      Options, &Edgecut, &CellTask[0]);
+   int MetisErr = METIS_OK;
+   if (ByNode) {
+      MetisErr = partGraphByNode(InEnv, NCellsGlobal, NConstraints, AdjAdd,
+                                 Adjacency, VrtxWgtPtr, EdgeWgtPtr, CellTask);
+   } else {
+      MetisErr = METIS_PartGraphKway(&NCellsGlobal, &NConstraints, &AdjAdd[0],
+                                     &Adjacency[0], VrtxWgtPtr, VrtxSize,
+                                     EdgeWgtPtr, &NumTasks, TpWgts, Ubvec,
+                                     Options, &Edgecut, &CellTask[0]);
+   }
 
    if (MetisErr != METIS_OK) {
       LOG_CRITICAL("Decomp: Error in ParMETIS");
@@ -841,8 +1888,7 @@ int Decomp::partCellsKWay(
 
    std::vector<I4> TaskCount(NumTasks, 0);
    for (int Cell = 0; Cell < NCellsGlobal; ++Cell) {
-      I4 TaskLoc  = CellTask[Cell];
-      I4 LocalAdd = TaskCount[TaskLoc];
+      I4 TaskLoc = CellTask[Cell];
       ++TaskCount[TaskLoc]; // increment number of cells assigned to task
    }
    NCellsOwned = TaskCount[MyTask];
@@ -858,83 +1904,372 @@ int Decomp::partCellsKWay(
    std::vector<I4> CellLocTmp(2 * NCellsOwned, 0); // will grow when halo added
    std::set<I4> CellsInList; // list of unique cells in local owned, halo
 
-   // reset local address counter
-   for (int Task = 0; Task < NumTasks; ++Task)
-      TaskCount[Task] = 0;
+   // reset local address counter
+   for (int Task = 0; Task < NumTasks; ++Task)
+      TaskCount[Task] = 0;
+
+   for (int Cell = 0; Cell < NCellsGlobal; ++Cell) {
+      I4 TaskLoc  = CellTask[Cell];
+      I4 LocalAdd = TaskCount[TaskLoc];
+      ++TaskCount[TaskLoc]; // increment number of cells assigned to task
+      CellLocAll[2 * Cell]     = TaskLoc;  // Task location
+      CellLocAll[2 * Cell + 1] = LocalAdd; // local address within task
+      // If this cell is on the local task, store as a local cell
+      if (TaskLoc == MyTask) {
+         CellIDTmp[LocalAdd] = Cell + 1; // IDs are 1-based
+         CellsInList.insert(Cell + 1);
+         CellLocTmp[2 * LocalAdd]     = TaskLoc;
+         CellLocTmp[2 * LocalAdd + 1] = LocalAdd;
+      } // end if my task
+   }    // end loop over all cells
+
+   // Find and add the halo cells to the cell list. Here we use the
+   // adjacency array to find the active neighbor cells and store if they
+   // are not already owned by the task. We use the std::set container
+   // to automatically sort each halo layer by cellID.
+   I4 CellLocStart = 0;
+   I4 CellLocEnd   = NCellsOwned - 1;
+   I4 CurSize      = NCellsOwned;
+   ArrayHost1DI4 NCellsHaloTmp("NCellsHalo", HaloWidth);
+   std::set<I4> HaloList;
+   // Loop over each halo layer
+   for (int Halo = 0; Halo < HaloWidth; ++Halo) {
+      // For each of the local cells in the previous level, retrieve
+      // the GlobalID
+      HaloList.clear(); // reset list for this halo layer
+      I4 NbrGlob;       // use for global address of each neighbor
+      I4 NbrID;         // global cell ID of each neighbor
+      for (int CellLoc = CellLocStart; CellLoc <= CellLocEnd; ++CellLoc) {
+         I4 CellGlob = CellIDTmp[CellLoc] - 1;
+         // Loop through the neighbor cells (stored in the adjacency arrays)
+         // to see if they are remote or local
+         I4 NbrStart = AdjAdd[CellGlob];     // start add in adjacency array
+         I4 NbrEnd   = AdjAdd[CellGlob + 1]; // end+1 add in adjacency array
+         for (int NbrCell = NbrStart; NbrCell < NbrEnd; ++NbrCell) {
+            // Get global ID for each neighbor cell
+            NbrGlob = Adjacency[NbrCell];
+            NbrID   = NbrGlob + 1; // Cell IDs are 1-based
+
+            // Check to see if this cell is on a remote task and has not
+            // already been added
+            I4 NbrTask = CellLocAll[2 * NbrGlob];
+            if (NbrTask != MyTask) {
+               // only add to the list if the cell is not already listed
+               // (the find function will return the end iterator if not found)
+               if (CellsInList.find(NbrID) == CellsInList.end()) {
+                  HaloList.insert(NbrID);
+                  CellsInList.insert(NbrID);
+               } // end search for existing entry
+            }    // end if not on task
+
+         } // end loop over neighbors
+
+      } // end loop over previous layer
+
+      // Extract the values from the Halo list into the ID and location
+      // vectors. Extend size of ID, Loc arrays.
+      I4 HaloAdd = CellLocEnd;
+      CurSize += HaloList.size();
+      NCellsHaloTmp(Halo) = CurSize;
+      CellIDTmp.resize(CurSize);
+      CellLocTmp.resize(2 * CurSize);
+
+      for (auto IHalo = HaloList.begin(); IHalo != HaloList.end(); IHalo++) {
+         ++HaloAdd;
+         NbrID              = *IHalo; // the neighbor cell id from the HaloList
+         NbrGlob            = NbrID - 1; // global address of this neighbor
+         CellIDTmp[HaloAdd] = NbrID;
+         CellLocTmp[2 * HaloAdd]     = CellLocAll[2 * NbrGlob];
+         CellLocTmp[2 * HaloAdd + 1] = CellLocAll[2 * NbrGlob + 1];
+      }
+
+      // Reset for next halo layer
+      CellLocStart = CellLocEnd + 1;
+      CellLocEnd   = NCellsHaloTmp(Halo) - 1;
+   }
+   NCellsAll  = NCellsHaloTmp(HaloWidth - 1);
+   NCellsSize = NCellsAll + 1; // extra entry to store boundary/undefined value
+
+   // The cell decomposition is now complete, copy the information
+   // into the final locations as class members on host (copy to device later)
+
+   NCellsHaloH = NCellsHaloTmp;
+
+   // Copy global ID for each cell, both owned and halo.
+   // Copy cell location (task, local add) for each cell, both owned and halo
+
+   ArrayHost1DI4 CellIDHTmp("CellID", NCellsSize);
+   ArrayHost2DI4 CellLocHTmp("CellLoc", NCellsSize, 2);
+   for (int Cell = 0; Cell < NCellsAll; ++Cell) {
+      CellIDHTmp(Cell)     = CellIDTmp[Cell];
+      CellLocHTmp(Cell, 0) = CellLocTmp[2 * Cell];     // task owning this cell
+      CellLocHTmp(Cell, 1) = CellLocTmp[2 * Cell + 1]; // local address on task
+   }
+   CellIDH  = CellIDHTmp;
+   CellLocH = CellLocHTmp;
+
+   // All done
+   return Err;
+
+} // end function partCellsKWay
+
+//------------------------------------------------------------------------------
+// Partition the cells using the ParMetis KWay method. Unlike partCellsKWay,
+// the adjacency graph is never assembled on a single task. ParMETIS works
+// directly on the initial linear distribution of CellsOnCell and each task
+// then retrieves the adjacency and location of its owned and halo cells from
+// the task holding that cell in the linear distribution. On exit, the
+// class member CellID and CellLoc arrays and the NCells size variables have
+// been set exactly as in partCellsKWay.
+
+int Decomp::partCellsParKWay(
+    const MachEnv *InEnv, // [in] input machine environment with MPI info
+    const std::vector<I4> &CellsOnCellInit, // [in] cell nbrs in linear distrb
+    PartWeight Weight,                      // [in] partition weighting
+    const std::vector<I4> &LevelsInit       // [in] levels in linear distrb
+) {
+
+   int Err = 0; // initialize return code
+
+   TimerScope FuncTimer("Decomp:partCells");
+
+   // Retrieve some info on the MPI layout
+   MPI_Comm Comm = InEnv->getComm();
+   I4 NumTasks   = InEnv->getNumTasks();
+   I4 MyTask     = InEnv->getMyTask();
+
+   // Determine the range of global cells in the initial linear distribution
+   // on every task. This is the vertex distribution needed by ParMETIS.
+   // When the cells do not divide evenly, the last task(s) have fewer cells.
+   I4 NCellsChunk = (NCellsGlobal - 1) / NumTasks + 1;
+   std::vector<idx_t> VtxDist(NumTasks + 1);
+   for (int Task = 0; Task <= NumTasks; ++Task)
+      VtxDist[Task] = std::min(Task * NCellsChunk, NCellsGlobal);
+   I4 CellStart   = VtxDist[MyTask];
+   I4 NCellsLocal = VtxDist[MyTask + 1] - CellStart;
+
+   // Create the local portion of the adjacency graph in the compressed
+   // form needed by ParMETIS, pruning edges that don't have neighbors.
+   std::vector<idx_t> AdjAdd(NCellsLocal + 1, 0);
+   std::vector<idx_t> Adjacency;
+   Adjacency.reserve(NCellsLocal * MaxEdges + 1);
+   for (int Cell = 0; Cell < NCellsLocal; ++Cell) {
+      AdjAdd[Cell] = Adjacency.size();
+      for (int Edge = 0; Edge < MaxEdges; ++Edge) {
+         I4 NbrCell = CellsOnCellInit[Cell * MaxEdges + Edge];
+         if (validCellID(NbrCell))
+            Adjacency.push_back(NbrCell - 1); // switch to 0-based indx
+      }
+   }
+   AdjAdd[NCellsLocal] = Adjacency.size();
+   Adjacency.push_back(0); // guarantees a valid pointer for empty graphs
+
+   // Set up remaining partitioning variables. Unweighted partitions use
+   // WgtFlag=0 and we use 0-based (C) numbering.
+   idx_t WgtFlag      = 0;
+   idx_t NumFlag      = 0;
+   idx_t NConstraints = 1;
+   idx_t NParts       = NumTasks;
+   idx_t *VrtxWgtPtr{nullptr};
+   idx_t *EdgeWgtPtr{nullptr};
+
+   // For weighted partitions, both vertex and edge weights are used
+   // (WgtFlag=3). The edge weights follow the pruned adjacency above.
+   std::vector<idx_t> VrtxWgt;
+   std::vector<idx_t> EdgeWgt;
+   if (Weight != PartWeightNone) {
+      Err = computePartWeights(Weight, CellsOnCellInit, LevelsInit,
+                               NCellsLocal, NCellsGlobal, MaxEdges,
+                               NCellsChunk, Comm, NConstraints, VrtxWgt,
+                               EdgeWgt);
+      if (Err != 0) {
+         LOG_CRITICAL("Decomp: Error computing partition weights");
+         return Err;
+      }
+      EdgeWgt.push_back(0); // guarantees a valid pointer for empty graphs
+      WgtFlag    = 3;
+      VrtxWgtPtr = VrtxWgt.data();
+      EdgeWgtPtr = EdgeWgt.data();
+   }
+
+   // Unlike serial METIS, ParMETIS requires the target partition weights
+   // and imbalance tolerance. Use equal weights and the recommended 5%
+   // tolerance. The first entry of Options is zero to use the defaults.
+   std::vector<real_t> TpWgts(NConstraints * NParts, 1.0 / NParts);
+   std::vector<real_t> Ubvec(NConstraints, 1.05);
+   idx_t Options[3] = {0, 0, 0};
+
+   // Results are stored in a partition array which returns the
+   // processor (partition) assigned to each locally-held cell
+   std::vector<idx_t> CellTaskInit(NCellsLocal + 1, 0);
+   idx_t Edgecut    = 0;
+   MPI_Comm ParComm = Comm; // ParMETIS requires a non-const pointer
+
+   int MetisErr = ParMETIS_V3_PartKway(
+       VtxDist.data(), AdjAdd.data(), Adjacency.data(), VrtxWgtPtr,
+       EdgeWgtPtr, &WgtFlag, &NumFlag, &NConstraints, &NParts, TpWgts.data(),
+       Ubvec.data(), Options, &Edgecut, CellTaskInit.data(), &ParComm);
+
+   if (MetisErr != METIS_OK) {
+      LOG_CRITICAL("Decomp: Error in ParMETIS");
+      Err = -1;
+      return Err;
+   }
+
+   // Determine the local address of each cell on its new task. Cells are
+   // ordered by global ID on each task, so the address is the number of
+   // cells assigned to the task by lower tasks in the linear distribution
+   // (an exclusive scan) plus the count of earlier cells in this chunk.
+   std::vector<I4> TaskCount(NumTasks, 0);
+   std::vector<I4> TaskOffset(NumTasks, 0);
+   for (int Cell = 0; Cell < NCellsLocal; ++Cell)
+      ++TaskCount[CellTaskInit[Cell]];
+
+   Err = MPI_Exscan(TaskCount.data(), TaskOffset.data(), NumTasks,
+                    MPI_INT32_T, MPI_SUM, Comm);
+   if (Err != 0) {
+      LOG_CRITICAL("Decomp: Error computing cell offsets");
+      return Err;
+   }
+   if (MyTask == 0) // Exscan result is undefined on the first task
+      std::fill(TaskOffset.begin(), TaskOffset.end(), 0);
+
+   Err = MPI_Reduce_scatter_block(TaskCount.data(), &NCellsOwned, 1,
+                                  MPI_INT32_T, MPI_SUM, Comm);
+   if (Err != 0) {
+      LOG_CRITICAL("Decomp: Error computing owned cell count");
+      return Err;
+   }
+
+   std::vector<I4> CellLocInit(2 * NCellsLocal);
+   for (int Cell = 0; Cell < NCellsLocal; ++Cell) {
+      I4 TaskLoc                = CellTaskInit[Cell];
+      CellLocInit[2 * Cell]     = TaskLoc;
+      CellLocInit[2 * Cell + 1] = TaskOffset[TaskLoc]++;
+   }
+
+   // Send each cell in the linear distribution to its new owner. Each
+   // cell is described by a record containing the global ID, local address
+   // on the new task, the number of valid neighbors and the neighbor IDs.
+   std::vector<std::vector<I4>> SendLists(NumTasks);
+   std::vector<std::vector<I4>> RecvLists(NumTasks);
+   for (int Cell = 0; Cell < NCellsLocal; ++Cell) {
+      std::vector<I4> &Rec = SendLists[CellLocInit[2 * Cell]];
+      I4 NNbrs             = AdjAdd[Cell + 1] - AdjAdd[Cell];
+      Rec.push_back(CellStart + Cell + 1); // IDs are 1-based
+      Rec.push_back(CellLocInit[2 * Cell + 1]);
+      Rec.push_back(NNbrs);
+      for (int Nbr = AdjAdd[Cell]; Nbr < AdjAdd[Cell + 1]; ++Nbr)
+         Rec.push_back(Adjacency[Nbr] + 1);
+   }
 
-   for (int Cell = 0; Cell < NCellsGlobal; ++Cell) {
-      I4 TaskLoc  = CellTask[Cell];
-      I4 LocalAdd = TaskCount[TaskLoc];
-      ++TaskCount[TaskLoc]; // increment number of cells assigned to task
-      CellLocAll[2 * Cell]     = TaskLoc;  // Task location
-      CellLocAll[2 * Cell + 1] = LocalAdd; // local address within task
-      // If this cell is on the local task, store as a local cell
-      if (TaskLoc == MyTask) {
-         CellIDTmp[LocalAdd] = Cell + 1; // IDs are 1-based
-         CellsInList.insert(Cell + 1);
-         CellLocTmp[2 * LocalAdd]     = TaskLoc;
+   Err = exchangeLists(SendLists, RecvLists, Comm);
+   if (Err != 0) {
+      LOG_CRITICAL("Decomp: Error sending cells to new owners");
+      return Err;
+   }
+
+   // Store the owned cells and their neighbors. During this process we also
+   // create an ordered list of all local (owned+halo) cells using std::set
+   // for later use in halo setup.
+   std::vector<I4> CellIDTmp(NCellsOwned, NCellsGlobal + 1);
+   std::vector<I4> CellLocTmp(2 * NCellsOwned, 0);
+   std::vector<std::vector<I4>> CellNbrsTmp(NCellsOwned);
+   std::set<I4> CellsInList;
+   for (int Task = 0; Task < NumTasks; ++Task) {
+      const std::vector<I4> &Rec = RecvLists[Task];
+      I4 RecAdd                  = 0;
+      while (RecAdd < static_cast<I4>(Rec.size())) {
+         I4 GlobID                    = Rec[RecAdd];
+         I4 LocalAdd                  = Rec[RecAdd + 1];
+         I4 NNbrs                     = Rec[RecAdd + 2];
+         CellIDTmp[LocalAdd]          = GlobID;
+         CellLocTmp[2 * LocalAdd]     = MyTask;
          CellLocTmp[2 * LocalAdd + 1] = LocalAdd;
-      } // end if my task
-   }    // end loop over all cells
+         CellNbrsTmp[LocalAdd].assign(Rec.begin() + RecAdd + 3,
+                                      Rec.begin() + RecAdd + 3 + NNbrs);
+         CellsInList.insert(GlobID);
+         RecAdd += 3 + NNbrs;
+      }
+   }
 
-   // Find and add the halo cells to the cell list. Here we use the
-   // adjacency array to find the active neighbor cells and store if they
-   // are not already owned by the task. We use the std::set container
-   // to automatically sort each halo layer by cellID.
+   // Find and add the halo cells to the cell list, one layer at a time.
+   // Neighbors of the previous layer that are not yet in the list form the
+   // next layer, sorted by cell ID in the std::set container. The location
+   // and neighbors of each new halo cell are then requested from the task
+   // holding the cell in the linear distribution.
    I4 CellLocStart = 0;
    I4 CellLocEnd   = NCellsOwned - 1;
    I4 CurSize      = NCellsOwned;
    ArrayHost1DI4 NCellsHaloTmp("NCellsHalo", HaloWidth);
    std::set<I4> HaloList;
-   // Loop over each halo layer
    for (int Halo = 0; Halo < HaloWidth; ++Halo) {
-      // For each of the local cells in the previous level, retrieve
-      // the GlobalID
+
       HaloList.clear(); // reset list for this halo layer
-      I4 NbrGlob;       // use for global address of each neighbor
-      I4 NbrID;         // global cell ID of each neighbor
       for (int CellLoc = CellLocStart; CellLoc <= CellLocEnd; ++CellLoc) {
-         I4 CellGlob = CellIDTmp[CellLoc] - 1;
-         // Loop through the neighbor cells (stored in the adjacency arrays)
-         // to see if they are remote or local
-         I4 NbrStart = AdjAdd[CellGlob];     // start add in adjacency array
-         I4 NbrEnd   = AdjAdd[CellGlob + 1]; // end+1 add in adjacency array
-         for (int NbrCell = NbrStart; NbrCell < NbrEnd; ++NbrCell) {
-            // Get global ID for each neighbor cell
-            NbrGlob = Adjacency[NbrCell];
-            NbrID   = NbrGlob + 1; // Cell IDs are 1-based
+         for (I4 NbrID : CellNbrsTmp[CellLoc]) {
+            if (CellsInList.find(NbrID) == CellsInList.end()) {
+               HaloList.insert(NbrID);
+               CellsInList.insert(NbrID);
+            }
+         }
+      }
 
-            // Check to see if this cell is on a remote task and has not
-            // already been added
-            I4 NbrTask = CellLocAll[2 * NbrGlob];
-            if (NbrTask != MyTask) {
-               // only add to the list if the cell is not already listed
-               // (the find function will return the end iterator if not found)
-               if (CellsInList.find(NbrID) == CellsInList.end()) {
-                  HaloList.insert(NbrID);
-                  CellsInList.insert(NbrID);
-               } // end search for existing entry
-            }    // end if not on task
+      // Request halo cell info from the linear distribution. Since the
+      // linear distribution is ordered by cell ID, requests to each task
+      // and the replies remain sorted by cell ID.
+      std::vector<std::vector<I4>> ReqLists(NumTasks);
+      std::vector<std::vector<I4>> QryLists(NumTasks);
+      for (I4 NbrID : HaloList)
+         ReqLists[(NbrID - 1) / NCellsChunk].push_back(NbrID);
 
-         } // end loop over neighbors
+      Err = exchangeLists(ReqLists, QryLists, Comm);
+      if (Err != 0) {
+         LOG_CRITICAL("Decomp: Error requesting halo cells");
+         return Err;
+      }
 
-      } // end loop over previous layer
+      // Reply with location and neighbors for each requested cell
+      for (int Task = 0; Task < NumTasks; ++Task) {
+         SendLists[Task].clear();
+         for (I4 QryID : QryLists[Task]) {
+            I4 Cell = QryID - 1 - CellStart;
+            SendLists[Task].push_back(CellLocInit[2 * Cell]);
+            SendLists[Task].push_back(CellLocInit[2 * Cell + 1]);
+            SendLists[Task].push_back(AdjAdd[Cell + 1] - AdjAdd[Cell]);
+            for (int Nbr = AdjAdd[Cell]; Nbr < AdjAdd[Cell + 1]; ++Nbr)
+               SendLists[Task].push_back(Adjacency[Nbr] + 1);
+         }
+      }
 
-      // Extract the values from the Halo list into the ID and location
-      // vectors. Extend size of ID, Loc arrays.
+      Err = exchangeLists(SendLists, RecvLists, Comm);
+      if (Err != 0) {
+         LOG_CRITICAL("Decomp: Error retrieving halo cells");
+         return Err;
+      }
+
+      // Extract the replies into the ID and location vectors.
+      // Extend size of ID, Loc arrays.
       I4 HaloAdd = CellLocEnd;
       CurSize += HaloList.size();
       NCellsHaloTmp(Halo) = CurSize;
       CellIDTmp.resize(CurSize);
       CellLocTmp.resize(2 * CurSize);
-
-      for (auto IHalo = HaloList.begin(); IHalo != HaloList.end(); IHalo++) {
-         ++HaloAdd;
-         NbrID              = *IHalo; // the neighbor cell id from the HaloList
-         NbrGlob            = NbrID - 1; // global address of this neighbor
-         CellIDTmp[HaloAdd] = NbrID;
-         CellLocTmp[2 * HaloAdd]     = CellLocAll[2 * NbrGlob];
-         CellLocTmp[2 * HaloAdd + 1] = CellLocAll[2 * NbrGlob + 1];
+      CellNbrsTmp.resize(CurSize);
+
+      for (int Task = 0; Task < NumTasks; ++Task) {
+         const std::vector<I4> &Rec = RecvLists[Task];
+         I4 RecAdd                  = 0;
+         for (I4 NbrID : ReqLists[Task]) {
+            ++HaloAdd;
+            I4 NNbrs                    = Rec[RecAdd + 2];
+            CellIDTmp[HaloAdd]          = NbrID;
+            CellLocTmp[2 * HaloAdd]     = Rec[RecAdd];
+            CellLocTmp[2 * HaloAdd + 1] = Rec[RecAdd + 1];
+            CellNbrsTmp[HaloAdd].assign(Rec.begin() + RecAdd + 3,
+                                        Rec.begin() + RecAdd + 3 + NNbrs);
+            RecAdd += 3 + NNbrs;
+         }
       }
 
       // Reset for next halo layer
@@ -949,9 +2284,6 @@ int Decomp::partCellsKWay(
 
    NCellsHaloH = NCellsHaloTmp;
 
-   // Copy global ID for each cell, both owned and halo.
-   // Copy cell location (task, local add) for each cell, both owned and halo
-
    ArrayHost1DI4 CellIDHTmp("CellID", NCellsSize);
    ArrayHost2DI4 CellLocHTmp("CellLoc", NCellsSize, 2);
    for (int Cell = 0; Cell < NCellsAll; ++Cell) {
@@ -965,7 +2297,7 @@ int Decomp::partCellsKWay(
    // All done
    return Err;
 
-} // end function partCellsKWay
+} // end function partCellsParKWay
 
 //------------------------------------------------------------------------------
 // Partition the edges based on the cell decomposition. The first cell ID in
@@ -978,26 +2310,22 @@ int Decomp::partEdges(
 
    I4 Err = 0; // default error code
 
+   TimerScope FuncTimer("Decomp:partEdges");
+
    // Retrieve some info on the MPI layout
    MPI_Comm Comm = InEnv->getComm();
    I4 NumTasks   = InEnv->getNumTasks();
    I4 MyTask     = InEnv->getMyTask();
-   I4 MasterTask = InEnv->getMasterTask();
-   bool IsMaster = InEnv->isMasterTask();
 
    // Calculate some quantities associated with the initial linear
    // distribution
-   I4 NCellsChunk = (NCellsGlobal - 1) / NumTasks + 1;
    I4 NEdgesChunk = (NEdgesGlobal - 1) / NumTasks + 1;
-   I4 NCellsLocal = NCellsChunk;
    I4 NEdgesLocal = NEdgesChunk;
 
-   // If cells/edges do not divide evenly over processors, the last processor
-   // only has the remaining cells and not a full block (chunk)
+   // If edges do not divide evenly over processors, the last processor
+   // only has the remaining edges and not a full block (chunk)
    if (MyTask == NumTasks - 1) {
-      I4 StartAdd = NCellsChunk * (NumTasks - 1);
-      NCellsLocal = NCellsGlobal - StartAdd;
-      StartAdd    = NEdgesChunk * (NumTasks - 1);
+      I4 StartAdd = NEdgesChunk * (NumTasks - 1);
       NEdgesLocal = NEdgesGlobal - StartAdd;
    }
 
@@ -1006,13 +2334,11 @@ int Decomp::partEdges(
    // We create sets for local owned cells, all local edges,
    // local owned edges and local halo edges.
    std::set<I4> CellsOwned;
-   std::set<I4> CellsAll;
    std::set<I4> EdgesAll;
    std::set<I4> EdgesOwned;
    std::set<I4> EdgesOwnedHalo1;
 
    for (int Cell = 0; Cell < NCellsAll; ++Cell) {
-      CellsAll.insert(CellIDH(Cell));
       if (Cell < NCellsOwned)
          CellsOwned.insert(CellIDH(Cell));
    }
@@ -1038,11 +2364,11 @@ int Decomp::partEdges(
    // To determine whether the edge is owned by this task, we first
    // determine ownership as the first valid cell in the CellsOnEdge
    // array. CellsOnEdge is only in the initial linear decomposition so
-   // we compute it there and broadcast the data to other MPI tasks.
+   // we compute it there and each task retrieves the owner cell for each
+   // of its local edges from the task holding that edge.
 
    std::vector<I4> EdgeOwnerInit(NEdgesChunk, NCellsGlobal + 1);
    for (int Edge = 0; Edge < NEdgesLocal; ++Edge) {
-      I4 EdgeGlob = MyTask * NEdgesChunk + Edge + 1;
       for (int Cell = 0; Cell < MaxCellsOnEdge; ++Cell) {
          I4 CellGlob = CellsOnEdgeInit[Edge * MaxCellsOnEdge + Cell];
          if (validCellID(CellGlob)) {
@@ -1052,40 +2378,20 @@ int Decomp::partEdges(
       }
    }
 
-   // Broadcast the edge ownership to all tasks, one chunk at a time
-   // and create a sorted list of all owned edges.
-
-   std::vector<I4> EdgeBuf(NEdgesChunk);
-   for (int Task = 0; Task < NumTasks; ++Task) {
-
-      // if it is this task's turn, fill the buffer with the owner info
-      if (Task == MyTask) {
-         for (int Edge = 0; Edge < NEdgesChunk; ++Edge) {
-            EdgeBuf[Edge] = EdgeOwnerInit[Edge];
-         }
-      }
-      // Broadcast this buffer
-      Err = MPI_Bcast(&EdgeBuf[0], NEdgesChunk, MPI_INT32_T, Task, Comm);
-
-      // For each edge in the buffer, check to see if the task owns
-      // the cell. If so, add the edge ID to the owned edges list.
-      for (int Edge = 0; Edge < NEdgesChunk; ++Edge) {
-
-         I4 EdgeGlob =
-             Task * NEdgesChunk + Edge + 1; // Global ID in initial distrb
-         // when number of edges doesn't divide evenly, the last
-         // task has some invalid edges at the end so break out of loop
-         if (EdgeGlob > NEdgesGlobal)
-            break;
-
-         I4 CellOwner = EdgeBuf[Edge];
-         if (CellsOwned.find(CellOwner) != CellsOwned.end()) {
-            // this task owns cell and therefore the edge
-            EdgesOwned.insert(EdgeGlob);
-         }
-      }
+   std::vector<I4> EdgeList(EdgesAll.begin(), EdgesAll.end());
+   std::vector<I4> EdgeOwner;
+   Err = fetchLinearRows(EdgeList, EdgeOwnerInit, 1, NEdgesChunk, EdgeOwner,
+                         Comm);
+   if (Err != 0) {
+      LOG_CRITICAL("partEdges: Error retrieving edge owners");
+      return Err;
+   }
 
-   } // end task loop
+   // If this task owns the owner cell, add the edge to the owned list
+   for (int Edge = 0; Edge < NEdgesAll; ++Edge) {
+      if (CellsOwned.find(EdgeOwner[Edge]) != CellsOwned.end())
+         EdgesOwned.insert(EdgeList[Edge]);
+   }
 
    // For compatibility with the previous MPAS model, we sort the
    // edges based on the order encounted in EdgesOnCell. The first halo
@@ -1154,45 +2460,35 @@ int Decomp::partEdges(
    } // end halo loop
 
    // Now that we have the local lists, update the final location
-   // (task, local edge address) of each of the local edges. This
-   // requires one more round of communication.
-   // Resize the buffer to make sure we have enough room - the distribution
-   // may be less even than the original chunk size.
-
-   ArrayHost2DI4 EdgeLocTmp("EdgeLoc", NEdgesSize, 2);
-   EdgeBuf.resize(2 * NEdgesChunk);
-
-   for (int Edge = 0; Edge < NEdgesSize; ++Edge) {
-      EdgeLocTmp(Edge, 0) = MyTask;
-      EdgeLocTmp(Edge, 1) = NEdgesAll;
+   // (task, local edge address) of each of the local edges. Each task
+   // first registers the location of its owned edges with the task holding
+   // that edge in the linear distribution (a directory) and then retrieves
+   // the location of all of its local edges from that directory.
+
+   std::vector<I4> EdgeLocInit(2 * NEdgesChunk, 0);
+   Err = fillLocDirectory(EdgeIDTmp, NEdgesOwned, NEdgesChunk, EdgeLocInit,
+                          Comm);
+   if (Err != 0) {
+      LOG_CRITICAL("partEdges: Error registering edge locations");
+      return Err;
    }
 
-   for (int Task = 0; Task < NumTasks; ++Task) {
+   std::vector<I4> EdgeLocal(EdgeIDTmp.data(), EdgeIDTmp.data() + NEdgesAll);
+   std::vector<I4> EdgeLocAll;
+   Err = fetchLinearRows(EdgeLocal, EdgeLocInit, 2, NEdgesChunk, EdgeLocAll,
+                         Comm);
+   if (Err != 0) {
+      LOG_CRITICAL("partEdges: Error retrieving edge locations");
+      return Err;
+   }
 
-      // fill broadcast buffer with the list of owned edges. The
-      // first entry in the vector is the number of edges owned by
-      // this task.
-      if (Task == MyTask) {
-         EdgeBuf[0] = NEdgesOwned;
-         for (int BufEdge = 0; BufEdge < NEdgesOwned; ++BufEdge) {
-            EdgeBuf[BufEdge + 1] = EdgeIDTmp(BufEdge);
-         }
-      }
-      // Broadcast the list of edges owned by this task
-      Err = MPI_Bcast(&EdgeBuf[0], 2 * NEdgesChunk, MPI_INT32_T, Task, Comm);
-
-      // For each edge in the buffer, search the full list of edges on
-      // this task and store the location
-      I4 BufOwned = EdgeBuf[0];
-      for (int BufEdge = 0; BufEdge < BufOwned; ++BufEdge) {
-         I4 GlobID = EdgeBuf[BufEdge + 1];
-         I4 Edge   = srchVector(EdgeIDTmp, GlobID);
-         if (Edge < NEdgesAll) {
-            EdgeLocTmp(Edge, 0) = Task;    // Task that owns edge
-            EdgeLocTmp(Edge, 1) = BufEdge; // Local address on task
-         }
-      }
+   ArrayHost2DI4 EdgeLocTmp("EdgeLoc", NEdgesSize, 2);
+   for (int Edge = 0; Edge < NEdgesAll; ++Edge) {
+      EdgeLocTmp(Edge, 0) = EdgeLocAll[2 * Edge];     // Task that owns edge
+      EdgeLocTmp(Edge, 1) = EdgeLocAll[2 * Edge + 1]; // Local address on task
    }
+   EdgeLocTmp(NEdgesAll, 0) = MyTask;
+   EdgeLocTmp(NEdgesAll, 1) = NEdgesAll;
 
    // Copy ID and location arrays into permanent storage
    EdgeIDH     = EdgeIDTmp;
@@ -1215,26 +2511,22 @@ int Decomp::partVertices(
 
    I4 Err = 0; // default error code
 
+   TimerScope FuncTimer("Decomp:partVertices");
+
    // Retrieve some info on the MPI layout
    MPI_Comm Comm = InEnv->getComm();
    I4 NumTasks   = InEnv->getNumTasks();
    I4 MyTask     = InEnv->getMyTask();
-   I4 MasterTask = InEnv->getMasterTask();
-   bool IsMaster = InEnv->isMasterTask();
 
    // Calculate some quantities associated with the initial linear
    // distribution
-   I4 NCellsChunk    = (NCellsGlobal - 1) / NumTasks + 1;
-   I4 NCellsLocal    = NCellsChunk;
    I4 NVerticesChunk = (NVerticesGlobal - 1) / NumTasks + 1;
    I4 NVerticesLocal = NVerticesChunk;
 
-   // If cells/edges do not divide evenly over processors, the last processor
-   // only has the remaining cells and not a full block (chunk)
+   // If vertices do not divide evenly over processors, the last processor
+   // only has the remaining vertices and not a full block (chunk)
    if (MyTask == NumTasks - 1) {
-      I4 StartAdd    = NCellsChunk * (NumTasks - 1);
-      NCellsLocal    = NCellsGlobal - StartAdd;
-      StartAdd       = NVerticesChunk * (NumTasks - 1);
+      I4 StartAdd    = NVerticesChunk * (NumTasks - 1);
       NVerticesLocal = NVerticesGlobal - StartAdd;
    }
 
@@ -1243,13 +2535,11 @@ int Decomp::partVertices(
    // functions. We create sets for local owned cells, all local vertices,
    // local owned vertices and local halo vertices.
    std::set<I4> CellsOwned;
-   std::set<I4> CellsAll;
    std::set<I4> VerticesAll;
    std::set<I4> VerticesOwned;
    std::set<I4> VerticesOwnedHalo1;
 
    for (int Cell = 0; Cell < NCellsAll; ++Cell) {
-      CellsAll.insert(CellIDH(Cell));
       if (Cell < NCellsOwned)
          CellsOwned.insert(CellIDH(Cell));
    }
@@ -1275,11 +2565,11 @@ int Decomp::partVertices(
    // To determine whether the vertex is owned by this task, we first
    // determine ownership as the first valid cell in the CellsOnVertex
    // array. CellsOnVertex is only in the initial linear decomposition so
-   // we compute it there and broadcast the data to other MPI tasks.
+   // we compute it there and each task retrieves the owner cell for each
+   // of its local vertices from the task holding that vertex.
 
    std::vector<I4> VrtxOwnerInit(NVerticesChunk, NCellsGlobal + 1);
    for (int Vrtx = 0; Vrtx < NVerticesLocal; ++Vrtx) {
-      I4 VrtxGlob = MyTask * NVerticesChunk + Vrtx + 1;
       for (int Cell = 0; Cell < VertexDegree; ++Cell) {
          I4 CellGlob = CellsOnVertexInit[Vrtx * VertexDegree + Cell];
          if (validCellID(CellGlob)) {
@@ -1289,40 +2579,20 @@ int Decomp::partVertices(
       }
    }
 
-   // Broadcast the vertex ownership to all tasks, one chunk at a time
-   // and create a sorted list of all owned vertices.
-
-   std::vector<I4> VrtxBuf(NVerticesChunk);
-   for (int Task = 0; Task < NumTasks; ++Task) {
-
-      // if it is this task's turn, fill the buffer with the owner info
-      if (Task == MyTask) {
-         for (int Vrtx = 0; Vrtx < NVerticesChunk; ++Vrtx) {
-            VrtxBuf[Vrtx] = VrtxOwnerInit[Vrtx];
-         }
-      }
-      // Broadcast this buffer
-      Err = MPI_Bcast(&VrtxBuf[0], NVerticesChunk, MPI_INT32_T, Task, Comm);
-
-      // For each vertex in the buffer, check to see if the task owns
-      // the cell. If so, add the vertex ID to the owned vertices list.
-      for (int Vrtx = 0; Vrtx < NVerticesChunk; ++Vrtx) {
-
-         I4 VrtxGlob =
-             Task * NVerticesChunk + Vrtx + 1; // Global ID init distrb
-         // when number of vertices doesn't divide evenly, the last
-         // task has some invalid vertices at the end so break out of loop
-         if (VrtxGlob > NVerticesGlobal)
-            break;
-
-         I4 CellOwner = VrtxBuf[Vrtx];
-         if (CellsOwned.find(CellOwner) != CellsOwned.end()) {
-            // this task owns cell and therefore the edge
-            VerticesOwned.insert(VrtxGlob);
-         }
-      }
+   std::vector<I4> VrtxList(VerticesAll.begin(), VerticesAll.end());
+   std::vector<I4> VrtxOwner;
+   Err = fetchLinearRows(VrtxList, VrtxOwnerInit, 1, NVerticesChunk,
+                         VrtxOwner, Comm);
+   if (Err != 0) {
+      LOG_CRITICAL("partVertices: Error retrieving vertex owners");
+      return Err;
+   }
 
-   } // end task loop
+   // If this task owns the owner cell, add the vertex to the owned list
+   for (int Vrtx = 0; Vrtx < NVerticesAll; ++Vrtx) {
+      if (CellsOwned.find(VrtxOwner[Vrtx]) != CellsOwned.end())
+         VerticesOwned.insert(VrtxList[Vrtx]);
+   }
 
    // For compatibility with the previous MPAS model, we sort the
    // vertices based on the order encounted in VerticesOnCell. The first halo
@@ -1392,45 +2662,36 @@ int Decomp::partVertices(
    } // end halo loop
 
    // Now that we have the local lists, update the final location
-   // (task, local edge address) of each of the local vertices. This
-   // requires one more round of communication.
-   // Resize the buffer to make sure we have enough room - the distribution
-   // may be less even than the original chunk size.
-
-   ArrayHost2DI4 VertexLocTmp("VertexLoc", NVerticesSize, 2);
-   VrtxBuf.resize(2 * NVerticesChunk);
-
-   for (int Vrtx = 0; Vrtx < NVerticesSize; ++Vrtx) {
-      VertexLocTmp(Vrtx, 0) = MyTask;
-      VertexLocTmp(Vrtx, 1) = NVerticesAll;
+   // (task, local vertex address) of each of the local vertices. Each task
+   // first registers the location of its owned vertices with the task
+   // holding that vertex in the linear distribution (a directory) and then
+   // retrieves the location of all of its local vertices from that directory.
+
+   std::vector<I4> VrtxLocInit(2 * NVerticesChunk, 0);
+   Err = fillLocDirectory(VertexIDTmp, NVerticesOwned, NVerticesChunk,
+                          VrtxLocInit, Comm);
+   if (Err != 0) {
+      LOG_CRITICAL("partVertices: Error registering vertex locations");
+      return Err;
    }
 
-   for (int Task = 0; Task < NumTasks; ++Task) {
+   std::vector<I4> VrtxLocal(VertexIDTmp.data(),
+                             VertexIDTmp.data() + NVerticesAll);
+   std::vector<I4> VrtxLocAll;
+   Err = fetchLinearRows(VrtxLocal, VrtxLocInit, 2, NVerticesChunk,
+                         VrtxLocAll, Comm);
+   if (Err != 0) {
+      LOG_CRITICAL("partVertices: Error retrieving vertex locations");
+      return Err;
+   }
 
-      // fill broadcast buffer with the list of owned vertices. The
-      // first entry in the vector is the number of vertices owned by
-      // this task.
-      if (Task == MyTask) {
-         VrtxBuf[0] = NVerticesOwned;
-         for (int BufVrtx = 0; BufVrtx < NVerticesOwned; ++BufVrtx) {
-            VrtxBuf[BufVrtx + 1] = VertexIDTmp(BufVrtx);
-         }
-      }
-      // Broadcast the list of edges owned by this task
-      Err = MPI_Bcast(&VrtxBuf[0], 2 * NVerticesChunk, MPI_INT32_T, Task, Comm);
-
-      // For each vertex in the buffer, search the full list of vertices on
-      // this task and store the location
-      I4 BufOwned = VrtxBuf[0];
-      for (int BufVrtx = 0; BufVrtx < BufOwned; ++BufVrtx) {
-         I4 GlobID = VrtxBuf[BufVrtx + 1];
-         I4 Vrtx   = srchVector(VertexIDTmp, GlobID);
-         if (Vrtx < NVerticesAll) {
-            VertexLocTmp(Vrtx, 0) = Task;    // Task that owns vertex
-            VertexLocTmp(Vrtx, 1) = BufVrtx; // Local address on task
-         }
-      }
+   ArrayHost2DI4 VertexLocTmp("VertexLoc", NVerticesSize, 2);
+   for (int Vrtx = 0; Vrtx < NVerticesAll; ++Vrtx) {
+      VertexLocTmp(Vrtx, 0) = VrtxLocAll[2 * Vrtx];     // Task owning vertex
+      VertexLocTmp(Vrtx, 1) = VrtxLocAll[2 * Vrtx + 1]; // Local add on task
    }
+   VertexLocTmp(NVerticesAll, 0) = MyTask;
+   VertexLocTmp(NVerticesAll, 1) = NVerticesAll;
 
    // Copy ID and location arrays into permanent storage
    VertexIDH      = VertexIDTmp;
@@ -1456,12 +2717,11 @@ int Decomp::rearrangeCellArrays(
 
    int Err = 0; // default return code
 
+   TimerScope FuncTimer("Decomp:rearrangeCells");
+
    // Extract some MPI information
    MPI_Comm Comm = InEnv->getComm();
    I4 NumTasks   = InEnv->getNumTasks();
-   I4 MyTask     = InEnv->getMyTask();
-   I4 MasterTask = InEnv->getMasterTask();
-   bool IsMaster = InEnv->isMasterTask();
 
    // Define the chunk sizes for the initial linear distribution
    I4 NCellsChunk = (NCellsGlobal - 1) / NumTasks + 1;
@@ -1483,75 +2743,55 @@ int Decomp::rearrangeCellArrays(
    yakl::memset(VerticesOnCellTmp, NVerticesGlobal + 1);
    yakl::memset(NEdgesOnCellTmp, 0);
 
-   // Each task will broadcast the cells it owns in the initial linear
-   // distribution and all tasks will search that list and extract the
-   // entries it owns.
-   for (int Task = 0; Task < NumTasks; ++Task) {
-
-      // If it is this task's turn to send, fill the buffer with the local
-      // chunk of all three arrays.
-      if (MyTask == Task) { // Fill buffer with local chunk
-         for (int Cell = 0; Cell < NCellsChunk; ++Cell) {
-            for (int Edge = 0; Edge < MaxEdges; ++Edge) {
-               I4 BufAdd           = Cell * SizePerCell + Edge * 3;
-               I4 ArrayAdd         = Cell * MaxEdges + Edge;
-               CellBuf[BufAdd]     = CellsOnCellInit[ArrayAdd];
-               CellBuf[BufAdd + 1] = VerticesOnCellInit[ArrayAdd];
-               CellBuf[BufAdd + 2] = EdgesOnCellInit[ArrayAdd];
-            }
-         }
-      }
-      Err = MPI_Bcast(&CellBuf[0], BufSize, MPI_INT32_T, Task, Comm);
-      if (Err != 0) {
-         LOG_CRITICAL("rearrangeCellArrays: Error broadcasting cell buffer");
-         return Err;
+   // Fill a buffer with the local chunk of all three arrays in the
+   // initial linear distribution
+   for (int Cell = 0; Cell < NCellsChunk; ++Cell) {
+      for (int Edge = 0; Edge < MaxEdges; ++Edge) {
+         I4 BufAdd           = Cell * SizePerCell + Edge * 3;
+         I4 ArrayAdd         = Cell * MaxEdges + Edge;
+         CellBuf[BufAdd]     = CellsOnCellInit[ArrayAdd];
+         CellBuf[BufAdd + 1] = VerticesOnCellInit[ArrayAdd];
+         CellBuf[BufAdd + 2] = EdgesOnCellInit[ArrayAdd];
       }
+   }
 
-      // For each cell in the message buffer, look through the local
-      // cell IDs and if this task has the cell in either the owned or
-      // halo entries, fill the cell arrays. For edges, we prune the
-      // non-active edges and track the number of edges.
-      for (int Cell = 0; Cell < NCellsChunk; ++Cell) {
-
-         I4 GlobalID = Task * NCellsChunk + Cell + 1; // IDs are 1-based
-         // if NCellsGlobal did not divide evenly, the last task will
-         // have global IDs out of range so break out of loop in that case
-         if (GlobalID > NCellsGlobal)
-            break;
+   // Retrieve the buffer entries for all local (owned and halo) cells
+   // from the tasks that hold them in the linear distribution
+   std::vector<I4> CellList(CellIDH.data(), CellIDH.data() + NCellsAll);
+   std::vector<I4> CellData;
+   Err = fetchLinearRows(CellList, CellBuf, SizePerCell, NCellsChunk,
+                         CellData, Comm);
+   if (Err != 0) {
+      LOG_CRITICAL("rearrangeCellArrays: Error retrieving cell buffer");
+      return Err;
+   }
 
-         // Search through local cell list to determine if a match with
-         // the global ID
-         I4 LocCell = srchVector(CellIDH, GlobalID);
-         if (LocCell < NCellsAll) {
-
-            // Local cell needs the info so extract from the buffer
-            // into the local address. For edges, we only store the
-            // active edges and maintain a count of the edges.
-            I4 EdgeCount = 0;
-            for (int Edge = 0; Edge < MaxEdges; ++Edge) {
-               I4 BufAdd  = Cell * SizePerCell + Edge * 3;
-               I4 NbrCell = CellBuf[BufAdd];
-               I4 NbrVrtx = CellBuf[BufAdd + 1];
-               I4 NbrEdge = CellBuf[BufAdd + 2];
-               if (validCellID(NbrCell)) {
-                  CellsOnCellTmp(LocCell, Edge) = NbrCell;
-               } else {
-                  CellsOnCellTmp(LocCell, Edge) = NCellsGlobal + 1;
-               }
-               if (validVertexID(NbrVrtx)) {
-                  VerticesOnCellTmp(LocCell, Edge) = NbrVrtx;
-               } else {
-                  VerticesOnCellTmp(LocCell, Edge) = NVerticesGlobal + 1;
-               }
-               if (validEdgeID(NbrEdge)) {
-                  EdgesOnCellTmp(LocCell, EdgeCount) = NbrEdge;
-                  EdgeCount++;
-               }
-            }
-            NEdgesOnCellTmp(LocCell) = EdgeCount;
-         } // end if local cell
-      }    // end loop over chunk of global cells
-   }       // end loop over MPI tasks
+   // Extract the retrieved info into the local address. For edges, we
+   // prune the non-active edges and track the number of edges.
+   for (int LocCell = 0; LocCell < NCellsAll; ++LocCell) {
+      I4 EdgeCount = 0;
+      for (int Edge = 0; Edge < MaxEdges; ++Edge) {
+         I4 BufAdd  = LocCell * SizePerCell + Edge * 3;
+         I4 NbrCell = CellData[BufAdd];
+         I4 NbrVrtx = CellData[BufAdd + 1];
+         I4 NbrEdge = CellData[BufAdd + 2];
+         if (validCellID(NbrCell)) {
+            CellsOnCellTmp(LocCell, Edge) = NbrCell;
+         } else {
+            CellsOnCellTmp(LocCell, Edge) = NCellsGlobal + 1;
+         }
+         if (validVertexID(NbrVrtx)) {
+            VerticesOnCellTmp(LocCell, Edge) = NbrVrtx;
+         } else {
+            VerticesOnCellTmp(LocCell, Edge) = NVerticesGlobal + 1;
+         }
+         if (validEdgeID(NbrEdge)) {
+            EdgesOnCellTmp(LocCell, EdgeCount) = NbrEdge;
+            EdgeCount++;
+         }
+      }
+      NEdgesOnCellTmp(LocCell) = EdgeCount;
+   } // end loop over local cells
 
    // Copy to final location on host - wait to create device copies until
    // the entries are translated to local addresses rather than global IDs
@@ -1580,12 +2820,11 @@ int Decomp::rearrangeEdgeArrays(
 
    int Err = 0; // default return code
 
+   TimerScope FuncTimer("Decomp:rearrangeEdges");
+
    // Extract some MPI information
    MPI_Comm Comm = InEnv->getComm();
    I4 NumTasks   = InEnv->getNumTasks();
-   I4 MyTask     = InEnv->getMyTask();
-   I4 MasterTask = InEnv->getMasterTask();
-   bool IsMaster = InEnv->isMasterTask();
 
    // Define the chunk sizes for the initial linear distribution
    I4 NEdgesChunk = (NEdgesGlobal - 1) / NumTasks + 1;
@@ -1608,86 +2847,66 @@ int Decomp::rearrangeEdgeArrays(
    yakl::memset(VerticesOnEdgeTmp, NVerticesGlobal + 1);
    yakl::memset(NEdgesOnEdgeTmp, 0);
 
-   // Each task will broadcast the array chunks it owns in the initial linear
-   // distribution and all tasks will search that list and extract the
-   // entries it owns.
-   for (int Task = 0; Task < NumTasks; ++Task) {
-
-      // If it is this task's turn to send, fill the buffer with the local
-      // chunk of all three arrays.
-      if (MyTask == Task) { // Fill buffer with local chunk
-         for (int Edge = 0; Edge < NEdgesChunk; ++Edge) {
-            I4 BufAdd = Edge * SizePerEdge;
-            for (int Cell = 0; Cell < MaxCellsOnEdge; ++Cell) {
-               I4 ArrayAdd     = Edge * MaxCellsOnEdge + Cell;
-               EdgeBuf[BufAdd] = CellsOnEdgeInit[ArrayAdd];
-               ++BufAdd;
-            }
-            for (int Vrtx = 0; Vrtx < 2; ++Vrtx) {
-               I4 ArrayAdd     = Edge * 2 + Vrtx;
-               EdgeBuf[BufAdd] = VerticesOnEdgeInit[ArrayAdd];
-               ++BufAdd;
-            }
-            for (int NbrEdge = 0; NbrEdge < 2 * MaxEdges; ++NbrEdge) {
-               I4 ArrayAdd     = Edge * 2 * MaxEdges + NbrEdge;
-               EdgeBuf[BufAdd] = EdgesOnEdgeInit[ArrayAdd];
-               ++BufAdd;
-            }
-         }
+   // Fill a buffer with the local chunk of all three arrays in the
+   // initial linear distribution
+   for (int Edge = 0; Edge < NEdgesChunk; ++Edge) {
+      I4 BufAdd = Edge * SizePerEdge;
+      for (int Cell = 0; Cell < MaxCellsOnEdge; ++Cell) {
+         I4 ArrayAdd     = Edge * MaxCellsOnEdge + Cell;
+         EdgeBuf[BufAdd] = CellsOnEdgeInit[ArrayAdd];
+         ++BufAdd;
       }
-      Err = MPI_Bcast(&EdgeBuf[0], BufSize, MPI_INT32_T, Task, Comm);
-      if (Err != 0) {
-         LOG_CRITICAL("rearrangeEdgeArrays: Error broadcasting edge buffer");
-         return Err;
+      for (int Vrtx = 0; Vrtx < 2; ++Vrtx) {
+         I4 ArrayAdd     = Edge * 2 + Vrtx;
+         EdgeBuf[BufAdd] = VerticesOnEdgeInit[ArrayAdd];
+         ++BufAdd;
       }
+      for (int NbrEdge = 0; NbrEdge < 2 * MaxEdges; ++NbrEdge) {
+         I4 ArrayAdd     = Edge * 2 * MaxEdges + NbrEdge;
+         EdgeBuf[BufAdd] = EdgesOnEdgeInit[ArrayAdd];
+         ++BufAdd;
+      }
+   }
 
-      // For each edge in the message buffer, look through the local
-      // edge IDs and if this task has the edge in either the owned or
-      // halo entries, fill the edge arrays. For EdgesOnEdge, we prune the
-      // non-active edges and track the number of active entries.
-      for (int Edge = 0; Edge < NEdgesChunk; ++Edge) {
-
-         I4 GlobalID = Task * NEdgesChunk + Edge + 1; // IDs are 1-based
-         // if NEdgesGlobal did not divide evenly, the last task will
-         // have global IDs out of range so break out of loop in that case
-         if (GlobalID > NEdgesGlobal)
-            break;
+   // Retrieve the buffer entries for all local (owned and halo) edges
+   // from the tasks that hold them in the linear distribution
+   std::vector<I4> EdgeList(EdgeIDH.data(), EdgeIDH.data() + NEdgesAll);
+   std::vector<I4> EdgeData;
+   Err = fetchLinearRows(EdgeList, EdgeBuf, SizePerEdge, NEdgesChunk,
+                         EdgeData, Comm);
+   if (Err != 0) {
+      LOG_CRITICAL("rearrangeEdgeArrays: Error retrieving edge buffer");
+      return Err;
+   }
 
-         // Search through local edge list to determine if a match with
-         // the global ID
-         I4 LocEdge = srchVector(EdgeIDH, GlobalID);
-         if (LocEdge < NEdgesAll) {
-
-            // Local task owns this edge so extract the array info
-            // into the local address. For edges, we only store the
-            // active edges and maintain a count of the edges.
-            I4 BufAdd = Edge * SizePerEdge;
-            for (int Cell = 0; Cell < MaxCellsOnEdge; ++Cell) {
-               CellsOnEdgeTmp(LocEdge, Cell) = EdgeBuf[BufAdd];
-               ++BufAdd;
-            }
-            for (int Vrtx = 0; Vrtx < 2; ++Vrtx) {
-               VerticesOnEdgeTmp(LocEdge, Vrtx) = EdgeBuf[BufAdd];
-               ++BufAdd;
-            }
-            // In the EdgeOnEdge array, a zero entry must be kept in
-            // place but assigned the boundary value NEdgesGlobal+1
-            I4 EdgeCount = 0;
-            for (int NbrEdge = 0; NbrEdge < 2 * MaxEdges; ++NbrEdge) {
-               I4 EdgeID = EdgeBuf[BufAdd];
-               ++BufAdd;
-               if (EdgeID == 0) {
-                  EdgesOnEdgeTmp(LocEdge, EdgeCount) = NEdgesGlobal + 1;
-                  EdgeCount++;
-               } else if (validEdgeID(EdgeID)) {
-                  EdgesOnEdgeTmp(LocEdge, EdgeCount) = EdgeID;
-                  EdgeCount++;
-               }
-            }
-            NEdgesOnEdgeTmp(LocEdge) = EdgeCount;
-         } // end if local cell
-      }    // end loop over chunk of global cells
-   }       // end loop over MPI tasks
+   // Extract the retrieved info into the local address. For EdgesOnEdge,
+   // we prune the non-active edges and track the number of active entries.
+   for (int LocEdge = 0; LocEdge < NEdgesAll; ++LocEdge) {
+      I4 BufAdd = LocEdge * SizePerEdge;
+      for (int Cell = 0; Cell < MaxCellsOnEdge; ++Cell) {
+         CellsOnEdgeTmp(LocEdge, Cell) = EdgeData[BufAdd];
+         ++BufAdd;
+      }
+      for (int Vrtx = 0; Vrtx < 2; ++Vrtx) {
+         VerticesOnEdgeTmp(LocEdge, Vrtx) = EdgeData[BufAdd];
+         ++BufAdd;
+      }
+      // In the EdgeOnEdge array, a zero entry must be kept in
+      // place but assigned the boundary value NEdgesGlobal+1
+      I4 EdgeCount = 0;
+      for (int NbrEdge = 0; NbrEdge < 2 * MaxEdges; ++NbrEdge) {
+         I4 EdgeID = EdgeData[BufAdd];
+         ++BufAdd;
+         if (EdgeID == 0) {
+            EdgesOnEdgeTmp(LocEdge, EdgeCount) = NEdgesGlobal + 1;
+            EdgeCount++;
+         } else if (validEdgeID(EdgeID)) {
+            EdgesOnEdgeTmp(LocEdge, EdgeCount) = EdgeID;
+            EdgeCount++;
+         }
+      }
+      NEdgesOnEdgeTmp(LocEdge) = EdgeCount;
+   } // end loop over local edges
 
    // Copy to final location on host - wait to create device copies until
    // the entries are translated to local addresses rather than global IDs
@@ -1715,12 +2934,11 @@ int Decomp::rearrangeVertexArrays(
 
    int Err = 0; // default return code
 
+   TimerScope FuncTimer("Decomp:rearrangeVertices");
+
    // Extract some MPI information
    MPI_Comm Comm = InEnv->getComm();
    I4 NumTasks   = InEnv->getNumTasks();
-   I4 MyTask     = InEnv->getMyTask();
-   I4 MasterTask = InEnv->getMasterTask();
-   bool IsMaster = InEnv->isMasterTask();
 
    // Define the chunk sizes for the initial linear distribution
    I4 NVerticesChunk = (NVerticesGlobal - 1) / NumTasks + 1;
@@ -1739,64 +2957,45 @@ int Decomp::rearrangeVertexArrays(
    yakl::memset(CellsOnVertexTmp, NCellsGlobal + 1);
    yakl::memset(EdgesOnVertexTmp, NEdgesGlobal + 1);
 
-   // Each task will broadcast the array chunks it owns in the initial linear
-   // distribution and all tasks will search that list and extract the
-   // entries it owns.
-   for (int Task = 0; Task < NumTasks; ++Task) {
-
-      // If it is this task's turn to send, fill the buffer with the local
-      // chunk of both arrays.
-      if (MyTask == Task) { // Fill buffer with local chunk
-         for (int Vrtx = 0; Vrtx < NVerticesChunk; ++Vrtx) {
-            I4 BufAdd = Vrtx * SizePerVrtx;
-            for (int Cell = 0; Cell < VertexDegree; ++Cell) {
-               I4 ArrayAdd     = Vrtx * VertexDegree + Cell;
-               VrtxBuf[BufAdd] = CellsOnVertexInit[ArrayAdd];
-               ++BufAdd;
-            }
-            for (int Edge = 0; Edge < VertexDegree; ++Edge) {
-               I4 ArrayAdd     = Vrtx * VertexDegree + Edge;
-               VrtxBuf[BufAdd] = EdgesOnVertexInit[ArrayAdd];
-               ++BufAdd;
-            }
-         }
+   // Fill a buffer with the local chunk of both arrays in the
+   // initial linear distribution
+   for (int Vrtx = 0; Vrtx < NVerticesChunk; ++Vrtx) {
+      I4 BufAdd = Vrtx * SizePerVrtx;
+      for (int Cell = 0; Cell < VertexDegree; ++Cell) {
+         I4 ArrayAdd     = Vrtx * VertexDegree + Cell;
+         VrtxBuf[BufAdd] = CellsOnVertexInit[ArrayAdd];
+         ++BufAdd;
       }
-      Err = MPI_Bcast(&VrtxBuf[0], BufSize, MPI_INT32_T, Task, Comm);
-      if (Err != 0) {
-         LOG_CRITICAL("rearrangeVertexArrays: Error broadcasting buffer");
-         return Err;
+      for (int Edge = 0; Edge < VertexDegree; ++Edge) {
+         I4 ArrayAdd     = Vrtx * VertexDegree + Edge;
+         VrtxBuf[BufAdd] = EdgesOnVertexInit[ArrayAdd];
+         ++BufAdd;
       }
+   }
 
-      // For each vertex in the message buffer, look through the local
-      // vertex IDs and if this task has the vertex in either the owned or
-      // halo entries, fill the vertex arrays.
-      for (int Vrtx = 0; Vrtx < NVerticesChunk; ++Vrtx) {
-
-         I4 GlobalID = Task * NVerticesChunk + Vrtx + 1; // IDs are 1-based
-         // if NVerticesGlobal did not divide evenly, the last task will
-         // have global IDs out of range so break out of loop in that case
-         if (GlobalID > NVerticesGlobal)
-            break;
+   // Retrieve the buffer entries for all local (owned and halo) vertices
+   // from the tasks that hold them in the linear distribution
+   std::vector<I4> VrtxList(VertexIDH.data(), VertexIDH.data() + NVerticesAll);
+   std::vector<I4> VrtxData;
+   Err = fetchLinearRows(VrtxList, VrtxBuf, SizePerVrtx, NVerticesChunk,
+                         VrtxData, Comm);
+   if (Err != 0) {
+      LOG_CRITICAL("rearrangeVertexArrays: Error retrieving vertex buffer");
+      return Err;
+   }
 
-         // Search through local vertex list to determine if a match with
-         // the global ID
-         I4 LocVrtx = srchVector(VertexIDH, GlobalID);
-         if (LocVrtx < NVerticesAll) {
-
-            // Local task owns this vertex so extract the array info
-            // into the local address.
-            I4 BufAdd = Vrtx * SizePerVrtx;
-            for (int Cell = 0; Cell < VertexDegree; ++Cell) {
-               CellsOnVertexTmp(LocVrtx, Cell) = VrtxBuf[BufAdd];
-               ++BufAdd;
-            }
-            for (int Edge = 0; Edge < VertexDegree; ++Edge) {
-               EdgesOnVertexTmp(LocVrtx, Edge) = VrtxBuf[BufAdd];
-               ++BufAdd;
-            }
-         } // end if local cell
-      }    // end loop over chunk of global cells
-   }       // end loop over MPI tasks
+   // Extract the retrieved info into the local address
+   for (int LocVrtx = 0; LocVrtx < NVerticesAll; ++LocVrtx) {
+      I4 BufAdd = LocVrtx * SizePerVrtx;
+      for (int Cell = 0; Cell < VertexDegree; ++Cell) {
+         CellsOnVertexTmp(LocVrtx, Cell) = VrtxData[BufAdd];
+         ++BufAdd;
+      }
+      for (int Edge = 0; Edge < VertexDegree; ++Edge) {
+         EdgesOnVertexTmp(LocVrtx, Edge) = VrtxData[BufAdd];
+         ++BufAdd;
+      }
+   } // end loop over local vertices
 
    // Copy to final location on host - wait to create device copies until
    // the entries are translated to local addresses rather than global IDs
@@ -1819,10 +3018,17 @@ PartMethod getPartMethodFromStr(const std::string &InMethod) {
                   [](unsigned char c) { return std::tolower(c); });
 
    // Check supported methods and return appropriate enum
-   // Currently, only the METIS/ParMETIS KWay option is supported
+   // Currently, only the METIS and ParMETIS KWay options are supported,
+   // with an option to partition METIS KWay by node
    if (MethodComp == "metiskway") {
       return PartMethodMetisKWay;
 
+   } else if (MethodComp == "parmetiskway") {
+      return PartMethodParMetisKWay;
+
+   } else if (MethodComp == "metiskwaynode") {
+      return PartMethodMetisKWayNode;
+
    } else {
       return PartMethodUnknown;
 
@@ -1830,6 +3036,55 @@ PartMethod getPartMethodFromStr(const std::string &InMethod) {
 
 } // End getPartMethodFromStr
 
+//------------------------------------------------------------------------------
+// Utility routine to convert a cell ordering string into CellOrder enum
+
+CellOrder getCellOrderFromStr(const std::string &InOrder) {
+
+   // convert string to lower case for easier equivalence checking
+   std::string OrderComp = InOrder;
+   std::transform(OrderComp.begin(), OrderComp.end(), OrderComp.begin(),
+                  [](unsigned char c) { return std::tolower(c); });
+
+   if (OrderComp == "none") {
+      return CellOrderNone;
+
+   } else if (OrderComp == "rcm") {
+      return CellOrderRCM;
+
+   } else {
+      return CellOrderUnknown;
+
+   } // end branch on ordering string
+
+} // End getCellOrderFromStr
+
+//------------------------------------------------------------------------------
+// Utility routine to convert a partition weighting string into PartWeight enum
+
+PartWeight getPartWeightFromStr(const std::string &InWeight) {
+
+   // convert string to lower case for easier equivalence checking
+   std::string WeightComp = InWeight;
+   std::transform(WeightComp.begin(), WeightComp.end(), WeightComp.begin(),
+                  [](unsigned char c) { return std::tolower(c); });
+
+   if (WeightComp == "none") {
+      return PartWeightNone;
+
+   } else if (WeightComp == "levels") {
+      return PartWeightLevels;
+
+   } else if (WeightComp == "levelsmemory") {
+      return PartWeightLevelsMemory;
+
+   } else {
+      return PartWeightUnknown;
+
+   } // end branch on weighting string
+
+} // End getPartWeightFromStr
+
 //------------------------------------------------------------------------------
 // end Decomp methods
 
@@ -25,6 +25,7 @@
 #include "parmetis.h"
 
 #include <string>
+#include <vector>
 
 namespace OMEGA {
 
@@ -34,9 +35,11 @@ namespace OMEGA {
 
 /// Supported partitioning methods
 enum PartMethod {
-   PartMethodUnknown,   ///< Unknown or undefined method
-   PartMethodMetisKWay, ///< Metis K-way partitioning (default)
-   PartMethodMetisRB    ///< Metis recursive bisection (not yet supported)
+   PartMethodUnknown,      ///< Unknown or undefined method
+   PartMethodMetisKWay,    ///< Metis K-way partitioning (default)
+   PartMethodMetisRB,      ///< Metis recursive bisection (not yet supported)
+   PartMethodParMetisKWay, ///< ParMetis K-way on the distributed graph
+   PartMethodMetisKWayNode ///< Metis K-way across nodes, then within nodes
 };
 
 /// Translates an input string for partition method option to the
@@ -45,6 +48,50 @@ PartMethod getPartMethodFromStr(
     const std::string &InMethod ///< [in] choice of partition method
 );
 
+/// Supported orderings of the owned cells on each task
+enum CellOrder {
+   CellOrderUnknown, ///< Unknown or undefined ordering
+   CellOrderNone,    ///< Owned cells ordered by global ID (default)
+   CellOrderRCM      ///< Reverse Cuthill-McKee ordering for locality
+};
+
+/// Translates an input string for the cell ordering option to the
+/// enum for later use
+CellOrder getCellOrderFromStr(
+    const std::string &InOrder ///< [in] choice of cell ordering
+);
+
+/// Supported weightings of the partition. Weighting by levels uses the
+/// number of active levels in each cell (maxLevelCell) as the cell weight
+/// and the levels shared across each cell edge as the edge weight. The
+/// LevelsMemory option adds a second balancing constraint on the number
+/// of cells to also balance memory use.
+enum PartWeight {
+   PartWeightUnknown,     ///< Unknown or undefined weighting
+   PartWeightNone,        ///< All cells and edges have equal weight (default)
+   PartWeightLevels,      ///< Weight by active levels
+   PartWeightLevelsMemory ///< Weight by levels and balance cell count
+};
+
+/// Translates an input string for the partition weighting option to the
+/// enum for later use
+PartWeight getPartWeightFromStr(
+    const std::string &InWeight ///< [in] choice of partition weighting
+);
+
+/// Optional settings for creating a decomposition. The defaults compute the
+/// decomposition from the mesh file without a cache, keep the owned cells in
+/// global ID order, read the mesh with the default IO layout and do not
+/// weight the partition. Members can be set individually, eg:
+///    DecompOptions Options;
+///    Options.Order = CellOrderRCM;
+struct DecompOptions {
+   std::string CacheFileName;          ///< decomp cache file ("" for no cache)
+   CellOrder Order   = CellOrderNone;  ///< ordering of owned cells
+   I4 MeshIOTasks    = 0;              ///< IO tasks for mesh read (0 default)
+   PartWeight Weight = PartWeightNone; ///< weighting of partition
+};
+
 /// The Decomp class creates and maintains most of the information related
 /// to the mesh index space and its distribution across partitions or processors
 /// in a parallel domain decomposition. This information includes the location
@@ -63,15 +110,71 @@ class Decomp {
    /// map paired with a name for later retrieval.
    static std::map<std::string, Decomp> AllDecomps;
 
+   /// Reads the mesh file, partitions the cells using the requested method
+   /// and distributes all of the cell, edge and vertex index arrays. On
+   /// return, all host arrays are defined and contain local addresses.
+   int partitionMesh(
+       const MachEnv *InEnv,            ///< [in] MachEnv with MPI info
+       PartMethod Method,               ///< [in] method for partitioning
+       const std::string &MeshFileName, ///< [in] name of file with mesh info
+       CellOrder Order,                 ///< [in] ordering of owned cells
+       I4 MeshIOTasks, ///< [in] IO tasks for reading mesh (0 for default)
+       PartWeight Weight ///< [in] weighting of partition
+   );
+
+   /// Renumbers the owned cells on each task using the requested ordering
+   /// to improve memory locality of neighbor accesses. Halo cells retain
+   /// their ordering and the CellLoc of halo cells is updated to the new
+   /// local addresses on the owning tasks.
+   int reorderCells(const MachEnv *InEnv, ///< [in] MachEnv with MPI info
+                    CellOrder Order       ///< [in] ordering of owned cells
+   );
+
+   /// Writes the sizes and host index arrays for this decomposition to a
+   /// single cache file using MPI-IO. The file header contains the cache
+   /// key so that later runs can verify the cache matches their mesh,
+   /// partition and halo width.
+   int writeCache(
+       const MachEnv *InEnv,             ///< [in] MachEnv with MPI info
+       const std::string &CacheFileName, ///< [in] name of cache file
+       const std::vector<I8> &CacheKey   ///< [in] key for this decomp
+   );
+
+   /// Reads the sizes and host index arrays for this decomposition from a
+   /// cache file. Returns non-zero if the file is missing, does not match
+   /// the input key or could not be read.
+   int readCache(
+       const MachEnv *InEnv,             ///< [in] MachEnv with MPI info
+       const std::string &CacheFileName, ///< [in] name of cache file
+       const std::vector<I8> &CacheKey   ///< [in] key for this decomp
+   );
+
    /// Partition cells by calling the METIS/ParMETIS KWay routine
    /// It starts with the CellsOnCell array from the input mesh file
    /// distributed across tasks in linear contiguous chunks
    /// On output, it has defined all the NCells sizes (NCellsOwned,
    /// NCellsHalo array, NCellsAll and NCellsSize) and the final CellID
-   /// and CellLoc arrays
+   /// and CellLoc arrays. If ByNode is true, the cells are first
+   /// partitioned across the nodes of the MachEnv and each node partition
+   /// is then divided among the tasks on that node.
    int partCellsKWay(
-       const MachEnv *InEnv,                  ///< [in] MachEnv with MPI info
-       const std::vector<I4> &CellsOnCellInit ///< [in] cell nbrs in init dstrb
+       const MachEnv *InEnv,                   ///< [in] MachEnv with MPI info
+       const std::vector<I4> &CellsOnCellInit, ///< [in] cell nbrs in init dstrb
+       PartWeight Weight,                      ///< [in] partition weighting
+       const std::vector<I4> &LevelsInit,      ///< [in] levels in init dstrb
+       bool ByNode ///< [in] partition across nodes, then within each node
+   );
+
+   /// Partition cells by calling the ParMETIS KWay routine directly on
+   /// the CellsOnCell array in its initial linear distribution so that no
+   /// task holds more than its own portion of the adjacency graph.
+   /// Produces the same NCells sizes and CellID, CellLoc arrays as
+   /// partCellsKWay.
+   int partCellsParKWay(
+       const MachEnv *InEnv,                   ///< [in] MachEnv with MPI info
+       const std::vector<I4> &CellsOnCellInit, ///< [in] cell nbrs in init dstrb
+       PartWeight Weight,                      ///< [in] partition weighting
+       const std::vector<I4> &LevelsInit       ///< [in] levels in init dstrb
    );
 
    /// Partition the edges given the cell partition and edge connectivity
@@ -220,13 +323,21 @@ class Decomp {
    static int init();
 
    /// Construct a new decomposition across an input MachEnv with
-   /// NPart partitions of a mesh that is read from a mesh file.
+   /// NPart partitions of a mesh that is read from a mesh file. If the
+   /// options supply a cache file name, the decomposition is read from that
+   /// file when it was created with the same mesh contents, number of
+   /// partitions and tasks, partition method, options and halo width.
+   /// Otherwise the decomposition is computed and then saved to the cache
+   /// file. The options can also renumber the owned cells for better memory
+   /// locality, read the mesh with a dedicated IO task layout and weight the
+   /// partition by the active levels in each cell (see DecompOptions).
    Decomp(const std::string &Name, ///< [in] Name for new decomposition
           const MachEnv *InEnv,    ///< [in] MachEnv for the new partition
           I4 NParts,               ///< [in] num of partitions for new decomp
           PartMethod Method,       ///< [in] method for partitioning
           I4 InHaloWidth,          ///< [in] width of halo in new decomp
-          const std::string &MeshFileName ///< [in] name of file with mesh info
+          const std::string &MeshFileName, ///< [in] file with mesh info
+          const DecompOptions &Options = DecompOptions() ///< [in] options
    );
 
    /// Destructor - deallocates all memory and deletes a Decomp.
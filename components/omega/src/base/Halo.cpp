@@ -5,14 +5,22 @@
 // supported YAKL array types for a given machine environment (MachEnv)
 // and parallel decomposition (Decomp). These exchanges are carried out
 // via non-blocking MPI library routines. Constructor and private member
-// functions are defined here. The Halo class public member function
-// exchangeFullArrayHalo which is called by the user to perform halo
-// exchanges on a given array is a template function and thus is defined
-// in the associated header file, Halo.h.
+// functions are defined here, along with the group exchange functions
+// startExchange, finishExchange and exchangeGroupHalo, which exchange several
+// arrays with a single message per neighbor. The Halo class public member
+// functions exchangeFullArrayHalo and startExchange which are called by the
+// user to perform halo exchanges on a given array are template functions and
+// thus are defined in the associated header file, Halo.h, as are the
+// packBuffer and unpackBuffer templates which copy the halo elements of an
+// array of any supported type into or out of the byte buffers in its native
+// type. Both host (ArrayHost*) and device (Array*) YAKL arrays are supported,
+// device arrays are packed and unpacked with parallel YAKL kernels so the
+// array never leaves the device.
 //
 //===----------------------------------------------------------------------===//
 
 #include "Halo.h"
+#include "Timer.h"
 #include "mpi.h"
 #include <algorithm>
 #include <numeric>
@@ -37,6 +45,49 @@ I4 searchVector(const std::vector<I4> &InVector, // vector to search
 
 } // end function searchVector (std::vector)
 
+// -----------------------------------------------------------------------------
+// Local routine that (re)allocates a device buffer if its current size
+// differs from the requested size. A zero size leaves the buffer untouched.
+
+void resizeDeviceBuffer(Array1DByte &Buffer, // device buffer to resize
+                        I4 BufferSize        // required number of bytes
+) {
+
+   if (BufferSize > 0 and
+       (not Buffer.initialized() or Buffer.totElems() != BufferSize))
+      Buffer = Array1DByte("HaloBuffer", BufferSize);
+
+} // end function resizeDeviceBuffer
+
+// -----------------------------------------------------------------------------
+// Local routine used to free the distributed graph communicator shared by
+// copies of a Halo once the last copy is destroyed. The communicator can only
+// be freed while MPI is active.
+
+void freeComm(MPI_Comm *Comm // communicator to free
+) {
+
+   I4 Finalized{0};
+   MPI_Finalized(&Finalized);
+   if (not Finalized and *Comm != MPI_COMM_NULL)
+      MPI_Comm_free(Comm);
+   delete Comm;
+
+} // end function freeComm
+
+// -----------------------------------------------------------------------------
+// Local routine that returns the number of bytes of a halo buffer occupied by
+// an array, rounded up to a multiple of the largest supported element size so
+// that the next array packed into the buffer is properly aligned for its type
+
+I4 alignedBufferSize(I4 NBytes // number of bytes of packed array values
+) {
+
+   constexpr I4 Align = sizeof(I8);
+   return (NBytes + Align - 1) / Align * Align;
+
+} // end function alignedBufferSize
+
 // -----------------------------------------------------------------------------
 // Construct a new ExchList based on input 2D vector which contains a list
 // of indices sorted by halo layer
@@ -69,11 +120,40 @@ Halo::ExchList::ExchList(
       Offsets[I + 1] = Offsets[I] + NList[I];
    }
 
+   // Collapse the indices along the halo layer dimension and copy them to
+   // the device for use in the pack and unpack kernels of device arrays.
+   // Since the halo layers are stored contiguously in the buffers, the
+   // position in the collapsed list is also the position in the buffer.
+   if (NTot > 0) {
+      ArrayHost1DI4 IndH("IndH", NTot);
+      for (int I = 0; I < HaloLayers; ++I) {
+         for (int J = 0; J < NList[I]; ++J) {
+            IndH(Offsets[I] + J) = Ind[I][J];
+         }
+      }
+      IndDev = IndH.createDeviceCopy();
+   }
+
 } // end ExchList constructor
 
 // Empty constructor for ExchList class
 Halo::ExchList::ExchList() = default;
 
+// -----------------------------------------------------------------------------
+// Return the number of elements in the first NLayers halo layers of the list
+
+I4 Halo::ExchList::numElems(I4 NLayers // number of halo layers
+) const {
+
+   if (NLayers <= 0 or NList.empty())
+      return 0;
+   if (NLayers >= static_cast<I4>(NList.size()))
+      return NTot;
+
+   return Offsets[NLayers - 1] + NList[NLayers - 1];
+
+} // end numElems
+
 // -----------------------------------------------------------------------------
 // Construct a new Neighbor given the send and receive lists for each index
 // space of the neighboring task identified by NghbrID
@@ -103,12 +183,52 @@ Halo::Neighbor::Neighbor(
 } // end Neighbor constructor
 
 // -----------------------------------------------------------------------------
-// Construct a Halo for the input MachEnv and Decomp.
+// Destroy an ExchangePlan, freeing its persistent MPI requests and its shared
+// memory window. Plans held by
+// a Halo that outlives MPI_Finalize cannot free their requests, which are
+// released by MPI itself at that point.
+
+Halo::ExchangePlan::~ExchangePlan() {
+
+   I4 Finalized{0};
+   MPI_Finalized(&Finalized);
+   if (Finalized)
+      return;
 
-Halo::Halo(const MachEnv *InEnv, const Decomp *InDecomp) {
+   for (MPI_Request &Req : RecvReqs) {
+      if (Req != MPI_REQUEST_NULL)
+         MPI_Request_free(&Req);
+   }
+   for (MPI_Request &Req : SendReqs) {
+      if (Req != MPI_REQUEST_NULL)
+         MPI_Request_free(&Req);
+   }
+
+   // Freeing the window is collective over the node, so the last copies
+   // of a Halo must be destroyed on all tasks of a node together
+   if (Win != MPI_WIN_NULL) {
+      MPI_Wait(&NodeReadyReq, MPI_STATUS_IGNORE);
+      MPI_Wait(&NodeDoneReq, MPI_STATUS_IGNORE);
+      MPI_Win_unlock_all(Win);
+      MPI_Win_free(&Win);
+   }
+
+} // end ExchangePlan destructor
+
+// -----------------------------------------------------------------------------
+// Construct a Halo for the input MachEnv and Decomp, which exchanges halos
+// using the input communication backend InBackend.
+
+Halo::Halo(const MachEnv *InEnv,   // machine environment
+           const Decomp *InDecomp, // parallel decomposition
+           HaloBackend InBackend   // communication backend for exchanges
+) {
 
    I4 IErr{0}; // error code
 
+   // Set the communication backend
+   Backend = InBackend;
+
    // Set pointer for the Decomp
    MyDecomp = InDecomp;
 
@@ -128,6 +248,11 @@ Halo::Halo(const MachEnv *InEnv, const Decomp *InDecomp) {
    std::vector<std::vector<std::vector<I4>>> RecvVrtxLists;
    std::vector<std::vector<std::vector<I4>>> SendVrtxLists;
 
+   // Find the neighboring tasks for all index spaces
+   IErr = findNeighbors();
+   if (IErr != 0)
+      LOG_ERROR("Halo: Error finding neighboring tasks");
+
    // Generate the exchange lists for each neighboring task in each index space
    IErr = generateExchangeLists(SendCellLists, RecvCellLists, OnCell);
    if (IErr != 0)
@@ -147,8 +272,136 @@ Halo::Halo(const MachEnv *InEnv, const Decomp *InDecomp) {
                                    NeighborList[INghbr]));
    }
 
+   // For the NeighborCollective backend, create a distributed graph
+   // communicator with the neighboring tasks as both sources and
+   // destinations, in the order of NeighborList. Task ranks are not
+   // reordered so the exchange lists remain valid.
+   if (Backend == NeighborCollective) {
+      MPI_Comm NewComm{MPI_COMM_NULL};
+      IErr = MPI_Dist_graph_create_adjacent(
+          MyComm, NNghbr, NeighborList.data(), MPI_UNWEIGHTED, NNghbr,
+          NeighborList.data(), MPI_UNWEIGHTED, MPI_INFO_NULL, 0, &NewComm);
+      if (IErr != MPI_SUCCESS)
+         LOG_ERROR("Halo: Error creating distributed graph communicator");
+      GraphComm = std::shared_ptr<MPI_Comm>(new MPI_Comm(NewComm), freeComm);
+   }
+
+   // For the SharedMemory backend, duplicate the node communicator of the
+   // MachEnv and find the task ID within the node of each neighboring task
+   // on the local node. Other neighbors are exchanged with MPI messages.
+   NeighborNodeTask.assign(NNghbr, -1);
+   if (Backend == SharedMemory) {
+      MPI_Comm NewComm{MPI_COMM_NULL};
+      IErr = MPI_Comm_dup(InEnv->getNodeComm(), &NewComm);
+      if (IErr != MPI_SUCCESS)
+         LOG_ERROR("Halo: Error duplicating node communicator");
+      NodeComm = std::shared_ptr<MPI_Comm>(new MPI_Comm(NewComm), freeComm);
+
+      MPI_Group Group, NodeGroup;
+      MPI_Comm_group(MyComm, &Group);
+      MPI_Comm_group(NewComm, &NodeGroup);
+      MPI_Group_translate_ranks(Group, NNghbr, NeighborList.data(), NodeGroup,
+                                NeighborNodeTask.data());
+      MPI_Group_free(&Group);
+      MPI_Group_free(&NodeGroup);
+      for (I4 &NodeTask : NeighborNodeTask) {
+         if (NodeTask == MPI_UNDEFINED)
+            NodeTask = -1;
+      }
+   }
+
 } // end Halo constructor
 
+// -----------------------------------------------------------------------------
+// Determine the neighboring tasks of the local task. The owners of the halo
+// elements in every index space are collected first, cells before edges and
+// vertices. The outer edge and vertex halo layers may be owned by tasks that
+// own no halo cells, and a task may need locally owned elements without
+// owning any local halo element, so the tasks that need locally owned
+// elements are also found. These are found with a nonblocking consensus:
+// each task sends an empty synchronous message to every owner it needs and
+// receives messages until a nonblocking barrier, entered once all of its
+// own messages have been received, completes on all tasks. Only neighbors
+// are contacted, so the cost does not grow with the number of tasks.
+
+int Halo::findNeighbors() {
+
+   I4 IErr{0}; // error code
+
+   // Add the owners of local halo elements to NeighborList in the order they
+   // are found
+   auto addOwners = [&](I4 NOwned, I4 NAll, const ArrayHost2DI4 &Loc) {
+      for (int Idx = NOwned; Idx < NAll; ++Idx) {
+         I4 Owner = Loc(Idx, 0);
+         if (Owner >= 0 and Owner != MyTask and
+             std::find(NeighborList.begin(), NeighborList.end(), Owner) ==
+                 NeighborList.end())
+            NeighborList.push_back(Owner);
+      }
+   };
+   addOwners(MyDecomp->NCellsOwned, MyDecomp->NCellsAll, MyDecomp->CellLocH);
+   addOwners(MyDecomp->NEdgesOwned, MyDecomp->NEdgesAll, MyDecomp->EdgeLocH);
+   addOwners(MyDecomp->NVerticesOwned, MyDecomp->NVerticesAll,
+             MyDecomp->VertexLocH);
+
+   // Send an empty synchronous message to each owner. The request array
+   // has at least one entry so it is never null.
+   constexpr I4 FindTag = 2; // tag distinct from other halo messages
+   I4 NNeedFrom         = NeighborList.size();
+   std::vector<MPI_Request> SendReqs(std::max(NNeedFrom, 1), MPI_REQUEST_NULL);
+   for (int INghbr = 0; INghbr < NNeedFrom; ++INghbr) {
+      IErr = MPI_Issend(nullptr, 0, MPI_INT, NeighborList[INghbr], FindTag,
+                        MyComm, &SendReqs[INghbr]);
+      if (IErr != MPI_SUCCESS) {
+         LOG_ERROR("MPI error {} on task {} sending to task {} to find halo "
+                   "neighbors",
+                   IErr, MyTask, NeighborList[INghbr]);
+         return -1;
+      }
+   }
+
+   // Receive the messages from the tasks that need local elements until
+   // every task has had all of its messages received
+   std::vector<I4> NeedTasks;
+   MPI_Request BarrierReq{MPI_REQUEST_NULL};
+   bool BarrierStarted{false};
+   I4 Done{0};
+   while (not Done) {
+      I4 Arrived{0};
+      MPI_Status Status;
+      MPI_Iprobe(MPI_ANY_SOURCE, FindTag, MyComm, &Arrived, &Status);
+      if (Arrived) {
+         MPI_Recv(nullptr, 0, MPI_INT, Status.MPI_SOURCE, FindTag, MyComm,
+                  MPI_STATUS_IGNORE);
+         NeedTasks.push_back(Status.MPI_SOURCE);
+      }
+      if (BarrierStarted) {
+         MPI_Test(&BarrierReq, &Done, MPI_STATUS_IGNORE);
+      } else {
+         I4 AllSent{0};
+         MPI_Testall(NNeedFrom, SendReqs.data(), &AllSent,
+                     MPI_STATUSES_IGNORE);
+         if (AllSent) {
+            MPI_Ibarrier(MyComm, &BarrierReq);
+            BarrierStarted = true;
+         }
+      }
+   }
+
+   // Add the tasks that need local elements that are not already in
+   // NeighborList in task order
+   std::sort(NeedTasks.begin(), NeedTasks.end());
+   for (I4 Task : NeedTasks) {
+      if (std::find(NeighborList.begin(), NeighborList.end(), Task) ==
+          NeighborList.end())
+         NeighborList.push_back(Task);
+   }
+
+   NNghbr = NeighborList.size();
+
+   return 0;
+} // end findNeighbors
+
 // -----------------------------------------------------------------------------
 // Generate the lists of indices that are used to construct the ExchList
 // objects of the input index space for each Neighbor, and save the lists in
@@ -170,9 +423,6 @@ int Halo::generateExchangeLists(
    ArrayHost1DI4 NHaloPtr;
    ArrayHost2DI4 LocPtr;
 
-   // Logical flag to check if this is the first time the function is called
-   bool First{false};
-
    // Fetch the proper info for this index space
    switch (IndexSpace) {
    case OnCell:
@@ -181,7 +431,6 @@ int Halo::generateExchangeLists(
       NHaloPtr  = MyDecomp->NCellsHaloH;
       LocPtr    = MyDecomp->CellLocH;
       NumLayers = HaloWidth;
-      First     = true;
 
       break;
    case OnEdge:
@@ -211,40 +460,15 @@ int Halo::generateExchangeLists(
       HaloBnds.push_back(*NAllPtr);
 
    // Determine the number of halo elements owned by each neighbor in each halo
-   // layer. If this is the first time the function is called, also determine
-   // the neighboring task IDs, save them in NeighborList, and save the number
-   // of neighboring tasks in NNghbr.
-   std::vector<std::vector<I4>> NumNghbrHalo;
-
-   if (First) {
-      for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-         for (int Idx = HaloBnds[ILayer]; Idx < HaloBnds[ILayer + 1]; ++Idx) {
-            I4 NewVal = LocPtr(Idx, 0);
-            auto it =
-                std::find(NeighborList.begin(), NeighborList.end(), NewVal);
-            if (it == NeighborList.end()) {
-               std::vector<I4> TmpVec(NumLayers, 0);
-               ++TmpVec[ILayer];
-               NeighborList.push_back(NewVal);
-               NumNghbrHalo.push_back(TmpVec);
-            } else {
-               I4 INghbr = std::distance(NeighborList.begin(), it);
-               ++NumNghbrHalo[INghbr][ILayer];
-            }
-         }
-      }
-      NNghbr = NeighborList.size();
-   } else {
-      std::vector<I4> TmpVec(NumLayers, 0);
-      for (int INghbr = 0; INghbr < NNghbr; ++INghbr)
-         NumNghbrHalo.push_back(TmpVec);
+   // layer. The neighboring task IDs have already been saved in NeighborList
+   // by findNeighbors.
+   std::vector<std::vector<I4>> NumNghbrHalo(NNghbr,
+                                             std::vector<I4>(NumLayers, 0));
 
-      for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-         for (int Idx = HaloBnds[ILayer]; Idx < HaloBnds[ILayer + 1]; ++Idx) {
-            I4 NewVal = LocPtr(Idx, 0);
-            I4 INghbr = searchVector(NeighborList, NewVal);
-            ++NumNghbrHalo[INghbr][ILayer];
-         }
+   for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
+      for (int Idx = HaloBnds[ILayer]; Idx < HaloBnds[ILayer + 1]; ++Idx) {
+         I4 INghbr = searchVector(NeighborList, LocPtr(Idx, 0));
+         ++NumNghbrHalo[INghbr][ILayer];
       }
    }
 
@@ -353,7 +577,7 @@ int Halo::exchangeVectorInt(
 
    for (int INghbr = 0; INghbr < NNghbr; ++INghbr) {
       I4 DimLen       = SendVec[INghbr].size();
-      SendErr[INghbr] = MPI_Send(&SendVec[INghbr][0], DimLen, MPI_INT,
+      SendErr[INghbr] = MPI_Send(SendVec[INghbr].data(), DimLen, MPI_INT,
                                  NeighborList[INghbr], 0, MyComm);
       if (SendErr[INghbr] != 0) {
          LOG_ERROR("MPI error {} on task {} send to task {}", SendErr[INghbr],
@@ -364,9 +588,9 @@ int Halo::exchangeVectorInt(
 
    for (int INghbr = 0; INghbr < NNghbr; ++INghbr) {
       I4 DimLen = RecvVec[INghbr].size();
-      RecvErr[INghbr] =
-          MPI_Recv(&RecvVec[INghbr][0], DimLen, MPI_INT, NeighborList[INghbr],
-                   0, MyComm, MPI_STATUS_IGNORE);
+      RecvErr[INghbr] = MPI_Recv(RecvVec[INghbr].data(), DimLen, MPI_INT,
+                                 NeighborList[INghbr], 0, MyComm,
+                                 MPI_STATUS_IGNORE);
       if (RecvErr[INghbr] != 0) {
          LOG_ERROR("MPI error {} on task {} receive from task {}",
                    RecvErr[INghbr], MyTask, NeighborList[INghbr]);
@@ -378,1052 +602,641 @@ int Halo::exchangeVectorInt(
 } // end exchangeVectorInt
 
 // -----------------------------------------------------------------------------
-// Allocate RecvBuffer and prepare for MPI communication by calling MPI_Irecv
-// for each Neighbor
-
-int Halo::startReceives() {
-
-   // Initialize vector to track MPI errors for each MPI_Irecv
-   std::vector<I4> IErr(NNghbr, 0);
+// Set the index space, number of halo layers, array size at each mesh element
+// and vertical range of the current exchange to those of the input registered
+// array
+
+void Halo::setCurrentField(MeshElement InElem, // index space of the array
+                           I4 InTotSize,       // array size at each element
+                           I4 InExchSize,      // values exchanged per element
+                           I4 InLayers,        // halo layers, zero for all
+                           I4 InVertBegin      // first vertical index
+) {
 
-   I4 Err{0}; // Error code to return
+   MyElem     = InElem;
+   TotSize    = InTotSize;
+   ExchSize   = InExchSize;
+   VertOffset = InVertBegin;
 
-   for (int INghbr = 0; INghbr < NNghbr; ++INghbr) {
-      MyNeighbor    = &Neighbors[INghbr];
-      I4 BufferSize = TotSize * MyNeighbor->RecvLists[MyElem].NTot;
-      MyNeighbor->RecvBuffer.resize(BufferSize);
-      IErr[INghbr] =
-          MPI_Irecv(&MyNeighbor->RecvBuffer[0], BufferSize, MPI_RealKind,
-                    MyNeighbor->TaskID, MPI_ANY_TAG, MyComm, &MyNeighbor->RReq);
-      if (IErr[INghbr] != 0) {
-         LOG_ERROR("MPI error {} on task {} receive from task {}", IErr[INghbr],
-                   MyTask, MyNeighbor->TaskID);
-         Err = -1;
-      }
+   // For cell-based quantities, the number of halo layers equals HaloWidth,
+   // edge- and vertex-based quantities have an extra layer.
+   if (MyElem == OnCell) {
+      NumLayers = HaloWidth;
+   } else {
+      NumLayers = HaloWidth + 1;
    }
 
-   return Err;
-} // end startReceives
+   // Only exchange the requested number of inner halo layers
+   if (InLayers > 0 and InLayers < NumLayers)
+      NumLayers = InLayers;
+
+} // end setCurrentField
 
 // -----------------------------------------------------------------------------
-// Initiate MPI communication by calling MPI_Isend for each Neighbor to send
-// the packed buffers to each task
+// Return the number of bytes in the buffer for the current array and the input
+// exchange list, padded so the next array in the buffer is aligned
 
-int Halo::startSends() {
+I4 Halo::currentBufferSize(I4 TypeSize,         // size in bytes of each value
+                           const ExchList &List // exchange list for Neighbor
+) const {
 
-   // Initialize vector to track MPI errors for each MPI_Isend
-   std::vector<I4> IErr(NNghbr, 0);
+   return alignedBufferSize(TypeSize * ExchSize * List.numElems(NumLayers));
 
-   I4 Err{0}; // Error code to return
+} // end currentBufferSize
 
-   for (int INghbr = 0; INghbr < NNghbr; ++INghbr) {
-      MyNeighbor    = &Neighbors[INghbr];
-      I4 BufferSize = TotSize * MyNeighbor->SendLists[MyElem].NTot;
-      IErr[INghbr] =
-          MPI_Isend(&MyNeighbor->SendBuffer[0], BufferSize, MPI_RealKind,
-                    MyNeighbor->TaskID, 0, MyComm, &MyNeighbor->SReq);
-      if (IErr[INghbr] != 0) {
-         LOG_ERROR("MPI error {} on task {} send to task {}", IErr[INghbr],
-                   MyTask, MyNeighbor->TaskID);
-         Err = -1;
-      }
+// -----------------------------------------------------------------------------
+// Return the plan for exchanging the arrays in the input Group. Existing plans
+// are searched for one matching the index space, number of halo layers,
+// values exchanged at each mesh element and element size of every array in
+// the Group, along with the memory space of the arrays and the MPI data type
+// of the messages. If none is found, a new plan is created: the number of bytes
+// to send to and receive from each Neighbor is determined for all the arrays,
+// which are packed one after another into the message for each Neighbor, and
+// the buffers holding the messages for all Neighbors are allocated. For the
+// PointToPoint and SharedMemory backends, persistent MPI requests are also
+// created for each Neighbor exchanged with MPI messages. For device arrays the
+// device buffers are allocated, and the host buffers are only used for staging
+// unless MPI is device-aware.
+
+Halo::ExchangePlan *Halo::getPlan(const ExchangeGroup &Group) {
+
+   std::vector<I4> FieldShapes;
+   for (const ExchangeGroup::Field &MyField : Group.Fields) {
+      FieldShapes.push_back(MyField.Elem);
+      FieldShapes.push_back(MyField.NLayers);
+      FieldShapes.push_back(MyField.ExchSize);
+      FieldShapes.push_back(MyField.TypeSize);
    }
 
-   return Err;
-} // end startSends
-
-//------------------------------------------------------------------------------
-// The packBuffer function is overloaded to all supported data types. First, the
-// send buffer for the neighbor is allocated with enough space to send all the
-// halo elements. Then the exchange list for the neighbor and index space
-// is used to select the proper elements and pack them into the send buffer.
-// In multidimensional arrays the second fastest index (second index from the
-// right) is the mesh element dimension. For integer arrays, the value is
-// recast as a Real in a bit-preserving manner using reinterpret_cast to pack
-// into the buffer, which is of type std::vector<Real>.
-
-int Halo::packBuffer(const ArrayHost1DI4 Array) {
-
-   ExchList *MyList = &MyNeighbor->SendLists[MyElem];
-
-   MyNeighbor->SendBuffer.resize(MyList->NTot);
-
-   for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-      for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-         I4 IBuff = MyList->Offsets[ILayer] + IExch;
-         MyNeighbor->SendBuffer[IBuff] =
-             reinterpret_cast<Real &>(Array(MyList->Ind[ILayer][IExch]));
-      }
+   for (std::shared_ptr<ExchangePlan> &Plan : Plans) {
+      if (Plan->FieldShapes == FieldShapes and
+          Plan->OnDevice == Group.OnDevice and Plan->MsgType == Group.MsgType)
+         return Plan.get();
    }
 
-   return 0;
-} // end packBuffer ArrayHost1DI4
-
-int Halo::packBuffer(const ArrayHost1DI8 Array) {
-
-   ExchList *MyList = &MyNeighbor->SendLists[MyElem];
-
-   MyNeighbor->SendBuffer.resize(MyList->NTot);
-
-   for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-      for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-         I4 IBuff = MyList->Offsets[ILayer] + IExch;
-         MyNeighbor->SendBuffer[IBuff] =
-             reinterpret_cast<Real &>(Array(MyList->Ind[ILayer][IExch]));
+   auto NewPlan         = std::make_shared<ExchangePlan>();
+   NewPlan->FieldShapes = FieldShapes;
+   NewPlan->OnDevice    = Group.OnDevice;
+   NewPlan->MsgType     = Group.MsgType;
+   NewPlan->MsgTypeSize = Group.MsgTypeSize;
+
+   NewPlan->SendSizes.resize(NNghbr, 0);
+   NewPlan->RecvSizes.resize(NNghbr, 0);
+   NewPlan->SendOffsets.resize(NNghbr, 0);
+   NewPlan->RecvOffsets.resize(NNghbr, 0);
+   NewPlan->SendCounts.resize(NNghbr, 0);
+   NewPlan->RecvCounts.resize(NNghbr, 0);
+   NewPlan->SendDispls.resize(NNghbr, 0);
+   NewPlan->RecvDispls.resize(NNghbr, 0);
+
+   // Determine the size and offset of the message for each Neighbor. The
+   // size of every message is a multiple of the MPI data type size.
+   I4 SendTotal{0};
+   I4 RecvTotal{0};
+   for (int INghbr = 0; INghbr < NNghbr; ++INghbr) {
+      MyNeighbor = &Neighbors[INghbr];
+      for (const ExchangeGroup::Field &MyField : Group.Fields) {
+         setCurrentField(MyField.Elem, MyField.TotSize, MyField.ExchSize,
+                         MyField.NLayers, MyField.VertBegin);
+         NewPlan->SendSizes[INghbr] += currentBufferSize(
+             MyField.TypeSize, MyNeighbor->SendLists[MyElem]);
+         NewPlan->RecvSizes[INghbr] += currentBufferSize(
+             MyField.TypeSize, MyNeighbor->RecvLists[MyElem]);
       }
-   }
-
-   return 0;
-} // end packBuffer ArrayHost1DI8
-
-int Halo::packBuffer(const ArrayHost1DR4 Array) {
 
-   ExchList *MyList = &MyNeighbor->SendLists[MyElem];
-
-   MyNeighbor->SendBuffer.resize(MyList->NTot);
-
-   for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-      for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-         I4 IBuff                      = MyList->Offsets[ILayer] + IExch;
-         MyNeighbor->SendBuffer[IBuff] = Array(MyList->Ind[ILayer][IExch]);
-      }
+      NewPlan->SendOffsets[INghbr] = SendTotal;
+      NewPlan->RecvOffsets[INghbr] = RecvTotal;
+      NewPlan->SendCounts[INghbr] =
+          NewPlan->SendSizes[INghbr] / NewPlan->MsgTypeSize;
+      NewPlan->RecvCounts[INghbr] =
+          NewPlan->RecvSizes[INghbr] / NewPlan->MsgTypeSize;
+      NewPlan->SendDispls[INghbr] = SendTotal / NewPlan->MsgTypeSize;
+      NewPlan->RecvDispls[INghbr] = RecvTotal / NewPlan->MsgTypeSize;
+      SendTotal += NewPlan->SendSizes[INghbr];
+      RecvTotal += NewPlan->RecvSizes[INghbr];
    }
 
-   return 0;
-} // end packBuffer ArrayHost1DR4
-
-int Halo::packBuffer(const ArrayHost1DR8 Array) {
+   // Neighbors on the local node are exchanged through shared memory for
+   // host arrays with the SharedMemory backend, all others with MPI
+   bool UseShared = Backend == SharedMemory and not NewPlan->OnDevice;
+   for (int INghbr = 0; INghbr < NNghbr; ++INghbr) {
+      if (UseShared and NeighborNodeTask[INghbr] >= 0)
+         NewPlan->NodeNghbrs.push_back(INghbr);
+      else
+         NewPlan->MsgNghbrs.push_back(INghbr);
+   }
 
-   ExchList *MyList = &MyNeighbor->SendLists[MyElem];
+   NewPlan->RecvBuffer.resize(RecvTotal);
+   NewPlan->MPIRecvBuffer = NewPlan->RecvBuffer.data();
+   NewPlan->RecvPtrs.resize(NNghbr);
+   for (int INghbr = 0; INghbr < NNghbr; ++INghbr)
+      NewPlan->RecvPtrs[INghbr] =
+          NewPlan->RecvBuffer.data() + NewPlan->RecvOffsets[INghbr];
 
-   MyNeighbor->SendBuffer.resize(MyList->NTot);
+   I4 Err{0}; // error code
 
-   for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-      for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-         I4 IBuff                      = MyList->Offsets[ILayer] + IExch;
-         MyNeighbor->SendBuffer[IBuff] = Array(MyList->Ind[ILayer][IExch]);
-      }
+   if (UseShared) {
+      Err = createSharedBuffer(NewPlan.get(), SendTotal);
+   } else {
+      NewPlan->SendBuffer.resize(SendTotal);
+      NewPlan->MPISendBuffer = NewPlan->SendBuffer.data();
    }
 
-   return 0;
-} // end packBuffer ArrayHost1DR8
-
-int Halo::packBuffer(const ArrayHost2DI4 Array) {
-
-   ExchList *MyList  = &MyNeighbor->SendLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NJ            = MyDims[1];
+   if (NewPlan->OnDevice) {
+      resizeDeviceBuffer(NewPlan->SendBufferDev, SendTotal);
+      resizeDeviceBuffer(NewPlan->RecvBufferDev, RecvTotal);
+      // Communicate directly from the device buffers if MPI is device-aware
+#ifdef OMEGA_MPI_ON_DEVICE
+      NewPlan->MPISendBuffer = NewPlan->SendBufferDev.data();
+      NewPlan->MPIRecvBuffer = NewPlan->RecvBufferDev.data();
+#endif
+   }
 
-   MyNeighbor->SendBuffer.resize(MyList->NTot * TotSize);
+   if (Backend != NeighborCollective) {
+      I4 NMsg = NewPlan->MsgNghbrs.size();
+      NewPlan->SendReqs.resize(NMsg, MPI_REQUEST_NULL);
+      NewPlan->RecvReqs.resize(NMsg, MPI_REQUEST_NULL);
+
+      for (int IMsg = 0; IMsg < NMsg; ++IMsg) {
+         I4 INghbr     = NewPlan->MsgNghbrs[IMsg];
+         MyNeighbor    = &Neighbors[INghbr];
+         char *SendPtr = NewPlan->MPISendBuffer + NewPlan->SendOffsets[INghbr];
+         char *RecvPtr = NewPlan->MPIRecvBuffer + NewPlan->RecvOffsets[INghbr];
+
+         I4 IErr = MPI_Recv_init(
+             RecvPtr, NewPlan->RecvCounts[INghbr], NewPlan->MsgType,
+             MyNeighbor->TaskID, MPI_ANY_TAG, MyComm, &NewPlan->RecvReqs[IMsg]);
+         if (IErr != MPI_SUCCESS) {
+            LOG_ERROR("MPI error {} on task {} creating receive from task {}",
+                      IErr, MyTask, MyNeighbor->TaskID);
+            Err = -1;
+         }
 
-   for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-      for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-         for (int J = 0; J < NJ; ++J) {
-            I4 IBuff = (MyList->Offsets[ILayer] + IExch) * NJ + J;
-            MyNeighbor->SendBuffer[IBuff] =
-                reinterpret_cast<Real &>(Array(MyList->Ind[ILayer][IExch], J));
+         IErr = MPI_Send_init(SendPtr, NewPlan->SendCounts[INghbr],
+                              NewPlan->MsgType, MyNeighbor->TaskID, 0, MyComm,
+                              &NewPlan->SendReqs[IMsg]);
+         if (IErr != MPI_SUCCESS) {
+            LOG_ERROR("MPI error {} on task {} creating send to task {}", IErr,
+                      MyTask, MyNeighbor->TaskID);
+            Err = -1;
          }
       }
    }
 
-   return 0;
-} // end packBuffer ArrayHost2DI4
+   if (Err != 0)
+      return nullptr;
 
-int Halo::packBuffer(const ArrayHost2DI8 Array) {
+   Plans.push_back(NewPlan);
 
-   ExchList *MyList  = &MyNeighbor->SendLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NJ            = MyDims[1];
+   return NewPlan.get();
+} // end getPlan
 
-   MyNeighbor->SendBuffer.resize(MyList->NTot * TotSize);
-
-   for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-      for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-         for (int J = 0; J < NJ; ++J) {
-            I4 IBuff = (MyList->Offsets[ILayer] + IExch) * NJ + J;
-            MyNeighbor->SendBuffer[IBuff] =
-                reinterpret_cast<Real &>(Array(MyList->Ind[ILayer][IExch], J));
-         }
-      }
-   }
-
-   return 0;
-} // end packBuffer ArrayHost2DI8
-
-int Halo::packBuffer(const ArrayHost2DR4 Array) {
+// -----------------------------------------------------------------------------
+// Allocate the send buffer of the input plan in a shared-memory window on the
+// local node, so that neighbors on the same node can unpack their messages
+// directly from it. Each task tells its neighbors on the node where their
+// messages start in its send buffer, and then locates the messages sent to it
+// in the shared send buffers of those neighbors. The window is locked for
+// shared access for its lifetime so MPI_Win_sync can be used to make packed
+// values visible to the other tasks. This is collective over the node.
+
+int Halo::createSharedBuffer(ExchangePlan *Plan, // plan to set up
+                             I4 SendTotal        // size of send buffer
+) {
 
-   ExchList *MyList  = &MyNeighbor->SendLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NJ            = MyDims[1];
+   I4 Err{0}; // error code
 
-   MyNeighbor->SendBuffer.resize(MyList->NTot * TotSize);
+   char *BasePtr{nullptr};
+   MPI_Aint WinSize = std::max(SendTotal, 1);
+   I4 IErr = MPI_Win_allocate_shared(WinSize, 1, MPI_INFO_NULL, *NodeComm,
+                                     &BasePtr, &Plan->Win);
+   if (IErr != MPI_SUCCESS) {
+      LOG_ERROR("MPI error {} on task {} allocating shared halo buffer", IErr,
+                MyTask);
+      return -1;
+   }
+   MPI_Win_lock_all(MPI_MODE_NOCHECK, Plan->Win);
+   Plan->MPISendBuffer = BasePtr;
+
+   // Exchange the offsets of the messages in the shared send buffers
+   I4 NNode = Plan->NodeNghbrs.size();
+   std::vector<MPI_Aint> SendOffsets(NNode), RecvOffsets(NNode);
+   std::vector<MPI_Request> Reqs(2 * NNode, MPI_REQUEST_NULL);
+   for (int INode = 0; INode < NNode; ++INode) {
+      I4 INghbr          = Plan->NodeNghbrs[INode];
+      SendOffsets[INode] = Plan->SendOffsets[INghbr];
+      I4 TaskID          = Neighbors[INghbr].TaskID;
+      MPI_Irecv(&RecvOffsets[INode], 1, MPI_AINT, TaskID, 1, MyComm,
+                &Reqs[2 * INode]);
+      MPI_Isend(&SendOffsets[INode], 1, MPI_AINT, TaskID, 1, MyComm,
+                &Reqs[2 * INode + 1]);
+   }
+   IErr = MPI_Waitall(2 * NNode, Reqs.data(), MPI_STATUSES_IGNORE);
+   if (IErr != MPI_SUCCESS) {
+      LOG_ERROR("MPI error {} on task {} exchanging shared buffer offsets",
+                IErr, MyTask);
+      Err = -1;
+   }
 
-   for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-      for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-         for (int J = 0; J < NJ; ++J) {
-            I4 IBuff = (MyList->Offsets[ILayer] + IExch) * NJ + J;
-            MyNeighbor->SendBuffer[IBuff] =
-                Array(MyList->Ind[ILayer][IExch], J);
-         }
-      }
+   // Point to the message from each neighbor on the node
+   for (int INode = 0; INode < NNode; ++INode) {
+      I4 INghbr = Plan->NodeNghbrs[INode];
+      MPI_Aint NghbrSize;
+      I4 DispUnit;
+      char *NghbrPtr{nullptr};
+      MPI_Win_shared_query(Plan->Win, NeighborNodeTask[INghbr], &NghbrSize,
+                           &DispUnit, &NghbrPtr);
+      Plan->RecvPtrs[INghbr] = NghbrPtr + RecvOffsets[INode];
    }
 
-   return 0;
-} // end packBuffer ArrayHost2DR4
+   return Err;
+} // end createSharedBuffer
 
-int Halo::packBuffer(const ArrayHost2DR8 Array) {
+// -----------------------------------------------------------------------------
+// Prepare for MPI communication by starting the persistent receive requests
+// of the current plan for each Neighbor. For the NeighborCollective backend
+// the receives are part of the collective started in startSends.
 
-   ExchList *MyList  = &MyNeighbor->SendLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NJ            = MyDims[1];
+int Halo::startReceives() {
 
-   MyNeighbor->SendBuffer.resize(MyList->NTot * TotSize);
+   I4 Err{0}; // Error code to return
 
-   for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-      for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-         for (int J = 0; J < NJ; ++J) {
-            I4 IBuff = (MyList->Offsets[ILayer] + IExch) * NJ + J;
-            MyNeighbor->SendBuffer[IBuff] =
-                Array(MyList->Ind[ILayer][IExch], J);
-         }
-      }
+   // Nothing to start if this task has no neighbors to message
+   I4 NMsg = MyPlan->RecvReqs.size();
+   if (Backend == NeighborCollective or NMsg == 0)
+      return Err;
+
+   I4 IErr = MPI_Startall(NMsg, MyPlan->RecvReqs.data());
+   if (IErr != MPI_SUCCESS) {
+      LOG_ERROR("MPI error {} on task {} starting halo receives", IErr, MyTask);
+      Err = -1;
    }
 
-   return 0;
-} // end packBuffer ArrayHost2DR8
+   return Err;
+} // end startReceives
 
-int Halo::packBuffer(const ArrayHost3DI4 Array) {
+// -----------------------------------------------------------------------------
+// Initiate MPI communication by starting the persistent send requests of the
+// current plan to send the packed buffers to each task. For the
+// NeighborCollective backend, a non-blocking MPI_Ineighbor_alltoallv on the
+// graph communicator sends and receives the messages for all Neighbors. For
+// a shared send buffer, a non-blocking barrier on the node signals that the
+// buffer is ready to be read by the other tasks on the node.
 
-   ExchList *MyList  = &MyNeighbor->SendLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NK            = MyDims[0];
-   int NJ            = MyDims[2];
+int Halo::startSends() {
 
-   MyNeighbor->SendBuffer.resize(MyList->NTot * TotSize);
+   I4 Err{0};  // Error code to return
+   I4 IErr{0}; // MPI error code
+
+   // Make sure the device pack kernels have completed before the buffers
+   // are handed to MPI
+   if (MyPlan->OnDevice)
+      yakl::fence();
+
+   // For device arrays, copy the packed buffer to the host staging buffer
+   // unless MPI is device-aware and sends directly from the device buffer
+#ifndef OMEGA_MPI_ON_DEVICE
+   I4 BufferSize = MyPlan->SendBuffer.size();
+   if (MyPlan->OnDevice and BufferSize > 0) {
+      ArrayHost1DByte SendBufferH("SendBufferH", MyPlan->SendBuffer.data(),
+                                  BufferSize);
+      MyPlan->SendBufferDev.deep_copy_to(SendBufferH);
+   }
+#endif
+
+   if (Backend == NeighborCollective) {
+      IErr = MPI_Ineighbor_alltoallv(
+          MyPlan->MPISendBuffer, MyPlan->SendCounts.data(),
+          MyPlan->SendDispls.data(), MyPlan->MsgType, MyPlan->MPIRecvBuffer,
+          MyPlan->RecvCounts.data(), MyPlan->RecvDispls.data(),
+          MyPlan->MsgType, *GraphComm, &MyPlan->CollReq);
+   } else if (not MyPlan->SendReqs.empty()) {
+      IErr = MPI_Startall(MyPlan->SendReqs.size(), MyPlan->SendReqs.data());
+   }
+   if (IErr != MPI_SUCCESS) {
+      LOG_ERROR("MPI error {} on task {} starting halo sends", IErr, MyTask);
+      Err = -1;
+   }
 
-   for (int K = 0; K < NK; ++K) {
-      for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-         for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-            for (int J = 0; J < NJ; ++J) {
-               I4 IBuff =
-                   (K * MyList->NTot + MyList->Offsets[ILayer] + IExch) * NJ +
-                   J;
-               MyNeighbor->SendBuffer[IBuff] = reinterpret_cast<Real &>(
-                   Array(K, MyList->Ind[ILayer][IExch], J));
-            }
-         }
+   // Make the packed shared buffer visible to the other tasks on the node
+   // and signal that this task has finished packing
+   if (MyPlan->Win != MPI_WIN_NULL) {
+      MPI_Win_sync(MyPlan->Win);
+      IErr = MPI_Ibarrier(*NodeComm, &MyPlan->NodeReadyReq);
+      if (IErr != MPI_SUCCESS) {
+         LOG_ERROR("MPI error {} on task {} signalling shared halo buffer",
+                   IErr, MyTask);
+         Err = -1;
       }
    }
 
-   return 0;
-} // end packBuffer ArrayHost3DI4
-
-int Halo::packBuffer(const ArrayHost3DI8 Array) {
+   return Err;
+} // end startSends
 
-   ExchList *MyList  = &MyNeighbor->SendLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NK            = MyDims[0];
-   int NJ            = MyDims[2];
+// -----------------------------------------------------------------------------
+// Copy the message received from the Neighbor with index INghbr from the host
+// staging buffer into the device buffer of the current plan prior to
+// unpacking device arrays. If MPI is device-aware the message was received
+// directly into the device buffer and nothing needs to be done.
 
-   MyNeighbor->SendBuffer.resize(MyList->NTot * TotSize);
+int Halo::stageRecvBuffer(I4 INghbr // index of Neighbor to stage
+) {
 
-   for (int K = 0; K < NK; ++K) {
-      for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-         for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-            for (int J = 0; J < NJ; ++J) {
-               I4 IBuff =
-                   (K * MyList->NTot + MyList->Offsets[ILayer] + IExch) * NJ +
-                   J;
-               MyNeighbor->SendBuffer[IBuff] = reinterpret_cast<Real &>(
-                   Array(K, MyList->Ind[ILayer][IExch], J));
-            }
-         }
-      }
+#ifndef OMEGA_MPI_ON_DEVICE
+   I4 BufferSize = MyPlan->RecvSizes[INghbr];
+   I4 Offset     = MyPlan->RecvOffsets[INghbr];
+   if (BufferSize > 0) {
+      ArrayHost1DByte RecvBufferH(
+          "RecvBufferH", MyPlan->RecvBuffer.data() + Offset, BufferSize);
+      Array1DByte RecvBufferD(
+          "RecvBufferD", MyPlan->RecvBufferDev.data() + Offset, BufferSize);
+      RecvBufferH.deep_copy_to(RecvBufferD);
    }
+#endif
 
    return 0;
-} // end packBuffer ArrayHost3DI8
+} // end stageRecvBuffer
 
-int Halo::packBuffer(const ArrayHost3DR4 Array) {
+// -----------------------------------------------------------------------------
+// Pack each array in the input Group into the message for the Neighbor with
+// index INghbr, one after another starting at the offset of that message in
+// the send buffer of the current plan
 
-   ExchList *MyList  = &MyNeighbor->SendLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NK            = MyDims[0];
-   int NJ            = MyDims[2];
+int Halo::packNeighbor(I4 INghbr,                 // index of Neighbor
+                       const ExchangeGroup &Group // arrays to pack
+) {
 
-   MyNeighbor->SendBuffer.resize(MyList->NTot * TotSize);
+   I4 Err{0}; // error code
 
-   for (int K = 0; K < NK; ++K) {
-      for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-         for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-            for (int J = 0; J < NJ; ++J) {
-               I4 IBuff =
-                   (K * MyList->NTot + MyList->Offsets[ILayer] + IExch) * NJ +
-                   J;
-               MyNeighbor->SendBuffer[IBuff] =
-                   Array(K, MyList->Ind[ILayer][IExch], J);
-            }
-         }
-      }
+   MyNeighbor = &Neighbors[INghbr];
+   BuffPtr    = MyPlan->OnDevice ? MyPlan->SendBufferDev.data()
+                                 : MyPlan->MPISendBuffer;
+   BuffPtr += MyPlan->SendOffsets[INghbr];
+
+   for (const ExchangeGroup::Field &MyField : Group.Fields) {
+      setCurrentField(MyField.Elem, MyField.TotSize, MyField.ExchSize,
+                      MyField.NLayers, MyField.VertBegin);
+      Err += MyField.Pack(*this);
+      BuffPtr +=
+          currentBufferSize(MyField.TypeSize, MyNeighbor->SendLists[MyElem]);
    }
 
-   return 0;
-} // end packBuffer ArrayHost3DR4
+   return Err;
+} // end packNeighbor
 
-int Halo::packBuffer(const ArrayHost3DR8 Array) {
+// -----------------------------------------------------------------------------
+// Unpack the message received from the Neighbor with index INghbr into each
+// array in the input Group, in the order they were packed. Messages for device
+// arrays are first staged to the device buffer. Messages from neighbors on
+// the local node may be read directly from their shared send buffers.
 
-   ExchList *MyList  = &MyNeighbor->SendLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NK            = MyDims[0];
-   int NJ            = MyDims[2];
+int Halo::unpackNeighbor(I4 INghbr,                 // index of Neighbor
+                         const ExchangeGroup &Group // arrays to unpack
+) {
 
-   MyNeighbor->SendBuffer.resize(MyList->NTot * TotSize);
+   I4 Err{0}; // error code
 
-   for (int K = 0; K < NK; ++K) {
-      for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-         for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-            for (int J = 0; J < NJ; ++J) {
-               I4 IBuff =
-                   (K * MyList->NTot + MyList->Offsets[ILayer] + IExch) * NJ +
-                   J;
-               MyNeighbor->SendBuffer[IBuff] =
-                   Array(K, MyList->Ind[ILayer][IExch], J);
-            }
-         }
-      }
-   }
+   MyNeighbor = &Neighbors[INghbr];
+   if (MyPlan->OnDevice)
+      Err += stageRecvBuffer(INghbr);
 
-   return 0;
-} // end packBuffer ArrayHost3DR8
-
-int Halo::packBuffer(const ArrayHost4DI4 Array) {
-
-   ExchList *MyList  = &MyNeighbor->SendLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NL            = MyDims[0];
-   int NK            = MyDims[1];
-   int NJ            = MyDims[3];
-
-   MyNeighbor->SendBuffer.resize(MyList->NTot * TotSize);
-
-   for (int L = 0; L < NL; ++L) {
-      for (int K = 0; K < NK; ++K) {
-         for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-            for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-               for (int J = 0; J < NJ; ++J) {
-                  I4 IBuff = ((L * NK + K) * MyList->NTot +
-                              MyList->Offsets[ILayer] + IExch) *
-                                 NJ +
-                             J;
-                  MyNeighbor->SendBuffer[IBuff] = reinterpret_cast<Real &>(
-                      Array(L, K, MyList->Ind[ILayer][IExch], J));
-               }
-            }
-         }
-      }
-   }
+   BuffPtr = MyPlan->OnDevice
+                 ? MyPlan->RecvBufferDev.data() + MyPlan->RecvOffsets[INghbr]
+                 : MyPlan->RecvPtrs[INghbr];
 
-   return 0;
-} // end packBuffer ArrayHost4DI4
-
-int Halo::packBuffer(const ArrayHost4DI8 Array) {
-
-   ExchList *MyList  = &MyNeighbor->SendLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NL            = MyDims[0];
-   int NK            = MyDims[1];
-   int NJ            = MyDims[3];
-
-   MyNeighbor->SendBuffer.resize(MyList->NTot * TotSize);
-
-   for (int L = 0; L < NL; ++L) {
-      for (int K = 0; K < NK; ++K) {
-         for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-            for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-               for (int J = 0; J < NJ; ++J) {
-                  I4 IBuff = ((L * NK + K) * MyList->NTot +
-                              MyList->Offsets[ILayer] + IExch) *
-                                 NJ +
-                             J;
-                  MyNeighbor->SendBuffer[IBuff] = reinterpret_cast<Real &>(
-                      Array(L, K, MyList->Ind[ILayer][IExch], J));
-               }
-            }
-         }
-      }
+   for (const ExchangeGroup::Field &MyField : Group.Fields) {
+      setCurrentField(MyField.Elem, MyField.TotSize, MyField.ExchSize,
+                      MyField.NLayers, MyField.VertBegin);
+      Err += MyField.Unpack(*this);
+      BuffPtr +=
+          currentBufferSize(MyField.TypeSize, MyNeighbor->RecvLists[MyElem]);
    }
 
-   return 0;
-} // end packBuffer ArrayHost4DI8
-
-int Halo::packBuffer(const ArrayHost4DR4 Array) {
-
-   ExchList *MyList  = &MyNeighbor->SendLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NL            = MyDims[0];
-   int NK            = MyDims[1];
-   int NJ            = MyDims[3];
-
-   MyNeighbor->SendBuffer.resize(MyList->NTot * TotSize);
-
-   for (int L = 0; L < NL; ++L) {
-      for (int K = 0; K < NK; ++K) {
-         for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-            for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-               for (int J = 0; J < NJ; ++J) {
-                  I4 IBuff = ((L * NK + K) * MyList->NTot +
-                              MyList->Offsets[ILayer] + IExch) *
-                                 NJ +
-                             J;
-                  MyNeighbor->SendBuffer[IBuff] =
-                      Array(L, K, MyList->Ind[ILayer][IExch], J);
-               }
-            }
-         }
-      }
-   }
-
-   return 0;
-} // end packBuffer ArrayHost4DR4
-
-int Halo::packBuffer(const ArrayHost4DR8 Array) {
-
-   ExchList *MyList  = &MyNeighbor->SendLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NL            = MyDims[0];
-   int NK            = MyDims[1];
-   int NJ            = MyDims[3];
-
-   MyNeighbor->SendBuffer.resize(MyList->NTot * TotSize);
-
-   for (int L = 0; L < NL; ++L) {
-      for (int K = 0; K < NK; ++K) {
-         for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-            for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-               for (int J = 0; J < NJ; ++J) {
-                  I4 IBuff = ((L * NK + K) * MyList->NTot +
-                              MyList->Offsets[ILayer] + IExch) *
-                                 NJ +
-                             J;
-                  MyNeighbor->SendBuffer[IBuff] =
-                      Array(L, K, MyList->Ind[ILayer][IExch], J);
-               }
-            }
-         }
-      }
-   }
-
-   return 0;
-} // end packBuffer ArrayHost4DR8
+   return Err;
+} // end unpackNeighbor
 
-int Halo::packBuffer(const ArrayHost5DI4 Array) {
+// -----------------------------------------------------------------------------
+// Start a split-phase halo exchange of all the arrays registered in the input
+// Group. The plan for the arrays in the Group is retrieved, or created on the
+// first exchange of this combination of arrays, the receives are started,
+// each array is packed into the send buffers one after another, and a single
+// message is sent to each Neighbor. A copy of the Group is saved in Handle
+// for unpacking by finishExchange. On error, any started messages are
+// completed before returning, so no exchange is left in progress.
+
+int Halo::startExchange(const ExchangeGroup &Group, // arrays to exchange
+                        ExchangeHandle &Handle      // handle to finish exchange
+) {
 
-   ExchList *MyList  = &MyNeighbor->SendLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NM            = MyDims[0];
-   int NL            = MyDims[1];
-   int NK            = MyDims[2];
-   int NJ            = MyDims[4];
+   I4 IErr{0}; // error code
 
-   MyNeighbor->SendBuffer.resize(MyList->NTot * TotSize);
+   TimerScope StartTimer("Halo:startExchange");
 
-   for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-      for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-         for (int J = 0; J < NJ; ++J) {
-            for (int K = 0; K < NK; ++K) {
-               for (int L = 0; L < NL; ++L) {
-                  for (int M = 0; M < NM; ++M) {
-                     I4 IBuff = (((M * NL + L) * NK + K) * MyList->NTot +
-                                 MyList->Offsets[ILayer] + IExch) *
-                                    NJ +
-                                J;
-                     MyNeighbor->SendBuffer[IBuff] = reinterpret_cast<Real &>(
-                         Array(M, L, K, MyList->Ind[ILayer][IExch], J));
-                  }
-               }
-            }
-         }
-      }
+   if (ExchangeActive) {
+      LOG_ERROR("Halo: startExchange called while another exchange is "
+                "in progress");
+      return -1;
    }
 
-   return 0;
-} // end packBuffer ArrayHost5DI4
-
-int Halo::packBuffer(const ArrayHost5DI8 Array) {
-
-   ExchList *MyList  = &MyNeighbor->SendLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NM            = MyDims[0];
-   int NL            = MyDims[1];
-   int NK            = MyDims[2];
-   int NJ            = MyDims[4];
-
-   MyNeighbor->SendBuffer.resize(MyList->NTot * TotSize);
-
-   for (int M = 0; M < NM; ++M) {
-      for (int L = 0; L < NL; ++L) {
-         for (int K = 0; K < NK; ++K) {
-            for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-               for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-                  for (int J = 0; J < NJ; ++J) {
-                     I4 IBuff = (((M * NL + L) * NK + K) * MyList->NTot +
-                                 MyList->Offsets[ILayer] + IExch) *
-                                    NJ +
-                                J;
-                     MyNeighbor->SendBuffer[IBuff] = reinterpret_cast<Real &>(
-                         Array(M, L, K, MyList->Ind[ILayer][IExch], J));
-                  }
-               }
-            }
-         }
-      }
+   if (Group.Fields.empty()) {
+      LOG_ERROR("Halo: startExchange called with an empty exchange group");
+      return -1;
    }
 
-   return 0;
-} // end packBuffer ArrayHost5DI8
-
-int Halo::packBuffer(const ArrayHost5DR4 Array) {
-
-   ExchList *MyList  = &MyNeighbor->SendLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NM            = MyDims[0];
-   int NL            = MyDims[1];
-   int NK            = MyDims[2];
-   int NJ            = MyDims[4];
-
-   MyNeighbor->SendBuffer.resize(MyList->NTot * TotSize);
-
-   for (int M = 0; M < NM; ++M) {
-      for (int L = 0; L < NL; ++L) {
-         for (int K = 0; K < NK; ++K) {
-            for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-               for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-                  for (int J = 0; J < NJ; ++J) {
-                     I4 IBuff = (((M * NL + L) * NK + K) * MyList->NTot +
-                                 MyList->Offsets[ILayer] + IExch) *
-                                    NJ +
-                                J;
-                     MyNeighbor->SendBuffer[IBuff] =
-                         Array(M, L, K, MyList->Ind[ILayer][IExch], J);
-                  }
-               }
-            }
-         }
+   // The number of halo layers requested for each array cannot exceed the
+   // layers of its index space
+   for (const ExchangeGroup::Field &MyField : Group.Fields) {
+      I4 MaxLayers = (MyField.Elem == OnCell) ? HaloWidth : HaloWidth + 1;
+      if (MyField.NLayers > MaxLayers) {
+         LOG_ERROR("Halo: {} halo layers requested but only {} available",
+                   MyField.NLayers, MaxLayers);
+         return -1;
       }
    }
 
-   return 0;
-} // end packBuffer ArrayHost5DR4
-
-int Halo::packBuffer(const ArrayHost5DR8 Array) {
-
-   ExchList *MyList  = &MyNeighbor->SendLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NM            = MyDims[0];
-   int NL            = MyDims[1];
-   int NK            = MyDims[2];
-   int NJ            = MyDims[4];
-
-   MyNeighbor->SendBuffer.resize(MyList->NTot * TotSize);
-
-   for (int M = 0; M < NM; ++M) {
-      for (int L = 0; L < NL; ++L) {
-         for (int K = 0; K < NK; ++K) {
-            for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-               for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-                  for (int J = 0; J < NJ; ++J) {
-                     I4 IBuff = (((M * NL + L) * NK + K) * MyList->NTot +
-                                 MyList->Offsets[ILayer] + IExch) *
-                                    NJ +
-                                J;
-                     MyNeighbor->SendBuffer[IBuff] =
-                         Array(M, L, K, MyList->Ind[ILayer][IExch], J);
-                  }
-               }
-            }
-         }
-      }
+   // Retrieve the buffers and persistent requests for the arrays in the group
+   MyPlan = getPlan(Group);
+   if (MyPlan == nullptr) {
+      LOG_ERROR("Halo: Error creating exchange plan");
+      return -1;
    }
 
-   return 0;
-} // end packBuffer ArrayHost5DR8
-
-//------------------------------------------------------------------------------
-// The unpackBuffer function is overloaded to all supported data types. After
-// a message has been received from a neighboring task, the RecvList for the
-// corresponding Neighbor and index space is used to save the elements of the
-// receive buffer in their proper locations in the input Array. In multi-
-// dimensional arrays the second fastest index (second index from the
-// right) is the mesh element dimension. For integer arrays, the value from
-// the buffer is recast in a bit-preserving manner from a Real to the proper
-// integer type (I4 or I8) using reinterpret_cast, and then saved in the
-// input Array.
-
-int Halo::unpackBuffer(ArrayHost1DI4 &Array) {
-
-   ExchList *MyList = &MyNeighbor->RecvLists[MyElem];
-
-   for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-      for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-         I4 IBuff = MyList->Offsets[ILayer] + IExch;
-         Array(MyList->Ind[ILayer][IExch]) =
-             reinterpret_cast<I4 &>(MyNeighbor->RecvBuffer[IBuff]);
-      }
+   // A shared send buffer can only be repacked once the tasks on the node
+   // have finished unpacking the previous exchange from it
+   if (MyPlan->Win != MPI_WIN_NULL and
+       MPI_Wait(&MyPlan->NodeDoneReq, MPI_STATUS_IGNORE) != MPI_SUCCESS) {
+      LOG_ERROR("Halo: Error waiting for shared halo buffer");
+      IErr += 1;
    }
 
-   return 0;
-} // end unpackBuffer ArrayHost1DI4
-
-int Halo::unpackBuffer(ArrayHost1DI8 &Array) {
+   // Start the receives for each Neighbor so the local task is ready to
+   // accept messages from each neighboring task
+   IErr += startReceives();
 
-   ExchList *MyList = &MyNeighbor->RecvLists[MyElem];
-
-   for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-      for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-         I4 IBuff = MyList->Offsets[ILayer] + IExch;
-         Array(MyList->Ind[ILayer][IExch]) =
-             reinterpret_cast<I8 &>(MyNeighbor->RecvBuffer[IBuff]);
+   // Loop through each Neighbor and pack each array into the buffer to be
+   // sent to each neighboring task
+   {
+      TimerScope PackTimer("Halo:pack");
+      for (int INghbr = 0; INghbr < NNghbr; ++INghbr) {
+         IErr += packNeighbor(INghbr, Group);
       }
    }
 
-   return 0;
-} // end unpackBuffer ArrayHost1DI8
-
-int Halo::unpackBuffer(ArrayHost1DR4 &Array) {
-
-   ExchList *MyList = &MyNeighbor->RecvLists[MyElem];
-
-   for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-      for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-         I4 IBuff                          = MyList->Offsets[ILayer] + IExch;
-         Array(MyList->Ind[ILayer][IExch]) = MyNeighbor->RecvBuffer[IBuff];
-      }
+   // Start the sends for each Neighbor to send the packed buffers
+   {
+      TimerScope SendTimer("Halo:send");
+      IErr += startSends();
    }
 
-   return 0;
-} // end unpackBuffer ArrayHost1DR4
-
-int Halo::unpackBuffer(ArrayHost1DR8 &Array) {
+   Handle.Group   = Group;
+   Handle.Active  = true;
+   ExchangeActive = true;
 
-   ExchList *MyList = &MyNeighbor->RecvLists[MyElem];
-
-   for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-      for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-         I4 IBuff                          = MyList->Offsets[ILayer] + IExch;
-         Array(MyList->Ind[ILayer][IExch]) = MyNeighbor->RecvBuffer[IBuff];
-      }
+   // If any step failed once the plan was retrieved, complete the exchange
+   // here so that no requests are left active and the Halo is ready for the
+   // next exchange
+   if (IErr != 0) {
+      LOG_ERROR("Halo: Error starting halo exchange on task {}", MyTask);
+      finishExchange(Handle);
    }
 
-   return 0;
-} // end unpackBuffer ArrayHost1DR8
-
-int Halo::unpackBuffer(ArrayHost2DI4 &Array) {
-
-   ExchList *MyList  = &MyNeighbor->RecvLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NJ            = MyDims[1];
-
-   for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-      for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-         for (int J = 0; J < NJ; ++J) {
-            I4 IBuff = (MyList->Offsets[ILayer] + IExch) * NJ + J;
-            Array(MyList->Ind[ILayer][IExch], J) =
-                reinterpret_cast<I4 &>(MyNeighbor->RecvBuffer[IBuff]);
-         }
-      }
-   }
+   return IErr;
+} // end startExchange
 
-   return 0;
-} // end unpackBuffer ArrayHost2DI4
+// -----------------------------------------------------------------------------
+// Complete a split-phase halo exchange started by startExchange. For the
+// PointToPoint backend, MPI_Waitany returns as soon as any outstanding message
+// has been received, and that buffer is unpacked into the arrays saved in the
+// Handle while the remaining messages are still in flight. Once all messages
+// are unpacked, wait for the sends to complete so the send buffers can be
+// safely reused. The persistent requests of the plan become inactive and are
+// restarted by the next exchange of the same arrays. For the SharedMemory
+// backend, messages from Neighbors on the local node are first unpacked
+// directly from their shared send buffers. For the NeighborCollective
+// backend, the collective is completed and then the message from each
+// Neighbor is unpacked.
+
+int Halo::finishExchange(ExchangeHandle &Handle) {
 
-int Halo::unpackBuffer(ArrayHost2DI8 &Array) {
+   I4 Err{0}; // error code to return
 
-   ExchList *MyList  = &MyNeighbor->RecvLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NJ            = MyDims[1];
+   TimerScope FinishTimer("Halo:finishExchange");
 
-   for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-      for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-         for (int J = 0; J < NJ; ++J) {
-            I4 IBuff = (MyList->Offsets[ILayer] + IExch) * NJ + J;
-            Array(MyList->Ind[ILayer][IExch], J) =
-                reinterpret_cast<I8 &>(MyNeighbor->RecvBuffer[IBuff]);
-         }
-      }
+   if (not Handle.Active or not ExchangeActive) {
+      LOG_ERROR("Halo: finishExchange called without a matching "
+                "startExchange");
+      return -1;
    }
 
-   return 0;
-} // end unpackBuffer ArrayHost2DI8
-
-int Halo::unpackBuffer(ArrayHost2DR4 &Array) {
-
-   ExchList *MyList  = &MyNeighbor->RecvLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NJ            = MyDims[1];
-
-   for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-      for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-         for (int J = 0; J < NJ; ++J) {
-            I4 IBuff = (MyList->Offsets[ILayer] + IExch) * NJ + J;
-            Array(MyList->Ind[ILayer][IExch], J) =
-                MyNeighbor->RecvBuffer[IBuff];
-         }
+   if (Backend == NeighborCollective) {
+      I4 IErr{0};
+      {
+         TimerScope WaitTimer("Halo:wait");
+         IErr = MPI_Wait(&MyPlan->CollReq, MPI_STATUS_IGNORE);
       }
-   }
-
-   return 0;
-} // end unpackBuffer ArrayHost2DR4
-
-int Halo::unpackBuffer(ArrayHost2DR8 &Array) {
-
-   ExchList *MyList  = &MyNeighbor->RecvLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NJ            = MyDims[1];
-
-   for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-      for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-         for (int J = 0; J < NJ; ++J) {
-            I4 IBuff = (MyList->Offsets[ILayer] + IExch) * NJ + J;
-            Array(MyList->Ind[ILayer][IExch], J) =
-                MyNeighbor->RecvBuffer[IBuff];
+      if (IErr != MPI_SUCCESS) {
+         LOG_ERROR("MPI error {} on task {} waiting for halo collective", IErr,
+                   MyTask);
+         Err = -1;
+      } else {
+         TimerScope UnpackTimer("Halo:unpack");
+         for (int INghbr = 0; INghbr < NNghbr; ++INghbr) {
+            Err += unpackNeighbor(INghbr, Handle.Group);
          }
       }
-   }
-
-   return 0;
-} // end unpackBuffer ArrayHost2DR8
-
-int Halo::unpackBuffer(ArrayHost3DI4 &Array) {
-
-   ExchList *MyList  = &MyNeighbor->RecvLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NK            = MyDims[0];
-   int NJ            = MyDims[2];
-
-   for (int K = 0; K < NK; ++K) {
-      for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-         for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-            for (int J = 0; J < NJ; ++J) {
-               I4 IBuff =
-                   (K * MyList->NTot + MyList->Offsets[ILayer] + IExch) * NJ +
-                   J;
-               Array(K, MyList->Ind[ILayer][IExch], J) =
-                   reinterpret_cast<I4 &>(MyNeighbor->RecvBuffer[IBuff]);
-            }
+   } else {
+      // Unpack the messages from neighbors on the node once every task on
+      // the node has packed its shared buffer, then signal that this task
+      // has finished reading the shared buffers
+      if (MyPlan->Win != MPI_WIN_NULL) {
+         I4 IErr{0};
+         {
+            TimerScope WaitTimer("Halo:wait");
+            IErr = MPI_Wait(&MyPlan->NodeReadyReq, MPI_STATUS_IGNORE);
+            MPI_Win_sync(MyPlan->Win);
          }
-      }
-   }
-
-   return 0;
-} // end unpackBuffer ArrayHost3DI4
-
-int Halo::unpackBuffer(ArrayHost3DI8 &Array) {
-
-   ExchList *MyList  = &MyNeighbor->RecvLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NK            = MyDims[0];
-   int NJ            = MyDims[2];
-
-   for (int K = 0; K < NK; ++K) {
-      for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-         for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-            for (int J = 0; J < NJ; ++J) {
-               I4 IBuff =
-                   (K * MyList->NTot + MyList->Offsets[ILayer] + IExch) * NJ +
-                   J;
-               Array(K, MyList->Ind[ILayer][IExch], J) =
-                   reinterpret_cast<I8 &>(MyNeighbor->RecvBuffer[IBuff]);
+         {
+            TimerScope UnpackTimer("Halo:unpack");
+            for (I4 INghbr : MyPlan->NodeNghbrs) {
+               Err += unpackNeighbor(INghbr, Handle.Group);
             }
          }
-      }
-   }
-
-   return 0;
-} // end unpackBuffer ArrayHost3DI8
-
-int Halo::unpackBuffer(ArrayHost3DR4 &Array) {
-
-   ExchList *MyList  = &MyNeighbor->RecvLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NK            = MyDims[0];
-   int NJ            = MyDims[2];
-
-   for (int K = 0; K < NK; ++K) {
-      for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-         for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-            for (int J = 0; J < NJ; ++J) {
-               I4 IBuff =
-                   (K * MyList->NTot + MyList->Offsets[ILayer] + IExch) * NJ +
-                   J;
-               Array(K, MyList->Ind[ILayer][IExch], J) =
-                   MyNeighbor->RecvBuffer[IBuff];
-            }
+         if (IErr == MPI_SUCCESS)
+            IErr = MPI_Ibarrier(*NodeComm, &MyPlan->NodeDoneReq);
+         if (IErr != MPI_SUCCESS) {
+            LOG_ERROR("MPI error {} on task {} synchronizing shared halo "
+                      "buffers",
+                      IErr, MyTask);
+            Err = -1;
          }
       }
-   }
-
-   return 0;
-} // end unpackBuffer ArrayHost3DR4
-
-int Halo::unpackBuffer(ArrayHost3DR8 &Array) {
 
-   ExchList *MyList  = &MyNeighbor->RecvLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NK            = MyDims[0];
-   int NJ            = MyDims[2];
-
-   for (int K = 0; K < NK; ++K) {
-      for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-         for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-            for (int J = 0; J < NJ; ++J) {
-               I4 IBuff =
-                   (K * MyList->NTot + MyList->Offsets[ILayer] + IExch) * NJ +
-                   J;
-               Array(K, MyList->Ind[ILayer][IExch], J) =
-                   MyNeighbor->RecvBuffer[IBuff];
-            }
+      I4 NMsg = MyPlan->RecvReqs.size();
+      for (int IRecv = 0; IRecv < NMsg; ++IRecv) {
+         I4 IMsg{0};
+         I4 IErr{0};
+         {
+            TimerScope WaitTimer("Halo:wait");
+            IErr = MPI_Waitany(NMsg, MyPlan->RecvReqs.data(), &IMsg,
+                               MPI_STATUS_IGNORE);
          }
-      }
-   }
-
-   return 0;
-} // end unpackBuffer ArrayHost3DR8
-
-int Halo::unpackBuffer(ArrayHost4DI4 &Array) {
-
-   ExchList *MyList  = &MyNeighbor->RecvLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NL            = MyDims[0];
-   int NK            = MyDims[1];
-   int NJ            = MyDims[3];
-
-   for (int L = 0; L < NL; ++L) {
-      for (int K = 0; K < NK; ++K) {
-         for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-            for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-               for (int J = 0; J < NJ; ++J) {
-                  I4 IBuff = ((L * NK + K) * MyList->NTot +
-                              MyList->Offsets[ILayer] + IExch) *
-                                 NJ +
-                             J;
-                  Array(L, K, MyList->Ind[ILayer][IExch], J) =
-                      reinterpret_cast<I4 &>(MyNeighbor->RecvBuffer[IBuff]);
-               }
-            }
+         if (IErr != MPI_SUCCESS or IMsg == MPI_UNDEFINED) {
+            LOG_ERROR("MPI error {} on task {} waiting for halo messages", IErr,
+                      MyTask);
+            Err = -1;
+            break;
          }
+         TimerScope UnpackTimer("Halo:unpack");
+         Err += unpackNeighbor(MyPlan->MsgNghbrs[IMsg], Handle.Group);
       }
-   }
 
-   return 0;
-} // end unpackBuffer ArrayHost4DI4
-
-int Halo::unpackBuffer(ArrayHost4DI8 &Array) {
-
-   ExchList *MyList  = &MyNeighbor->RecvLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NL            = MyDims[0];
-   int NK            = MyDims[1];
-   int NJ            = MyDims[3];
-
-   for (int L = 0; L < NL; ++L) {
-      for (int K = 0; K < NK; ++K) {
-         for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-            for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-               for (int J = 0; J < NJ; ++J) {
-                  I4 IBuff = ((L * NK + K) * MyList->NTot +
-                              MyList->Offsets[ILayer] + IExch) *
-                                 NJ +
-                             J;
-                  Array(L, K, MyList->Ind[ILayer][IExch], J) =
-                      reinterpret_cast<I8 &>(MyNeighbor->RecvBuffer[IBuff]);
-               }
-            }
-         }
+      I4 IErr = MPI_SUCCESS;
+      if (NMsg > 0) {
+         TimerScope WaitTimer("Halo:wait");
+         IErr = MPI_Waitall(NMsg, MyPlan->SendReqs.data(), MPI_STATUSES_IGNORE);
       }
-   }
-
-   return 0;
-} // end unpackBuffer ArrayHost4DI8
-
-int Halo::unpackBuffer(ArrayHost4DR4 &Array) {
-
-   ExchList *MyList  = &MyNeighbor->RecvLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NL            = MyDims[0];
-   int NK            = MyDims[1];
-   int NJ            = MyDims[3];
-
-   for (int L = 0; L < NL; ++L) {
-      for (int K = 0; K < NK; ++K) {
-         for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-            for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-               for (int J = 0; J < NJ; ++J) {
-                  I4 IBuff = ((L * NK + K) * MyList->NTot +
-                              MyList->Offsets[ILayer] + IExch) *
-                                 NJ +
-                             J;
-                  Array(L, K, MyList->Ind[ILayer][IExch], J) =
-                      MyNeighbor->RecvBuffer[IBuff];
-               }
-            }
-         }
+      if (IErr != MPI_SUCCESS) {
+         LOG_ERROR("MPI error {} on task {} waiting for halo sends", IErr,
+                   MyTask);
+         Err = -1;
       }
    }
 
-   return 0;
-} // end unpackBuffer ArrayHost4DR4
-
-int Halo::unpackBuffer(ArrayHost4DR8 &Array) {
-
-   ExchList *MyList  = &MyNeighbor->RecvLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NL            = MyDims[0];
-   int NK            = MyDims[1];
-   int NJ            = MyDims[3];
-
-   for (int L = 0; L < NL; ++L) {
-      for (int K = 0; K < NK; ++K) {
-         for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-            for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-               for (int J = 0; J < NJ; ++J) {
-                  I4 IBuff = ((L * NK + K) * MyList->NTot +
-                              MyList->Offsets[ILayer] + IExch) *
-                                 NJ +
-                             J;
-                  Array(L, K, MyList->Ind[ILayer][IExch], J) =
-                      MyNeighbor->RecvBuffer[IBuff];
-               }
-            }
-         }
-      }
+   // Ensure the unpack kernels for device arrays have completed
+   if (MyPlan->OnDevice) {
+      TimerScope UnpackTimer("Halo:unpack");
+      yakl::fence();
    }
 
-   return 0;
-} // end unpackBuffer ArrayHost4DR8
-
-int Halo::unpackBuffer(ArrayHost5DI4 &Array) {
-
-   ExchList *MyList  = &MyNeighbor->RecvLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NM            = MyDims[0];
-   int NL            = MyDims[1];
-   int NK            = MyDims[2];
-   int NJ            = MyDims[4];
-
-   for (int M = 0; M < NM; ++M) {
-      for (int L = 0; L < NL; ++L) {
-         for (int K = 0; K < NK; ++K) {
-            for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-               for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-                  for (int J = 0; J < NJ; ++J) {
-                     I4 IBuff = (((M * NL + L) * NK + K) * MyList->NTot +
-                                 MyList->Offsets[ILayer] + IExch) *
-                                    NJ +
-                                J;
-                     Array(M, L, K, MyList->Ind[ILayer][IExch], J) =
-                         reinterpret_cast<I4 &>(MyNeighbor->RecvBuffer[IBuff]);
-                  }
-               }
-            }
-         }
-      }
-   }
+   Handle.Active  = false;
+   ExchangeActive = false;
+   Handle.Group.clear();
 
-   return 0;
-} // end unpackBuffer ArrayHost5DI4
-
-int Halo::unpackBuffer(ArrayHost5DI8 &Array) {
-
-   ExchList *MyList  = &MyNeighbor->RecvLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NM            = MyDims[0];
-   int NL            = MyDims[1];
-   int NK            = MyDims[2];
-   int NJ            = MyDims[4];
-
-   for (int M = 0; M < NM; ++M) {
-      for (int L = 0; L < NL; ++L) {
-         for (int K = 0; K < NK; ++K) {
-            for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-               for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-                  for (int J = 0; J < NJ; ++J) {
-                     I4 IBuff = (((M * NL + L) * NK + K) * MyList->NTot +
-                                 MyList->Offsets[ILayer] + IExch) *
-                                    NJ +
-                                J;
-                     Array(M, L, K, MyList->Ind[ILayer][IExch], J) =
-                         reinterpret_cast<I8 &>(MyNeighbor->RecvBuffer[IBuff]);
-                  }
-               }
-            }
-         }
-      }
-   }
+   return Err;
+} // end finishExchange
 
-   return 0;
-} // end unpackBuffer ArrayHost5DI8
-
-int Halo::unpackBuffer(ArrayHost5DR4 &Array) {
-
-   ExchList *MyList  = &MyNeighbor->RecvLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NM            = MyDims[0];
-   int NL            = MyDims[1];
-   int NK            = MyDims[2];
-   int NJ            = MyDims[4];
-
-   for (int M = 0; M < NM; ++M) {
-      for (int L = 0; L < NL; ++L) {
-         for (int K = 0; K < NK; ++K) {
-            for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-               for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-                  for (int J = 0; J < NJ; ++J) {
-                     I4 IBuff = (((M * NL + L) * NK + K) * MyList->NTot +
-                                 MyList->Offsets[ILayer] + IExch) *
-                                    NJ +
-                                J;
-                     Array(M, L, K, MyList->Ind[ILayer][IExch], J) =
-                         MyNeighbor->RecvBuffer[IBuff];
-                  }
-               }
-            }
-         }
-      }
-   }
+// -----------------------------------------------------------------------------
+// Perform a full halo exchange of all the arrays registered in the input
+// Group, with a single message to each neighboring task
 
-   return 0;
-} // end unpackBuffer ArrayHost5DR4
-
-int Halo::unpackBuffer(ArrayHost5DR8 &Array) {
-
-   ExchList *MyList  = &MyNeighbor->RecvLists[MyElem];
-   yakl::Dims MyDims = Array.get_dimensions();
-   int NM            = MyDims[0];
-   int NL            = MyDims[1];
-   int NK            = MyDims[2];
-   int NJ            = MyDims[4];
-
-   for (int M = 0; M < NM; ++M) {
-      for (int L = 0; L < NL; ++L) {
-         for (int K = 0; K < NK; ++K) {
-            for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
-               for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
-                  for (int J = 0; J < NJ; ++J) {
-                     I4 IBuff = (((M * NL + L) * NK + K) * MyList->NTot +
-                                 MyList->Offsets[ILayer] + IExch) *
-                                    NJ +
-                                J;
-                     Array(M, L, K, MyList->Ind[ILayer][IExch], J) =
-                         MyNeighbor->RecvBuffer[IBuff];
-                  }
-               }
-            }
-         }
-      }
+int Halo::exchangeGroupHalo(const ExchangeGroup &Group) {
+
+   I4 IErr{0}; // error code
+
+   ExchangeHandle Handle;
+
+   IErr = startExchange(Group, Handle);
+   if (IErr != 0) {
+      LOG_ERROR("Halo: Error starting group halo exchange");
+      return IErr;
    }
 
-   return 0;
-} // end unpackBuffer ArrayHost5DR8
+   IErr = finishExchange(Handle);
+   if (IErr != 0)
+      LOG_ERROR("Halo: Error finishing group halo exchange");
+
+   return IErr;
+} // end exchangeGroupHalo
 
 } // end namespace OMEGA
 
@@ -13,7 +13,19 @@
 /// exchange The halo exchanges are carried out via non-blocking MPI library
 /// routines. The Halo class public member function exchangeFullArrayHalo
 /// which is called by the user to perform halo exchanges is a template
-/// function and thus is fully defined in this header.
+/// function and thus is fully defined in this header, as is startExchange,
+/// the first half of a split-phase exchange that allows computation to
+/// overlap with communication until finishExchange is called. Several arrays
+/// can be registered in an ExchangeGroup and exchanged together with a single
+/// message to each neighboring task. Halo elements are packed into byte
+/// buffers in the native type of each array, and messages are sent with the
+/// matching MPI data type, so no array is widened or narrowed for
+/// communication. Both host and device YAKL arrays are supported; device
+/// arrays are packed into and unpacked from device buffers with parallel
+/// kernels, so only the (much smaller) message buffers ever move between
+/// memory spaces. If the code is built with OMEGA_MPI_ON_DEVICE defined, the
+/// device buffers are passed directly to a device-aware MPI library and no
+/// host copies are made at all.
 ///
 //
 //===----------------------------------------------------------------------===//
@@ -24,27 +36,114 @@
 #include "MachEnv.h"
 #include "mpi.h"
 
-namespace OMEGA {
+#include <functional>
+#include <memory>
+#include <type_traits>
 
-// Set the default MPI real data type as single or double precision based on
-// the default real data type used by OMEGA.
-#ifdef SINGLE_PRECISION
-static const MPI_Datatype MPI_RealKind = MPI_FLOAT;
-#else
-static const MPI_Datatype MPI_RealKind = MPI_DOUBLE;
-#endif
+namespace OMEGA {
 
 /// The meshElement enum identifies the index space to use for a halo exchange.
 enum MeshElement { OnCell, OnEdge, OnVertex };
 
+/// The HaloBackend enum selects how the messages of a halo exchange are
+/// communicated: with non-blocking point-to-point messages to each
+/// neighboring task, with a single neighborhood collective on a
+/// distributed graph communicator connecting each task to its neighbors, or
+/// through shared memory for neighbors on the same node (see MachEnv) and
+/// point-to-point messages for all other neighbors.
+enum HaloBackend { PointToPoint, NeighborCollective, SharedMemory };
+
+/// Aliases for the byte arrays used as halo buffers, which hold the packed
+/// elements of arrays of any supported type at their native size
+using Array1DByte     = yakl::Array<char, 1, yakl::memDevice, yakl::styleC>;
+using ArrayHost1DByte = yakl::Array<char, 1, yakl::memHost, yakl::styleC>;
+
+/// Type trait that selects at compile time the MPI data type matching each
+/// supported array element type. Unsupported types fail to compile.
+template <typename T> struct MPITypeOf;
+template <> struct MPITypeOf<I4> {
+   static MPI_Datatype value() { return MPI_INT32_T; }
+};
+template <> struct MPITypeOf<I8> {
+   static MPI_Datatype value() { return MPI_INT64_T; }
+};
+template <> struct MPITypeOf<R4> {
+   static MPI_Datatype value() { return MPI_FLOAT; }
+};
+template <> struct MPITypeOf<R8> {
+   static MPI_Datatype value() { return MPI_DOUBLE; }
+};
+
+/// Type trait used to determine at compile time whether a YAKL array type
+/// resides in device memory, selecting the device buffers for an exchange.
+template <typename T> struct IsDeviceArray : std::false_type {};
+template <typename T, int Rank, int Style>
+struct IsDeviceArray<yakl::Array<T, Rank, yakl::memDevice, Style>>
+    : std::true_type {};
+
+//------------------------------------------------------------------------------
+/// Function template to gather the halo elements of an array on the device
+/// into a device buffer. The array is viewed as (NOuter, NElem, NJ), where
+/// NElem is the mesh element dimension, so one kernel serves arrays of every
+/// rank. The first NTot entries of Ind hold the mesh element indices to
+/// gather, and only NK values of the last dimension starting at JBegin are
+/// gathered.
+template <typename T>
+void packDeviceBuffer(T *Buff,              // device buffer to fill
+                      const T *ArrayPtr,    // device array data
+                      const Array1DI4 &Ind, // mesh element indices to pack
+                      I4 NTot,              // number of indices to pack
+                      I4 NOuter,            // size of leading dimensions
+                      I4 NElem,             // size of mesh element dimension
+                      I4 NJ,                // size of last dimension
+                      I4 JBegin,            // first index of last dim to pack
+                      I4 NK                 // number of last dim values
+) {
+   yakl::c::parallel_for(
+       YAKL_AUTO_LABEL(), yakl::c::Bounds<3>(NOuter, NTot, NK),
+       YAKL_LAMBDA(int IOuter, int IExch, int K) {
+          Buff[(IOuter * NTot + IExch) * NK + K] =
+              ArrayPtr[(IOuter * NElem + Ind(IExch)) * NJ + JBegin + K];
+       });
+} // end packDeviceBuffer
+
+//------------------------------------------------------------------------------
+/// Function template to scatter the elements of a device buffer into the
+/// halo elements of an array on the device, the inverse of packDeviceBuffer
+template <typename T>
+void unpackDeviceBuffer(const T *Buff,        // device buffer to unpack
+                        T *ArrayPtr,          // device array data
+                        const Array1DI4 &Ind, // mesh element indices to fill
+                        I4 NTot,              // number of indices to fill
+                        I4 NOuter,            // size of leading dimensions
+                        I4 NElem,             // size of mesh element dimension
+                        I4 NJ,                // size of last dimension
+                        I4 JBegin,            // first index of last dim to fill
+                        I4 NK                 // number of last dim values
+) {
+   yakl::c::parallel_for(
+       YAKL_AUTO_LABEL(), yakl::c::Bounds<3>(NOuter, NTot, NK),
+       YAKL_LAMBDA(int IOuter, int IExch, int K) {
+          ArrayPtr[(IOuter * NElem + Ind(IExch)) * NJ + JBegin + K] =
+              Buff[(IOuter * NTot + IExch) * NK + K];
+       });
+} // end unpackDeviceBuffer
+
 /// The Halo class contains two nested classes, ExchList and Neighbor classes,
 /// defined below. The Halo class holds all the Neighbor objects needed by a
 /// task to perform a full halo exchange with each of its neighboring tasks for
 /// any array defined on the mesh. The local task ID and the MPI communicator
-/// handle are also stored here. NumLayers, MyElem, TotSize, and MyNeighbor are
-/// temporary variables utilized by the current halo exchange which are stored
-/// here for easy accesibility by the Halo methods.
+/// handle are also stored here. NumLayers, MyElem, TotSize, ExchSize,
+/// VertOffset, BuffPtr, MyNeighbor and MyPlan are temporary variables utilized
+/// by the current halo exchange which are stored here for easy accesibility by
+/// the Halo methods.
 class Halo {
+ public:
+   /// Forward declarations of the classes used to group arrays for a halo
+   /// exchange and to track split-phase exchanges, defined below
+   class ExchangeGroup;
+   class ExchangeHandle;
+
  private:
    const Decomp *MyDecomp{nullptr}; /// Pointer to decomposition object
 
@@ -53,11 +152,23 @@ class Halo {
    I4 HaloWidth;       /// cell width of halo
    I4 NumLayers;       /// number of halo layers for current exchange
    I4 TotSize;         /// Array size at each mesh element for current exchange
+   I4 ExchSize;        /// values exchanged at each element for current exchange
+   I4 VertOffset;      /// first vertical (last dim) index for current exchange
    MPI_Comm MyComm;    /// MPI communicator handle
    MeshElement MyElem; /// index space of current array
 
-   /// Forward Declaration of Neighbor class, defined below
+   /// Communication backend used for exchanges
+   HaloBackend Backend{PointToPoint};
+
+   /// Start of the current array in the buffer of the current Neighbor
+   char *BuffPtr{nullptr};
+
+   /// Flag set while a split-phase exchange is in progress
+   bool ExchangeActive{false};
+
+   /// Forward Declaration of Neighbor and ExchangePlan classes, defined below
    class Neighbor;
+   class ExchangePlan;
 
    /// Vector of Neighbor class objects for all neighboring tasks, contains
    /// all the exchange lists and buffer memory sufficient for a full halo
@@ -68,10 +179,34 @@ class Halo {
    /// in the Neighbors vector above
    std::vector<I4> NeighborList;
 
+   /// Distributed graph communicator with the neighboring tasks as both
+   /// sources and destinations, in the order of NeighborList, used by the
+   /// NeighborCollective backend. Shared by copies of a Halo and freed with
+   /// the last copy.
+   std::shared_ptr<MPI_Comm> GraphComm;
+
+   /// Communicator for the tasks on the local node, duplicated from the
+   /// MachEnv for the SharedMemory backend. Shared by copies of a Halo and
+   /// freed with the last copy.
+   std::shared_ptr<MPI_Comm> NodeComm;
+
+   /// Task ID in NodeComm of each neighboring task in the order of
+   /// NeighborList, or -1 if the neighbor is not on the local node or
+   /// shared memory is not used
+   std::vector<I4> NeighborNodeTask;
+
+   /// Exchange plans for each combination of arrays exchanged so far. Plans
+   /// are held by shared pointers since the persistent MPI requests they
+   /// contain refer to their buffers, so copies of a Halo share the plans.
+   std::vector<std::shared_ptr<ExchangePlan>> Plans;
+
    /// Pointer to current neighbor, utilized in the various member functions
    /// to make code more concise.
    Neighbor *MyNeighbor{nullptr};
 
+   /// Pointer to the plan of the current exchange
+   ExchangePlan *MyPlan{nullptr};
+
    /// The ExchList class contains the information needed to pack values from
    /// an array into a buffer or unpack values from a buffer into an array
    /// for a particular index space and neighbor
@@ -87,6 +222,14 @@ class Halo {
       /// indices of elements to be packed into the send buffer, or the local
       /// indices of elements unpacked from the receive buffer
       std::vector<std::vector<I4>> Ind;
+      /// Device copy of Ind collapsed along the halo layer dimension, used
+      /// by the pack and unpack kernels for device arrays
+      Array1DI4 IndDev;
+
+      /// Return the number of elements in the first NLayers halo layers.
+      /// Since the layers are stored one after another, these are the
+      /// first entries of the buffer and of IndDev.
+      I4 numElems(I4 NLayers) const;
 
       /// The constructor for the ExchList class takes as input an array of
       /// vectors, each containing a list of indices to be sent or received for
@@ -104,9 +247,8 @@ class Halo {
       friend class Neighbor;
    }; // end class ExchList
 
-   /// The Neighbor class contains all the information and buffer memory
-   /// needed to carry out a halo exchange in each index space for one
-   /// neighboring task.
+   /// The Neighbor class contains all the information needed to carry out a
+   /// halo exchange in each index space for one neighboring task.
    class Neighbor {
     private:
       I4 TaskID; /// ID of neighboring task
@@ -114,16 +256,6 @@ class Halo {
       /// Arrays of ExchList objects for sends and recieves for each
       /// index space. 0 = OnCell, 1 = OnEdge, 2 = OnVertex
       ExchList SendLists[3], RecvLists[3];
-      /// Buffers for MPI communication
-      std::vector<Real> SendBuffer, RecvBuffer;
-      /// MPI request handles for non-blocking MPI communication
-      MPI_Request RReq, SReq;
-
-      // Flags to track whether a message has been received and whether
-      // the buffer has been unpacked yet. The MPI_Test routine requires an
-      // integer, so Received is stored as an I4.
-      I4 Received{false};
-      bool Unpacked{false};
 
       /// Neighbor constructor takes takes as input six unique vectors of
       /// vectors containing the indices of array elements to send or receive
@@ -142,8 +274,89 @@ class Halo {
 
    }; // end class Neighbor
 
+   /// The ExchangePlan class contains the buffer memory and persistent MPI
+   /// requests needed to exchange one combination of arrays with each
+   /// neighboring task. A combination is identified by the index space,
+   /// array size at each mesh element and element size of each array, the
+   /// memory space of the arrays and the MPI data type of the messages. A
+   /// plan is created the first time a combination is exchanged and reused
+   /// by every later exchange of the same combination, so repeated exchanges
+   /// allocate no memory and only start and complete the existing requests.
+   /// For the SharedMemory backend, the send buffer of a host plan lives in
+   /// an MPI shared-memory window, and neighbors on the same node unpack
+   /// their messages directly from it instead of receiving a copy.
+   class ExchangePlan {
+    public:
+      /// Free the persistent MPI requests and shared-memory window if MPI is
+      /// still active
+      ~ExchangePlan();
+
+    private:
+      /// Index space, number of halo layers, number of values exchanged at
+      /// each mesh element and element size in bytes of each array, in the
+      /// order the arrays are packed
+      std::vector<I4> FieldShapes;
+      /// Flag set if the arrays reside on the device
+      bool OnDevice{false};
+      /// MPI data type of the messages and its size in bytes
+      MPI_Datatype MsgType{MPI_BYTE};
+      I4 MsgTypeSize{1};
+
+      /// Byte buffers for MPI communication holding the messages for all
+      /// Neighbors one after another, in the order of NeighborList. For
+      /// device arrays these serve as host staging buffers unless MPI is
+      /// device-aware.
+      std::vector<char> SendBuffer, RecvBuffer;
+      /// Device buffers used to pack and unpack device arrays
+      Array1DByte SendBufferDev, RecvBufferDev;
+      /// Buffers passed to MPI, either the host buffers above or the device
+      /// buffers for device arrays when MPI is device-aware
+      char *MPISendBuffer{nullptr};
+      char *MPIRecvBuffer{nullptr};
+      /// Number of bytes to send to and receive from each Neighbor and the
+      /// start of the message for each Neighbor in the buffers
+      std::vector<I4> SendSizes, RecvSizes, SendOffsets, RecvOffsets;
+      /// Message sizes and offsets in units of MsgType for the
+      /// NeighborCollective backend
+      std::vector<int> SendCounts, RecvCounts, SendDispls, RecvDispls;
+      /// Persistent MPI requests for the receives and sends with each
+      /// Neighbor for the PointToPoint backend, in the order they appear in
+      /// NeighborList. Stored contiguously so they can be passed to
+      /// MPI_Startall, MPI_Waitany and MPI_Waitall.
+      std::vector<MPI_Request> RecvReqs, SendReqs;
+      /// MPI request for the NeighborCollective backend
+      MPI_Request CollReq{MPI_REQUEST_NULL};
+      /// Indices of the Neighbors exchanged with MPI messages, in the order
+      /// of the persistent requests, and of the Neighbors on the local node
+      /// exchanged through shared memory
+      std::vector<I4> MsgNghbrs, NodeNghbrs;
+      /// Start of the message received from each Neighbor, either in the
+      /// receive buffer or in the shared send buffer of a neighbor on the
+      /// local node
+      std::vector<char *> RecvPtrs;
+      /// Shared-memory window holding the send buffer for the SharedMemory
+      /// backend, or MPI_WIN_NULL if shared memory is not used
+      MPI_Win Win{MPI_WIN_NULL};
+      /// Non-blocking node barriers signalling that all tasks on the node
+      /// have packed their shared send buffers (Ready) and have finished
+      /// unpacking from them (Done)
+      MPI_Request NodeReadyReq{MPI_REQUEST_NULL};
+      MPI_Request NodeDoneReq{MPI_REQUEST_NULL};
+
+      /// Halo is a friend class to allow access to private members
+      /// of the class
+      friend class Halo;
+
+   }; // end class ExchangePlan
+
    // Private methods
 
+   /// Determine the neighboring tasks, which either own halo elements of the
+   /// local task in any index space or need locally owned elements for their
+   /// own halos, and save them in NeighborList and NNghbr. Utilized only
+   /// during halo construction
+   int findNeighbors();
+
    /// Send a vector of integers to each neighboring task and receive a vector
    /// of integers from each neighboring task. The first dimension of each
    /// input 2D vector represents the task in the order they appear in
@@ -163,165 +376,403 @@ class Halo {
                          std::vector<std::vector<std::vector<I4>>> &RecvLists,
                          const MeshElement IndexSpace);
 
-   /// Allocate the recieve buffers and call MPI_Irecv for each Neighbor
+   /// Return the plan for exchanging the arrays in the input Group, creating
+   /// the plan with its buffers and persistent requests on first use.
+   /// Returns a null pointer if the plan could not be created.
+   ExchangePlan *getPlan(const ExchangeGroup &Group);
+
+   /// Allocate the send buffer of a new plan in a shared-memory window on
+   /// the local node and locate the messages of the Neighbors on the node
+   /// in their shared send buffers. Collective over the node.
+   int createSharedBuffer(ExchangePlan *Plan, I4 SendTotal);
+
+   /// Set the member variables describing the array of the current exchange
+   /// (MyElem, NumLayers, TotSize, ExchSize, VertOffset) for an array
+   /// registered in a group. InLayers of zero selects all halo layers.
+   void setCurrentField(MeshElement InElem, I4 InTotSize, I4 InExchSize,
+                        I4 InLayers, I4 InVertBegin);
+
+   /// Return the number of buffer bytes used by the current array for the
+   /// input exchange list, including the padding that aligns the next array
+   I4 currentBufferSize(I4 TypeSize, const ExchList &List) const;
+
+   /// Start the persistent receive requests of the current plan. Nothing is
+   /// done for the NeighborCollective backend, which receives in startSends.
    int startReceives();
 
-   /// Call MPI_Isend for each Neighbor to send the packed buffers to
-   /// the neighboring tasks
+   /// Start the persistent send requests of the current plan to send the
+   /// packed buffers to the neighboring tasks, or start the neighborhood
+   /// collective for the NeighborCollective backend
    int startSends();
 
-   /// Buffer pack functions overloaded to each supported YAKL array type.
-   /// Select out the proper elements from the input Array to send to a
-   /// neighboring task and pack them into SendBuffer for that Neighbor
-   int packBuffer(const ArrayHost1DI4 Array);
-   int packBuffer(const ArrayHost1DI8 Array);
-   int packBuffer(const ArrayHost1DR4 Array);
-   int packBuffer(const ArrayHost1DR8 Array);
-   int packBuffer(const ArrayHost2DI4 Array);
-   int packBuffer(const ArrayHost2DI8 Array);
-   int packBuffer(const ArrayHost2DR4 Array);
-   int packBuffer(const ArrayHost2DR8 Array);
-   int packBuffer(const ArrayHost3DI4 Array);
-   int packBuffer(const ArrayHost3DI8 Array);
-   int packBuffer(const ArrayHost3DR4 Array);
-   int packBuffer(const ArrayHost3DR8 Array);
-   int packBuffer(const ArrayHost4DI4 Array);
-   int packBuffer(const ArrayHost4DI8 Array);
-   int packBuffer(const ArrayHost4DR4 Array);
-   int packBuffer(const ArrayHost4DR8 Array);
-   int packBuffer(const ArrayHost5DI4 Array);
-   int packBuffer(const ArrayHost5DI8 Array);
-   int packBuffer(const ArrayHost5DR4 Array);
-   int packBuffer(const ArrayHost5DR8 Array);
-
-   /// Buffer unpack functions overloaded to each supported YAKL array type.
-   /// After receiving a message from a neighboring task, save the elements
-   /// of RecvBuffer for that Neighbor into the corresponding halo elements
-   /// of the input Array
-   int unpackBuffer(ArrayHost1DI4 &Array);
-   int unpackBuffer(ArrayHost1DI8 &Array);
-   int unpackBuffer(ArrayHost1DR4 &Array);
-   int unpackBuffer(ArrayHost1DR8 &Array);
-   int unpackBuffer(ArrayHost2DI4 &Array);
-   int unpackBuffer(ArrayHost2DI8 &Array);
-   int unpackBuffer(ArrayHost2DR4 &Array);
-   int unpackBuffer(ArrayHost2DR8 &Array);
-   int unpackBuffer(ArrayHost3DI4 &Array);
-   int unpackBuffer(ArrayHost3DI8 &Array);
-   int unpackBuffer(ArrayHost3DR4 &Array);
-   int unpackBuffer(ArrayHost3DR8 &Array);
-   int unpackBuffer(ArrayHost4DI4 &Array);
-   int unpackBuffer(ArrayHost4DI8 &Array);
-   int unpackBuffer(ArrayHost4DR4 &Array);
-   int unpackBuffer(ArrayHost4DR8 &Array);
-   int unpackBuffer(ArrayHost5DI4 &Array);
-   int unpackBuffer(ArrayHost5DI8 &Array);
-   int unpackBuffer(ArrayHost5DR4 &Array);
-   int unpackBuffer(ArrayHost5DR8 &Array);
+   /// Pack each array in the input Group into the send buffer for the
+   /// Neighbor with index INghbr
+   int packNeighbor(I4 INghbr, const ExchangeGroup &Group);
+
+   /// Unpack the receive buffer for the Neighbor with index INghbr into each
+   /// array in the input Group
+   int unpackNeighbor(I4 INghbr, const ExchangeGroup &Group);
+
+   /// Copy the message received from the Neighbor with index INghbr into its
+   /// device receive buffer before unpacking device arrays
+   int stageRecvBuffer(I4 INghbr);
+
+   //---------------------------------------------------------------------------
+   /// Function template to select out the proper elements from the input
+   /// Array of any supported type to send to the current Neighbor and pack
+   /// them into its send buffer, starting at BuffPtr. The values are
+   /// stored in the buffer in the native type of the array. The array is
+   /// viewed as (NOuter, NElem, NJ), where NElem is the mesh element
+   /// dimension, so the same loop serves arrays of every rank. Only the
+   /// first NumLayers halo layers and the values of the last (vertical)
+   /// dimension starting at VertOffset, ExchSize values per mesh element in
+   /// all, are packed. Device arrays
+   /// are packed into the device buffer with a parallel kernel.
+   template <typename T> int packBuffer(const T &Array) {
+
+      using ValType    = typename T::type;
+      ExchList *MyList = &MyNeighbor->SendLists[MyElem];
+      I4 NTot          = MyList->numElems(NumLayers);
+
+      if (NTot == 0 or ExchSize == 0)
+         return 0;
+
+      I4 Rank   = Array.get_rank();
+      I4 NJ     = (Rank > 1) ? Array.extent(Rank - 1) : 1;
+      I4 NElem  = (Rank > 1) ? Array.extent(Rank - 2) : Array.extent(0);
+      I4 NOuter = TotSize / NJ;
+      I4 NK     = ExchSize / NOuter;
+
+      const ValType *ArrayPtr = Array.data();
+      ValType *Buff           = reinterpret_cast<ValType *>(BuffPtr);
+
+      if constexpr (IsDeviceArray<T>::value) {
+         packDeviceBuffer(Buff, ArrayPtr, MyList->IndDev, NTot, NOuter, NElem,
+                          NJ, VertOffset, NK);
+      } else {
+         for (int IOuter = 0; IOuter < NOuter; ++IOuter) {
+            for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
+               for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
+                  I4 IBuff = IOuter * NTot + MyList->Offsets[ILayer] + IExch;
+                  I4 IArr  = IOuter * NElem + MyList->Ind[ILayer][IExch];
+                  for (int K = 0; K < NK; ++K) {
+                     Buff[IBuff * NK + K] =
+                         ArrayPtr[IArr * NJ + VertOffset + K];
+                  }
+               }
+            }
+         }
+      }
+
+      return 0;
+   } // end packBuffer
+
+   //---------------------------------------------------------------------------
+   /// Function template to save the elements of the receive buffer of the
+   /// current Neighbor, starting at BuffPtr, into the corresponding
+   /// halo elements of the input Array of any supported type after receiving
+   /// a message from a neighboring task. This is the inverse of packBuffer,
+   /// and device arrays are unpacked from the device buffer with a parallel
+   /// kernel.
+   template <typename T> int unpackBuffer(T &Array) {
+
+      using ValType    = typename T::type;
+      ExchList *MyList = &MyNeighbor->RecvLists[MyElem];
+      I4 NTot          = MyList->numElems(NumLayers);
+
+      if (NTot == 0 or ExchSize == 0)
+         return 0;
+
+      I4 Rank   = Array.get_rank();
+      I4 NJ     = (Rank > 1) ? Array.extent(Rank - 1) : 1;
+      I4 NElem  = (Rank > 1) ? Array.extent(Rank - 2) : Array.extent(0);
+      I4 NOuter = TotSize / NJ;
+      I4 NK     = ExchSize / NOuter;
+
+      ValType *ArrayPtr   = Array.data();
+      const ValType *Buff = reinterpret_cast<const ValType *>(BuffPtr);
+
+      if constexpr (IsDeviceArray<T>::value) {
+         unpackDeviceBuffer(Buff, ArrayPtr, MyList->IndDev, NTot, NOuter,
+                            NElem, NJ, VertOffset, NK);
+      } else {
+         for (int IOuter = 0; IOuter < NOuter; ++IOuter) {
+            for (int ILayer = 0; ILayer < NumLayers; ++ILayer) {
+               for (int IExch = 0; IExch < MyList->NList[ILayer]; ++IExch) {
+                  I4 IBuff = IOuter * NTot + MyList->Offsets[ILayer] + IExch;
+                  I4 IArr  = IOuter * NElem + MyList->Ind[ILayer][IExch];
+                  for (int K = 0; K < NK; ++K) {
+                     ArrayPtr[IArr * NJ + VertOffset + K] =
+                         Buff[IBuff * NK + K];
+                  }
+               }
+            }
+         }
+      }
+
+      return 0;
+   } // end unpackBuffer
 
  public:
+   /// The ExchangeGroup class collects several arrays, possibly of different
+   /// types, ranks and index spaces, so that their halos can be exchanged
+   /// together. Each registered array is packed into the same buffer for each
+   /// neighboring task, so the whole group is exchanged with a single message
+   /// per neighbor. All arrays in a group must reside in the same memory
+   /// space (host or device). Arrays are held as shallow copies, so a group
+   /// can be registered once and exchanged repeatedly.
+   class ExchangeGroup {
+    public:
+      //------------------------------------------------------------------------
+      // Function template to add an array of any supported type defined on
+      // the index space ThisElem to the group. By default all halo layers
+      // and the full last (vertical) dimension are exchanged. Optionally,
+      // only the first NLayers halo layers and the vertical indices from
+      // VertBegin up to (not including) VertEnd are exchanged, where
+      // NLayers of zero selects all layers and a negative VertEnd selects
+      // the end of the last dimension.
+      template <typename T>
+      int registerField(T &Array,             // YAKL array of any type
+                        MeshElement ThisElem, // index space Array is defined on
+                        I4 NLayers   = 0,     // halo layers to exchange
+                        I4 VertBegin = 0,     // first vertical index
+                        I4 VertEnd   = -1     // end of vertical range
+      ) {
+
+         bool ArrayOnDevice = IsDeviceArray<T>::value;
+         if (not Fields.empty() and ArrayOnDevice != OnDevice) {
+            LOG_ERROR("Halo: host and device arrays cannot be registered in "
+                      "the same exchange group");
+            return -1;
+         }
+         OnDevice = ArrayOnDevice;
+
+         // Determine the number of array elements per cell, edge, or vertex
+         // in the input array
+         yakl::Dims MyDims = Array.get_dimensions();
+         I4 NDims          = MyDims.size();
+         I4 ArraySize      = 1;
+         if (NDims == 2) {
+            ArraySize = MyDims[1];
+         } else if (NDims > 2) {
+            for (int I = 0; I < NDims - 2; ++I) {
+               ArraySize *= MyDims[I];
+            }
+            ArraySize *= MyDims[NDims - 1];
+         }
+
+         // Check the requested halo layers and vertical range. The number
+         // of layers is checked against the halo width when exchanged.
+         I4 NVert = (NDims > 1) ? MyDims[NDims - 1] : 1;
+         if (VertEnd < 0)
+            VertEnd = NVert;
+         if (NLayers < 0 or VertBegin < 0 or VertEnd > NVert or
+             VertBegin > VertEnd) {
+            LOG_ERROR("Halo: invalid halo layers {} or vertical range [{},{}) "
+                      "for array with vertical size {}",
+                      NLayers, VertBegin, VertEnd, NVert);
+            return -1;
+         }
+
+         // Messages are sent with the MPI type of the arrays if all arrays
+         // in the group share the same type, and as bytes otherwise
+         using ValType         = typename T::type;
+         MPI_Datatype ThisType = MPITypeOf<ValType>::value();
+         if (Fields.empty()) {
+            MsgType     = ThisType;
+            MsgTypeSize = sizeof(ValType);
+         } else if (ThisType != MsgType) {
+            MsgType     = MPI_BYTE;
+            MsgTypeSize = 1;
+         }
+
+         // Save shallow copies of the array in functions that select the
+         // proper pack and unpack instantiations for its type
+         Field NewField;
+         NewField.Elem      = ThisElem;
+         NewField.TotSize   = ArraySize;
+         NewField.TypeSize  = sizeof(ValType);
+         NewField.NLayers   = NLayers;
+         NewField.ExchSize  =
+             (NVert > 0) ? ArraySize / NVert * (VertEnd - VertBegin) : 0;
+         NewField.VertBegin = VertBegin;
+
+         NewField.Pack = [Array](Halo &MyHalo) {
+            return MyHalo.packBuffer(Array);
+         };
+
+         NewField.Unpack = [Array](Halo &MyHalo) mutable {
+            return MyHalo.unpackBuffer(Array);
+         };
+         Fields.push_back(NewField);
+
+         return 0;
+      } // end registerField
+
+      /// Return the number of arrays registered in the group
+      I4 getNumFields() const { return Fields.size(); }
+
+      /// Remove all arrays from the group
+      void clear() {
+         Fields.clear();
+         MsgType     = MPI_BYTE;
+         MsgTypeSize = 1;
+      }
+
+    private:
+      /// The Field class holds the information needed to pack and unpack one
+      /// registered array
+      class Field {
+       public:
+         MeshElement Elem; /// index space of the array
+         I4 TotSize;       /// Array size at each mesh element
+         I4 TypeSize;      /// size in bytes of each array value
+         I4 NLayers;       /// halo layers to exchange, zero for all
+         I4 ExchSize;      /// values exchanged at each mesh element
+         I4 VertBegin;     /// first vertical (last dim) index to exchange
+         /// Pack the array into the buffer of the current Neighbor
+         std::function<int(Halo &)> Pack;
+         /// Unpack the buffer of the current Neighbor into the array
+         std::function<int(Halo &)> Unpack;
+      };
+
+      /// Registered arrays in the order they are packed into the buffers
+      std::vector<Field> Fields;
+
+      /// Flag set if the registered arrays reside on the device
+      bool OnDevice{false};
+
+      /// MPI data type used for the messages of the group and its size in
+      /// bytes
+      MPI_Datatype MsgType{MPI_BYTE};
+      I4 MsgTypeSize{1};
+
+      /// Halo is a friend class to allow access to private members
+      friend class Halo;
+   }; // end class ExchangeGroup
+
+   /// The ExchangeHandle class tracks a split-phase halo exchange between the
+   /// calls to startExchange and finishExchange. It holds a copy of the group
+   /// of arrays being exchanged, so that finishExchange can unpack the
+   /// received buffers without depending on the types of the arrays.
+   class ExchangeHandle {
+    private:
+      /// Group of arrays being exchanged
+      ExchangeGroup Group;
+      /// Flag set by startExchange and cleared by finishExchange
+      bool Active{false};
+
+      /// Halo is a friend class to allow access to private members
+      friend class Halo;
+   }; // end class ExchangeHandle
+
    // Methods
 
-   // Construct a new halo for the input MachEnv and Decomp
-   Halo(const MachEnv *InEnv, const Decomp *InDecomp);
+   // Construct a new halo for the input MachEnv and Decomp, which exchanges
+   // halos using the input communication backend. With the
+   // NeighborCollective and SharedMemory backends, every task must perform
+   // the same sequence of exchanges, since exchanges (and for SharedMemory
+   // the creation of each exchange plan) are collective.
+   Halo(const MachEnv *InEnv, const Decomp *InDecomp,
+        HaloBackend InBackend = PointToPoint);
+
+   // Start a split-phase halo exchange of all the arrays registered in Group.
+   // Receives are posted and the halo elements owned by the local task are
+   // packed and sent, with one message for each neighboring task, then
+   // control returns to the caller while the messages are in flight. The
+   // exchange is completed by passing the returned Handle to finishExchange,
+   // and the halo elements of the arrays must not be accessed until then.
+   // Only one exchange may be in progress for a Halo at a time. If an error
+   // is returned, no exchange is left in progress and finishExchange must
+   // not be called.
+   int startExchange(const ExchangeGroup &Group, // arrays to exchange
+                     ExchangeHandle &Handle      // handle to finish exchange
+   );
 
    //---------------------------------------------------------------------------
-   // Function template to perform a full halo exchange on the input YAKL array
-   // of any supported type defined on the input index space ThisElem
+   // Function template to start a split-phase halo exchange on the input YAKL
+   // array of any supported type defined on the input index space ThisElem.
+   // This is a group exchange with a group containing only Array.
    template <typename T>
-   int
-   exchangeFullArrayHalo(T &Array,            // YAKL array of any type
-                         MeshElement ThisElem // index space Array is defined on
+   int startExchange(T &Array,              // YAKL array of any type
+                     MeshElement ThisElem,  // index space Array is defined on
+                     ExchangeHandle &Handle // handle to finish the exchange
    ) {
 
-      I4 IErr{0}; // error code
+      ExchangeGroup Group;
+      I4 IErr = Group.registerField(Array, ThisElem);
+      if (IErr != 0) {
+         LOG_ERROR("Halo: Error registering array for halo exchange");
+         return IErr;
+      }
 
-      // Logical flag to track if all messages have been received
-      bool AllReceived{false};
+      return startExchange(Group, Handle);
+   } // end startExchange
 
-      // Save the index space the input array is defined on
-      MyElem = ThisElem;
+   // Complete a split-phase halo exchange started by startExchange. Each
+   // received message is unpacked as soon as it arrives using MPI_Waitany,
+   // and then the function waits for all sends to complete. With the
+   // SharedMemory backend, messages from neighbors on the local node are
+   // unpacked from shared memory once all tasks on the node have packed.
+   int finishExchange(ExchangeHandle &Handle);
 
-      // For cell-based quantities, the number of halo layers equals HaloWidth,
-      // edge- and vertex-based quantities have an extra layer.
-      if (MyElem == OnCell) {
-         NumLayers = HaloWidth;
-      } else {
-         NumLayers = HaloWidth + 1;
-      }
+   // Perform a full halo exchange of all the arrays registered in Group
+   int exchangeGroupHalo(const ExchangeGroup &Group);
 
-      // Determine the number of array elements per cell, edge, or vertex
-      // in the input array
-      yakl::Dims MyDims = Array.get_dimensions();
-      I4 NDims          = MyDims.size();
-      if (NDims == 1) {
-         TotSize = 1;
-      } else if (NDims == 2) {
-         TotSize = MyDims[1];
-      } else {
-         TotSize = 1;
-         for (int I = 0; I < NDims - 2; ++I) {
-            TotSize *= MyDims[I];
-         }
-         TotSize *= MyDims[NDims - 1];
-      }
+   //---------------------------------------------------------------------------
+   // Function template to perform a halo exchange of only the first NLayers
+   // halo layers of the input YAKL array of any supported type defined on
+   // the input index space ThisElem, optionally limited to the vertical
+   // (last dimension) indices from VertBegin up to (not including) VertEnd.
+   // This is useful when a computation has only modified part of the halo,
+   // for example between the stages of a multi-stage time stepper.
+   template <typename T>
+   int exchangePartialArrayHalo(
+       T &Array,             // YAKL array of any type
+       MeshElement ThisElem, // index space Array is defined on
+       I4 NLayers,           // number of halo layers to exchange
+       I4 VertBegin = 0,     // first vertical index to exchange
+       I4 VertEnd   = -1     // end of vertical range, negative for all
+   ) {
 
-      // Allocate the receive buffers and Call MPI_Irecv for each Neighbor
-      // so the local task is ready to accept messages from each
-      // neighboring task
-      startReceives();
-
-      // Loop through each Neighbor and pack the buffers to be sent
-      // to each neighboring task
-      for (int INghbr = 0; INghbr < NNghbr; ++INghbr) {
-         MyNeighbor = &Neighbors[INghbr];
-         packBuffer(Array);
-         MyNeighbor->Received = false;
-         MyNeighbor->Unpacked = false;
+      ExchangeGroup Group;
+      I4 IErr = Group.registerField(Array, ThisElem, NLayers, VertBegin,
+                                    VertEnd);
+      if (IErr != 0) {
+         LOG_ERROR("Halo: Error registering array for partial exchange");
+         return IErr;
       }
 
-      // Call MPI_Isend for each Neighbor to send the packed buffers
-      startSends();
+      IErr = exchangeGroupHalo(Group);
+      if (IErr != 0)
+         LOG_ERROR("Halo: Error in partial halo exchange");
 
-      // Wait for all sends to complete before proceeding
-      for (int INghbr = 0; INghbr < NNghbr; ++INghbr) {
-         MyNeighbor = &Neighbors[INghbr];
-         MPI_Wait(&MyNeighbor->SReq, MPI_STATUS_IGNORE);
-      }
+      return IErr;
+   } // end exchangePartialArrayHalo
 
-      I4 MaxIter = 100000000; // Large integer to prevent infinite loop
-      I4 IPass   = 0;         // Number of passes through while loop
-      I4 NRcvd   = 0;         // Number of messages received
-
-      // Until all messages from neighboring tasks are received, loop
-      // through Neighbor objects and use MPI_Test to check if the message
-      // has been received
-      while (not AllReceived) {
-         for (int INghbr = 0; INghbr < NNghbr; ++INghbr) {
-            MyNeighbor = &Neighbors[INghbr];
-            if (not MyNeighbor->Received) {
-               MPI_Test(&MyNeighbor->RReq, &MyNeighbor->Received,
-                        MPI_STATUS_IGNORE);
-               if (MyNeighbor->Received) {
-                  NRcvd++;
-               }
-            }
-            if (MyNeighbor->Received and not MyNeighbor->Unpacked) {
-               unpackBuffer(Array);
-               MyNeighbor->Unpacked = true;
-            }
-         }
-         if (NRcvd == NNghbr) {
-            AllReceived = true;
-         }
-         ++IPass;
-         if (IPass == MaxIter) {
-            LOG_ERROR("Halo: Maximum iterations reached during halo exchange");
-            IErr = -1;
-            break;
-         }
+   //---------------------------------------------------------------------------
+   // Function template to perform a full halo exchange on the input YAKL array
+   // of any supported type defined on the input index space ThisElem
+   template <typename T>
+   int
+   exchangeFullArrayHalo(T &Array,            // YAKL array of any type
+                         MeshElement ThisElem // index space Array is defined on
+   ) {
+
+      I4 IErr{0}; // error code
+
+      ExchangeHandle Handle;
+
+      IErr = startExchange(Array, ThisElem, Handle);
+      if (IErr != 0) {
+         LOG_ERROR("Halo: Error starting halo exchange");
+         return IErr;
       }
 
+      IErr = finishExchange(Handle);
+      if (IErr != 0)
+         LOG_ERROR("Halo: Error finishing halo exchange");
+
       return IErr;
    } // end exchangeFullArrayHalo
 
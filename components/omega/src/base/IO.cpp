@@ -10,21 +10,341 @@
 #include "IO.h"
 #include "DataTypes.h"
 #include "Logging.h"
-// include "Config.h"
+#include "Config.h"
+#include "Timer.h"
 #include "mpi.h"
 #include "pio.h"
 
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <limits>
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace OMEGA {
 namespace IO {
 
 // Define global variables
 //------------------------------------------------------------------------------
-int SysID               = 0;
-FileFmt DefaultFileFmt  = FmtDefault;
-Rearranger DefaultRearr = RearrDefault;
+int SysID                       = 0;
+FileFmt DefaultFileFmt          = FmtDefault;
+Rearranger DefaultRearr         = RearrDefault;
+std::size_t AsyncMaxStagedBytes = std::size_t{1024} << 20;
+
+// Local variables
+//------------------------------------------------------------------------------
+namespace {
+
+// Communicator used to initialize the IO system
+MPI_Comm IOComm = MPI_COMM_NULL;
+
+// Registry of PIO decompositions so that identical decompositions are
+// only created once. Each entry is keyed by the data type, rearranger,
+// local size, global dimensions and the local global index array, and
+// keeps a count of the number of createDecomp calls that share it. A hash
+// of the index array is stored so that most mismatches are rejected
+// without comparing the full arrays.
+struct DecompEntry {
+   int IOSysID;
+   int VarType;
+   int Rearr;
+   int Size;
+   std::vector<int> DimLengths;
+   std::uint64_t IndxHash;
+   std::vector<int> GlobalIndx;
+   int RefCount;
+};
+std::map<int, DecompEntry> DecompRegistry;
+
+// Computes an FNV-1a hash of a global index array
+std::uint64_t
+hashIndices(const std::vector<int> &GlobalIndx, // [in] global indices
+            int Size                            // [in] number used
+) {
+   std::uint64_t Hash = 14695981039346656037ULL;
+   for (int i = 0; i < Size; ++i) {
+      std::uint64_t Val = static_cast<std::uint32_t>(GlobalIndx[i]);
+      for (int Byte = 0; Byte < 4; ++Byte) {
+         Hash ^= (Val >> (8 * Byte)) & 0xff;
+         Hash *= 1099511628211ULL;
+      }
+   }
+   return Hash;
+}
+
+// File format for each open file, used to determine whether compression
+// options can be applied to variables in the file
+std::map<int, int> FileFormats;
+
+// Number of significant digits retained for quantized variables, keyed by
+// file and variable ID
+std::map<std::pair<int, int>, int> QuantizeDigits;
+
+// Rounds the mantissa of each finite, non-fill value to the nearest value
+// with only KeepBits explicit mantissa bits (BitRound quantization)
+template <typename T, typename U>
+void bitRound(T *Data,       // [inout] array to be quantized
+              int Size,      // [in] size of array
+              const T *Fill, // [in] fill value (not modified) or null
+              int KeepBits   // [in] number of mantissa bits to keep
+) {
+   constexpr int MantBits = std::numeric_limits<T>::digits - 1;
+   if (KeepBits >= MantBits)
+      return;
+
+   const U Half = U(1) << (MantBits - KeepBits - 1);
+   const U Mask = ~((U(1) << (MantBits - KeepBits)) - 1);
+   for (int i = 0; i < Size; ++i) {
+      T Val = Data[i];
+      if (!std::isfinite(Val) || (Fill != nullptr && Val == *Fill))
+         continue;
+      U Bits;
+      std::memcpy(&Bits, &Val, sizeof(T));
+      Bits = (Bits + Half) & Mask;
+      std::memcpy(&Data[i], &Bits, sizeof(T));
+   }
+}
+
+// Quantizes a floating point array to the given number of significant
+// decimal digits. Arrays of other types are unchanged.
+void quantizeArray(void *Data,       // [inout] array to be quantized
+                   int Size,         // [in] size of array
+                   const void *Fill, // [in] fill value or null
+                   int VarType,      // [in] PIO data type of array
+                   int SigDigits     // [in] significant digits to keep
+) {
+   int KeepBits = static_cast<int>(std::ceil(SigDigits * std::log2(10.0)));
+   if (VarType == PIO_DOUBLE) {
+      bitRound<double, std::uint64_t>(static_cast<double *>(Data), Size,
+                                      static_cast<const double *>(Fill),
+                                      KeepBits);
+   } else if (VarType == PIO_REAL) {
+      bitRound<float, std::uint32_t>(static_cast<float *>(Data), Size,
+                                     static_cast<const float *>(Fill),
+                                     KeepBits);
+   }
+}
+
+// Returns the number of significant digits to retain when writing a
+// variable with a given decomposition, or zero if no quantization applies
+int writeSigDigits(int FileID,  // [in] ID of file being written
+                   int VarID,   // [in] ID of variable being written
+                   int DecompID // [in] decomposition of array
+) {
+   auto Digits = QuantizeDigits.find(std::make_pair(FileID, VarID));
+   if (Digits == QuantizeDigits.end())
+      return 0;
+   auto Decomp = DecompRegistry.find(DecompID);
+   if (Decomp == DecompRegistry.end())
+      return 0;
+   return Digits->second;
+}
+
+// Fills in automatic values for an IO task layout and adjusts the layout
+// if needed so that it fits within the communicator
+int checkLayout(const MPI_Comm &InComm, // [in] MPI communicator to use
+                int &NumIOTasks,        // [inout] number of IO tasks
+                int &IOStride,          // [inout] stride between IO tasks
+                int &IOBaseTask         // [inout] task of first IO task
+) {
+
+   int Err = 0;
+
+   int NumTasks;
+   MPI_Comm_size(InComm, &NumTasks);
+
+   // Fill in automatic values
+   if (NumIOTasks <= 0) {
+      int AutoStride;
+      Err = defaultLayout(InComm, NumIOTasks, AutoStride);
+      if (Err != 0)
+         return Err;
+      if (IOStride <= 0)
+         IOStride = AutoStride;
+   }
+   if (IOStride <= 0)
+      IOStride = std::max(1, NumTasks / NumIOTasks);
+
+   // Make sure the layout fits within the communicator
+   if (IOBaseTask < 0 || IOBaseTask >= NumTasks) {
+      LOG_WARN("IO: invalid IO base task {}, using 0", IOBaseTask);
+      IOBaseTask = 0;
+   }
+   if (NumIOTasks > NumTasks - IOBaseTask) {
+      LOG_WARN("IO: too many IO tasks ({}), reducing to {}", NumIOTasks,
+               NumTasks - IOBaseTask);
+      NumIOTasks = NumTasks - IOBaseTask;
+   }
+   if (IOBaseTask + (NumIOTasks - 1) * IOStride >= NumTasks) {
+      int NewStride = std::max(1, (NumTasks - 1 - IOBaseTask) /
+                                      std::max(1, NumIOTasks - 1));
+      LOG_WARN("IO: IO stride {} too large, reducing to {}", IOStride,
+               NewStride);
+      IOStride = NewStride;
+   }
+
+   return Err;
+}
+
+// Asynchronous writes are staged in host buffers and written by a single
+// background IO thread in the order they were submitted. Since the PIO
+// write is collective, every task must submit the same sequence of writes.
+// All other IO routines first drain the queue so that PIO calls from the
+// IO thread and the calling thread are never interleaved.
+struct AsyncWrite {
+   std::vector<char> Data; // staged copy of the array
+   std::vector<char> Fill; // staged copy of the fill value
+   int Size;               // local size of array
+   int FileID;             // ID of file to write to
+   int DecompID;           // decomposition ID for this var
+   int VarID;              // variable ID assigned by defineVar
+};
+
+class AsyncWriter {
+ public:
+   // Asynchronous writes are only used when MPI supports calls from
+   // multiple threads
+   bool Enabled = false;
+
+   // IO::finalize stops the IO thread before PIO and MPI are finalized. If
+   // it was not called, queued writes are discarded rather than performed
+   // during static destruction, possibly after MPI_Finalize.
+   ~AsyncWriter() {
+      {
+         std::lock_guard<std::mutex> Lock(Mutex);
+         Queue.clear();
+      }
+      stop();
+   }
+
+   // Returns a staging buffer of the requested size, reusing buffers from
+   // earlier writes when possible
+   std::vector<char> getBuffer(std::size_t Bytes) {
+      std::unique_lock<std::mutex> Lock(Mutex);
+      // Limit the memory used by staged writes. A single write larger
+      // than the limit is still accepted once the queue is empty.
+      DoneCV.wait(Lock, [&] {
+         return StagedBytes + Bytes <= AsyncMaxStagedBytes ||
+                (Queue.empty() && !Busy);
+      });
+      StagedBytes += Bytes;
+      std::vector<char> Buffer;
+      if (!Pool.empty()) {
+         Buffer = std::move(Pool.back());
+         Pool.pop_back();
+      }
+      Buffer.resize(Bytes);
+      return Buffer;
+   }
+
+   // Adds a staged write to the queue, starting the IO thread if needed
+   void push(AsyncWrite &&Write) {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      if (!Worker.joinable()) {
+         Stop   = false;
+         Worker = std::thread(&AsyncWriter::run, this);
+      }
+      Queue.push_back(std::move(Write));
+      WorkCV.notify_one();
+   }
+
+   // Waits until all queued writes have completed and returns the
+   // accumulated error code, which is then reset
+   int wait() {
+      std::unique_lock<std::mutex> Lock(Mutex);
+      DoneCV.wait(Lock, [&] { return Queue.empty() && !Busy; });
+      int Err = AsyncErr;
+      AsyncErr = 0;
+      return Err;
+   }
+
+   // Waits for all queued writes without resetting the error code
+   void drain() {
+      std::unique_lock<std::mutex> Lock(Mutex);
+      DoneCV.wait(Lock, [&] { return Queue.empty() && !Busy; });
+   }
+
+   // Completes any queued writes and shuts down the IO thread
+   void stop() {
+      {
+         std::lock_guard<std::mutex> Lock(Mutex);
+         Stop = true;
+         WorkCV.notify_one();
+      }
+      if (Worker.joinable())
+         Worker.join();
+   }
+
+ private:
+   std::mutex Mutex;
+   std::condition_variable WorkCV; // signals new work or stop
+   std::condition_variable DoneCV; // signals a completed write
+   std::deque<AsyncWrite> Queue;
+   std::vector<std::vector<char>> Pool;
+   std::thread Worker;
+   std::size_t StagedBytes = 0;
+   bool Busy               = false;
+   bool Stop               = false;
+   int AsyncErr            = 0;
+
+   // Main loop of the IO thread
+   void run() {
+      std::unique_lock<std::mutex> Lock(Mutex);
+      while (true) {
+         WorkCV.wait(Lock, [&] { return Stop || !Queue.empty(); });
+         if (Queue.empty())
+            break; // only reached when stopping with no work left
+
+         AsyncWrite Write = std::move(Queue.front());
+         Queue.pop_front();
+         Busy = true;
+         Lock.unlock();
+
+         void *Fill = Write.Fill.empty() ? nullptr : Write.Fill.data();
+         int Err    = PIOc_write_darray(Write.FileID, Write.VarID,
+                                        Write.DecompID, Write.Size,
+                                        Write.Data.data(), Fill);
+
+         Lock.lock();
+         if (Err != PIO_NOERR)
+            AsyncErr = Err;
+         StagedBytes -= Write.Data.size();
+         // Keep the staging buffer for reuse while writes are queued, but
+         // release all staging memory once the queue has drained
+         if (Queue.empty())
+            std::vector<std::vector<char>>().swap(Pool);
+         else
+            Pool.push_back(std::move(Write.Data));
+         Busy = false;
+         DoneCV.notify_all();
+      }
+   }
+};
+AsyncWriter AsyncIO;
+
+// Returns the size in bytes of an IO data type
+std::size_t typeBytes(int VarType // [in] PIO data type
+) {
+   switch (VarType) {
+   case PIO_INT64:
+   case PIO_DOUBLE:
+      return 8;
+   case PIO_CHAR:
+      return 1;
+   default:
+      return 4;
+   }
+}
+
+} // end anonymous namespace
 
 // Utilities
 //------------------------------------------------------------------------------
@@ -217,6 +537,48 @@ Precision PrecisionFromString(
 } // End PrecisionFromString
 
 // Methods
+//------------------------------------------------------------------------------
+// Computes a default IO task layout for a communicator. One IO task is
+// assigned to each node (shared-memory domain) and the stride is the number
+// of tasks per node so that IO tasks are spread evenly across nodes.
+int defaultLayout(const MPI_Comm &InComm, // [in] MPI communicator to use
+                  int &NumIOTasks,        // [out] number of IO tasks
+                  int &IOStride           // [out] stride between IO tasks
+) {
+
+   int Err = 0;
+
+   int NumTasks;
+   MPI_Comm_size(InComm, &NumTasks);
+
+   // Determine the number of tasks on this node and the number of nodes
+   MPI_Comm NodeComm;
+   Err = MPI_Comm_split_type(InComm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL,
+                             &NodeComm);
+   if (Err != MPI_SUCCESS) {
+      LOG_ERROR("IO::defaultLayout: error splitting communicator by node");
+      return Err;
+   }
+   int NodeTask;
+   int NodeSize;
+   MPI_Comm_rank(NodeComm, &NodeTask);
+   MPI_Comm_size(NodeComm, &NodeSize);
+   MPI_Comm_free(&NodeComm);
+
+   int IsNodeLead = (NodeTask == 0) ? 1 : 0;
+   int NumNodes;
+   int MaxNodeSize;
+   MPI_Allreduce(&IsNodeLead, &NumNodes, 1, MPI_INT, MPI_SUM, InComm);
+   MPI_Allreduce(&NodeSize, &MaxNodeSize, 1, MPI_INT, MPI_MAX, InComm);
+
+   // Place one IO task per node, assuming tasks are numbered by node
+   NumIOTasks = NumNodes;
+   IOStride   = std::max(1, std::min(MaxNodeSize, NumTasks / NumIOTasks));
+
+   return Err;
+
+} // end defaultLayout
+
 //------------------------------------------------------------------------------
 // Initializes the IO system based on configuration inputs and
 // default MPI communicator
@@ -224,20 +586,101 @@ int init(const MPI_Comm &InComm // [in] MPI communicator to use
 ) {
 
    int Err = 0; // success error code
-   // Retrieve parallel IO parameters from the Omega configuration
-   // TODO: replace with actual config, for now hardwired
-   // extern int SysID;
 
-   FileFmt DefaultFileFmt = FileFmtFromString("netcdf4c");
-   int NumIOTasks         = 1;
-   int IOStride           = 1;
-   int IOBaseTask         = 0;
-   Rearranger Rearrange   = RearrDefault;
+   // Set defaults. A value of zero for the number of IO tasks or the
+   // stride requests an automatic layout based on the node configuration.
+   int NumIOTasks            = 0;
+   int IOStride              = 0;
+   int IOBaseTask            = 0;
+   std::string RearrChoice   = "box";
+   std::string FileFmtChoice = "netcdf4c";
+   int AsyncMaxStagedMB      = 1024;
+
+   // Retrieve parallel IO parameters from the Omega configuration if
+   // present, otherwise keep the defaults
+   Config *OmegaConfig = Config::getOmegaConfig();
+   if (OmegaConfig->existsGroup("IO")) {
+      Config IOConfig("IO");
+      Err = OmegaConfig->get(IOConfig);
+      if (IOConfig.existsVar("IOTasks"))
+         Err += IOConfig.get("IOTasks", NumIOTasks);
+      if (IOConfig.existsVar("IOStride"))
+         Err += IOConfig.get("IOStride", IOStride);
+      if (IOConfig.existsVar("IOBaseTask"))
+         Err += IOConfig.get("IOBaseTask", IOBaseTask);
+      if (IOConfig.existsVar("IORearranger"))
+         Err += IOConfig.get("IORearranger", RearrChoice);
+      if (IOConfig.existsVar("IODefaultFormat"))
+         Err += IOConfig.get("IODefaultFormat", FileFmtChoice);
+      if (IOConfig.existsVar("IOAsyncMaxStagedMB"))
+         Err += IOConfig.get("IOAsyncMaxStagedMB", AsyncMaxStagedMB);
+      if (Err != 0) {
+         LOG_ERROR("IO::init: error reading IO configuration");
+         return Err;
+      }
+   }
+
+   Rearranger Rearr = RearrFromString(RearrChoice);
+   if (Rearr == RearrUnknown) {
+      LOG_ERROR("IO::init: unknown IO rearranger {}", RearrChoice);
+      return -1;
+   }
+   FileFmt Format = FileFmtFromString(FileFmtChoice);
+   if (Format == FmtUnknown) {
+      LOG_ERROR("IO::init: unknown IO file format {}", FileFmtChoice);
+      return -1;
+   }
+   if (AsyncMaxStagedMB <= 0) {
+      LOG_ERROR("IO::init: IOAsyncMaxStagedMB must be positive");
+      return -1;
+   }
+   AsyncMaxStagedBytes = static_cast<std::size_t>(AsyncMaxStagedMB) << 20;
+
+   Err = init(InComm, NumIOTasks, IOStride, IOBaseTask, Rearr, Format);
+
+   return Err;
+
+} // end init
+
+//------------------------------------------------------------------------------
+// Initializes the IO system with an explicit IO task layout, rearranger and
+// default file format. A zero value for the number of IO tasks or stride
+// selects the automatic default layout.
+int init(const MPI_Comm &InComm, // [in] MPI communicator to use
+         int NumIOTasks,         // [in] number of IO tasks (0 for auto)
+         int IOStride,           // [in] stride between IO tasks (0 for auto)
+         int IOBaseTask,         // [in] task of first IO task
+         Rearranger Rearr,       // [in] default rearranger
+         FileFmt Format          // [in] default file format
+) {
+
+   int Err = 0; // success error code
+
+   // Fill in automatic values and make sure the layout is valid
+   Err = checkLayout(InComm, NumIOTasks, IOStride, IOBaseTask);
+   if (Err != 0)
+      return Err;
+
+   LOG_INFO("IO::init: using {} IO tasks with stride {} starting at task {}",
+            NumIOTasks, IOStride, IOBaseTask);
+
+   // Save defaults for later use in file opens and decompositions
+   DefaultRearr   = Rearr;
+   DefaultFileFmt = Format;
+   IOComm         = InComm;
+
+   // Asynchronous writes use a separate IO thread so require full
+   // MPI thread support
+   int ThreadLevel = MPI_THREAD_SINGLE;
+   MPI_Query_thread(&ThreadLevel);
+   AsyncIO.Enabled = (ThreadLevel == MPI_THREAD_MULTIPLE);
+   if (!AsyncIO.Enabled)
+      LOG_INFO("IO::init: MPI_THREAD_MULTIPLE not available, asynchronous "
+               "writes will be performed synchronously");
 
    // Call PIO routine to initialize
-   DefaultRearr = Rearrange;
-   Err          = PIOc_Init_Intracomm(InComm, NumIOTasks, IOStride, IOBaseTask,
-                                      Rearrange, &SysID);
+   Err = PIOc_Init_Intracomm(InComm, NumIOTasks, IOStride, IOBaseTask, Rearr,
+                             &SysID);
    if (Err != 0)
       LOG_ERROR("IO::init: Error initializing SCORPIO");
 
@@ -245,6 +688,83 @@ int init(const MPI_Comm &InComm // [in] MPI communicator to use
 
 } // end init
 
+//------------------------------------------------------------------------------
+// Creates an additional IO system with its own IO task layout. The default
+// IO system is not changed.
+int createSystem(const MPI_Comm &InComm, // [in] MPI communicator to use
+                 int NumIOTasks,         // [in] number of IO tasks (0 for auto)
+                 int IOStride,           // [in] stride between IO tasks
+                 int IOBaseTask,         // [in] task of first IO task
+                 Rearranger Rearr,       // [in] rearranger for the system
+                 int &NewSysID           // [out] ID of the new IO system
+) {
+
+   int Err = checkLayout(InComm, NumIOTasks, IOStride, IOBaseTask);
+   if (Err != 0)
+      return Err;
+
+   LOG_INFO("IO::createSystem: using {} IO tasks with stride {} starting at "
+            "task {}",
+            NumIOTasks, IOStride, IOBaseTask);
+
+   Err = PIOc_Init_Intracomm(InComm, NumIOTasks, IOStride, IOBaseTask, Rearr,
+                             &NewSysID);
+   if (Err != PIO_NOERR)
+      LOG_ERROR("IO::createSystem: Error initializing SCORPIO");
+
+   return Err;
+
+} // end createSystem
+
+//------------------------------------------------------------------------------
+// Frees an IO system created by createSystem along with any decompositions
+// that were created while it was active
+int destroySystem(int &InSysID // [inout] ID of the IO system to free
+) {
+   AsyncIO.drain();
+
+   for (auto It = DecompRegistry.begin(); It != DecompRegistry.end();) {
+      if (It->second.IOSysID == InSysID)
+         It = DecompRegistry.erase(It);
+      else
+         ++It;
+   }
+
+   int Err = PIOc_finalize(InSysID);
+   if (Err != PIO_NOERR)
+      LOG_ERROR("IO::destroySystem: Error finalizing SCORPIO system");
+
+   return Err;
+
+} // end destroySystem
+
+//------------------------------------------------------------------------------
+// Finalizes the IO system, freeing all resources associated with it. The
+// IO system can be initialized again afterwards, eg with a different layout.
+int finalize() {
+
+   // Complete any pending writes and stop and join the IO thread, so that
+   // it never outlives the IO system or MPI
+   AsyncIO.stop();
+   int AsyncErr = AsyncIO.wait();
+   if (AsyncErr != 0)
+      LOG_ERROR("IO::finalize: Error in asynchronous write");
+
+   // All decompositions are freed with the IO system
+   DecompRegistry.clear();
+
+   int Err = PIOc_finalize(SysID);
+   if (Err != PIO_NOERR)
+      LOG_ERROR("IO::finalize: Error finalizing SCORPIO");
+
+   // Report a failure of either the pending writes or the finalize
+   if (Err == PIO_NOERR)
+      Err = AsyncErr;
+
+   return Err;
+
+} // end finalize
+
 //------------------------------------------------------------------------------
 // This routine opens a file for reading or writing, depending on the
 // Mode argument. The filename with full path must be supplied and
@@ -253,15 +773,19 @@ int init(const MPI_Comm &InComm // [in] MPI communicator to use
 // but can be optionally changed through this open function.
 // For files to be written, optional arguments govern the behavior to be
 // used if the file already exists, and the precision of any floating point
-// variables. Returns an error code.
+// variables. The file is opened with the default IO system unless another
+// system created by createSystem is supplied. Returns an error code.
 int openFile(
     int &FileID,                 // [out] returned fileID for this file
     const std::string &Filename, // [in] name (incl path) of file to open
     Mode InMode,                 // [in] mode (read or write)
     FileFmt InFormat,            // [in] (optional) file format
     IfExists InIfExists,         // [in] (for writes) behavior if file exists
-    Precision InPrecision        // [in] (for writes) precision of floats
+    Precision InPrecision,       // [in] (for writes) precision of floats
+    int InSysID                  // [in] (optional) IO system to use
 ) {
+   TimerScope FuncTimer("IO:openFile");
+   AsyncIO.drain();
 
    int Err    = 0;        // default success return code
    int Format = InFormat; // coerce to integer for PIO calls
@@ -270,7 +794,8 @@ int openFile(
 
    // If reading, open the file for read-only
    case ModeRead:
-      Err = PIOc_openfile(SysID, &FileID, &Format, Filename.c_str(), InMode);
+      Err =
+          PIOc_openfile(InSysID, &FileID, &Format, Filename.c_str(), InMode);
       if (Err != PIO_NOERR)
          LOG_ERROR("IO::openFile: PIO error opening file {} for read",
                    Filename);
@@ -284,7 +809,7 @@ int openFile(
       // If the write should be a new file and fail if the
       // file exists, we use create and fail with an error
       case IfExists::Fail:
-         Err = PIOc_createfile(SysID, &FileID, &Format, Filename.c_str(),
+         Err = PIOc_createfile(InSysID, &FileID, &Format, Filename.c_str(),
                                NC_NOCLOBBER | InMode);
          if (Err != PIO_NOERR)
             LOG_ERROR("IO::openFile: PIO error opening file {} for writing",
@@ -294,7 +819,7 @@ int openFile(
       // If the write should replace any existing file
       // we use create with the CLOBBER option
       case IfExists::Replace:
-         Err = PIOc_createfile(SysID, &FileID, &Format, Filename.c_str(),
+         Err = PIOc_createfile(InSysID, &FileID, &Format, Filename.c_str(),
                                NC_CLOBBER | InMode);
          if (Err != PIO_NOERR)
             LOG_ERROR("IO::openFile: PIO error opening file {} for writing",
@@ -304,7 +829,8 @@ int openFile(
       // If the write should append or add to an existing file
       // we open the file for writing
       case IfExists::Append:
-         Err = PIOc_openfile(SysID, &FileID, &Format, Filename.c_str(), InMode);
+         Err =
+          PIOc_openfile(InSysID, &FileID, &Format, Filename.c_str(), InMode);
          if (Err != PIO_NOERR)
             LOG_ERROR("IO::openFile: PIO error opening file {} for writing",
                       Filename);
@@ -322,6 +848,9 @@ int openFile(
 
    } // End switch on Mode
 
+   if (Err == PIO_NOERR)
+      FileFormats[FileID] = Format;
+
    return Err;
 
 } // End openFile
@@ -329,12 +858,37 @@ int openFile(
 // Closes an open file using the fileID, returns an error code
 int closeFile(int &FileID /// [in] ID of the file to be closed
 ) {
-   // Just calls the PIO close routine
+   TimerScope FuncTimer("IO:closeFile");
+   AsyncIO.drain();
+
+   // Remove any compression settings for this file
+   FileFormats.erase(FileID);
+   for (auto It = QuantizeDigits.begin(); It != QuantizeDigits.end();) {
+      if (It->first.first == FileID)
+         It = QuantizeDigits.erase(It);
+      else
+         ++It;
+   }
+
    int Err = PIOc_closefile(FileID);
    return Err;
 
 } // End closeFile
 
+//------------------------------------------------------------------------------
+// Checks whether a variable exists in a file
+bool existsVar(int FileID,                // [in] ID of the file to check
+               const std::string &VarName // [in] name of variable
+) {
+   AsyncIO.drain();
+
+   int VarID = 0;
+   int Err   = PIOc_inq_varid(FileID, VarName.c_str(), &VarID);
+
+   return (Err == PIO_NOERR);
+
+} // End existsVar
+
 //------------------------------------------------------------------------------
 // Retrieves a dimension length from an input file, given the name
 // of the dimension. Returns the length if exists, but returns a negative
@@ -342,6 +896,7 @@ int closeFile(int &FileID /// [in] ID of the file to be closed
 int getDimLength(int FileID, // [in] ID of the file containing dim
                  const std::string &DimName // [in] name of dimension
 ) {
+   AsyncIO.drain();
 
    int Err = 0; // Local error code
 
@@ -373,6 +928,7 @@ int defineDim(int FileID,                 // [in] ID of the file containing dim
               int Length,                 // [in] length of dimension
               int &DimID                  // [out] dimension id assigned
 ) {
+   AsyncIO.drain();
 
    int Err = 0;
 
@@ -396,6 +952,7 @@ int writeMeta(const std::string &MetaName, // [in] name of metadata
               int FileID,                  // [in] ID of the file for writing
               int VarID // [in] ID for variable associated with metadata
 ) {
+   AsyncIO.drain();
 
    int Err             = 0;
    IODataType MetaType = IOTypeI4;
@@ -417,6 +974,7 @@ int writeMeta(const std::string &MetaName, // [in] name of metadata
               int FileID,                  // [in] ID of the file for writing
               int VarID // [in] ID for variable associated with metadata
 ) {
+   AsyncIO.drain();
 
    int Err             = 0;
    IODataType MetaType = IOTypeI8;
@@ -438,6 +996,7 @@ int writeMeta(const std::string &MetaName, // [in] name of metadata
               int FileID,                  // [in] ID of the file for writing
               int VarID // [in] ID for variable associated with metadata
 ) {
+   AsyncIO.drain();
 
    int Err             = 0;
    IODataType MetaType = IOTypeR4;
@@ -459,6 +1018,7 @@ int writeMeta(const std::string &MetaName, // [in] name of metadata
               int FileID,                  // [in] ID of the file for writing
               int VarID // [in] ID for variable associated with metadata
 ) {
+   AsyncIO.drain();
 
    int Err             = 0;
    IODataType MetaType = IOTypeR8;
@@ -480,6 +1040,7 @@ int writeMeta(const std::string &MetaName, // [in] name of metadata
               int FileID,                  // [in] ID of the file for writing
               int VarID // [in] ID for variable associated with metadata
 ) {
+   AsyncIO.drain();
 
    int Err             = 0;
    IODataType MetaType = IOTypeChar;
@@ -506,6 +1067,8 @@ int readMeta(const std::string &MetaName, // [in] name of metadata
              int FileID,                  // [in] ID of the file for writing
              int VarID // [in] ID for variable associated with metadata
 ) {
+   AsyncIO.drain();
+
    int Err = 0;
 
    Err = PIOc_get_att(FileID, VarID, MetaName.c_str(), &MetaValue);
@@ -523,6 +1086,8 @@ int readMeta(const std::string &MetaName, // [in] name of metadata
              int FileID,                  // [in] ID of the file for writing
              int VarID // [in] ID for variable associated with metadata
 ) {
+   AsyncIO.drain();
+
    int Err = 0;
 
    Err = PIOc_get_att(FileID, VarID, MetaName.c_str(), &MetaValue);
@@ -540,6 +1105,8 @@ int readMeta(const std::string &MetaName, // [in] name of metadata
              int FileID,                  // [in] ID of the file for writing
              int VarID // [in] ID for variable associated with metadata
 ) {
+   AsyncIO.drain();
+
    int Err = 0;
 
    Err = PIOc_get_att(FileID, VarID, MetaName.c_str(), &MetaValue);
@@ -557,6 +1124,8 @@ int readMeta(const std::string &MetaName, // [in] name of metadata
              int FileID,                  // [in] ID of the file for writing
              int VarID // [in] ID for variable associated with metadata
 ) {
+   AsyncIO.drain();
+
    int Err = 0;
 
    Err = PIOc_get_att(FileID, VarID, MetaName.c_str(), &MetaValue);
@@ -574,6 +1143,8 @@ int readMeta(const std::string &MetaName, // [in] name of metadata
              int FileID,                  // [in] ID of the file for writing
              int VarID // [in] ID for variable associated with metadata
 ) {
+   AsyncIO.drain();
+
    int Err = 0;
 
    // For string variables, find the length of the string first
@@ -610,15 +1181,72 @@ int defineVar(int FileID,                 // [in] ID of the file containing dim
               IODataType VarType,         // [in] data type for the variable
               int NDims,                  // [in] number of dimensions
               int *DimIDs,                // [in] vector of NDims dimension IDs
-              int &VarID                  // [out] id assigned to this variable
+              int &VarID,                 // [out] id assigned to this variable
+              const Compression &Compress // [in] compression settings
 ) {
+   AsyncIO.drain();
 
    int Err = 0;
 
    Err = PIOc_def_var(FileID, VarName.c_str(), VarType, NDims, DimIDs, &VarID);
    if (Err != PIO_NOERR) {
       LOG_ERROR("IO::defineVar: PIO error while defining variable");
-      Err = -1;
+      return -1;
+   }
+
+   // Apply compression settings if requested
+   if (Compress.DeflateLevel <= 0 && !Compress.Shuffle &&
+       Compress.SigDigits <= 0 && Compress.ChunkSizes.empty())
+      return Err;
+
+   // Compression filters and chunking are only available in NetCDF4 files
+   auto Format = FileFormats.find(FileID);
+   if (Format == FileFormats.end() || (Format->second != FmtNetCDF4c &&
+                                       Format->second != FmtNetCDF4p)) {
+      LOG_WARN("IO::defineVar: compression for variable {} ignored, only "
+               "supported for NetCDF4 formats",
+               VarName);
+      return Err;
+   }
+
+   if (!Compress.ChunkSizes.empty()) {
+      if (static_cast<int>(Compress.ChunkSizes.size()) != NDims) {
+         LOG_ERROR("IO::defineVar: chunk sizes for variable {} do not "
+                   "match number of dimensions",
+                   VarName);
+         return -1;
+      }
+      std::vector<PIO_Offset> Chunks(Compress.ChunkSizes.begin(),
+                                     Compress.ChunkSizes.end());
+      Err = PIOc_def_var_chunking(FileID, VarID, NC_CHUNKED, Chunks.data());
+      if (Err != PIO_NOERR) {
+         LOG_ERROR("IO::defineVar: PIO error setting chunking for {}",
+                   VarName);
+         return -1;
+      }
+   }
+
+   if (Compress.DeflateLevel > 0 || Compress.Shuffle) {
+      int Level   = std::min(Compress.DeflateLevel, 9);
+      int Deflate = (Level > 0) ? 1 : 0;
+      int Shuffle = Compress.Shuffle ? 1 : 0;
+      Err = PIOc_def_var_deflate(FileID, VarID, Shuffle, Deflate, Level);
+      if (Err != PIO_NOERR) {
+         LOG_ERROR("IO::defineVar: PIO error setting deflate for {}",
+                   VarName);
+         return -1;
+      }
+   }
+
+   // Quantization is applied to the data when the variable is written
+   if (Compress.SigDigits > 0) {
+      if (VarType == IOTypeR4 || VarType == IOTypeR8) {
+         QuantizeDigits[std::make_pair(FileID, VarID)] = Compress.SigDigits;
+      } else {
+         LOG_WARN("IO::defineVar: quantization ignored for non-floating "
+                  "point variable {}",
+                  VarName);
+      }
    }
 
    return Err;
@@ -630,6 +1258,8 @@ int defineVar(int FileID,                 // [in] ID of the file containing dim
 /// have been written and the larger data sets can now be written
 int endDefinePhase(int FileID ///< [in] ID of the file being written
 ) {
+   AsyncIO.drain();
+
    int Err = 0;
 
    Err = PIOc_enddef(FileID);
@@ -644,7 +1274,10 @@ int endDefinePhase(int FileID ///< [in] ID of the file being written
 
 //------------------------------------------------------------------------------
 // Creates a PIO decomposition description to describe the layout of
-// a distributed array of given type.
+// a distributed array of given type, using the default IO system unless
+// another system is supplied. If an identical decomposition has already
+// been created, its ID is returned instead and its reference count is
+// incremented.
 int createDecomp(
     int &DecompID,      // [out] ID assigned to the new decomposition
     IODataType VarType, // [in] data type of array
@@ -652,11 +1285,44 @@ int createDecomp(
     const std::vector<int> &DimLengths, // [in] global dimension lengths
     int Size,                           // [in] local size of array
     const std::vector<int> &GlobalIndx, // [in] global indx for each local indx
-    Rearranger Rearr                    // [in] rearranger method to use
+    Rearranger Rearr,                   // [in] rearranger method to use
+    int InSysID                         // [in] (optional) IO system to use
 ) {
+   TimerScope FuncTimer("IO:createDecomp");
+   AsyncIO.drain();
 
    int Err = 0; // default return code
 
+   // Look for an identical decomposition that has already been created.
+   // The result must agree on all tasks since PIO decompositions are
+   // collective, so a match is only used if the same decomposition is found
+   // on every task, which is the case when the minimum and maximum of the
+   // matching IDs over all tasks are equal.
+   std::uint64_t IndxHash = hashIndices(GlobalIndx, Size);
+   std::vector<int> Dims(DimLengths.begin(), DimLengths.begin() + NDims);
+   int FoundID = -1;
+   for (const auto &Entry : DecompRegistry) {
+      const DecompEntry &Decomp = Entry.second;
+      if (Decomp.IOSysID == InSysID && Decomp.VarType == VarType &&
+          Decomp.Rearr == Rearr && Decomp.Size == Size &&
+          Decomp.IndxHash == IndxHash && Decomp.DimLengths == Dims &&
+          std::equal(GlobalIndx.begin(), GlobalIndx.begin() + Size,
+                     Decomp.GlobalIndx.begin())) {
+         FoundID = Entry.first;
+         break;
+      }
+   }
+   // The maximum is reduced as the minimum of the negated ID
+   int FoundRange[2] = {FoundID, -FoundID};
+   if (IOComm != MPI_COMM_NULL)
+      MPI_Allreduce(MPI_IN_PLACE, FoundRange, 2, MPI_INT, MPI_MIN, IOComm);
+
+   if (FoundRange[0] >= 0 && FoundRange[0] == -FoundRange[1]) {
+      DecompID = FoundID;
+      ++DecompRegistry[DecompID].RefCount;
+      return Err;
+   }
+
    // Convert global index array into an offset array expected by PIO
    std::vector<PIO_Offset> CompMap;
    CompMap.resize(Size);
@@ -665,24 +1331,44 @@ int createDecomp(
    } // end global index loop
 
    // Call the PIO routine to define the decomposition
-   // int TmpRearr = Rearr; // needed for type compliance across interface
-   // Err = PIOc_InitDecomp(SysID, VarType, NDims, DimLengths, Size, CompMap,
-   //                      &DecompID, &TmpRearr, nullptr, nullptr);
-   Err = PIOc_init_decomp(SysID, VarType, NDims, &DimLengths[0], Size,
+   Err = PIOc_init_decomp(InSysID, VarType, NDims, &DimLengths[0], Size,
                           &CompMap[0], &DecompID, Rearr, nullptr, nullptr);
-   if (Err != PIO_NOERR)
+   if (Err != PIO_NOERR) {
       LOG_ERROR("IOCreateDecomp: PIO error defining decomposition");
+      return Err;
+   }
+
+   // Add the new decomposition to the registry
+   std::vector<int> Indx(GlobalIndx.begin(), GlobalIndx.begin() + Size);
+   DecompRegistry[DecompID] = {InSysID, VarType,  Rearr,           Size,
+                               Dims,    IndxHash, std::move(Indx), 1};
 
    return Err;
 
 } // End createDecomp
 
 //------------------------------------------------------------------------------
-// Removes a defined PIO decomposition description to free memory
+// Removes a defined PIO decomposition description to free memory. If the
+// decomposition is shared by other createDecomp calls, only the reference
+// count is decremented and the decomposition is freed with the last call.
 int destroyDecomp(int &DecompID // [inout] ID for decomposition to be removed
 ) {
+   AsyncIO.drain();
 
-   int Err = PIOc_freedecomp(SysID, DecompID);
+   int Err = 0;
+
+   // Free the decomposition with the IO system it was created with
+   int DecompSysID = SysID;
+   auto Found      = DecompRegistry.find(DecompID);
+   if (Found != DecompRegistry.end()) {
+      --Found->second.RefCount;
+      if (Found->second.RefCount > 0)
+         return Err;
+      DecompSysID = Found->second.IOSysID;
+      DecompRegistry.erase(Found);
+   }
+
+   Err = PIOc_freedecomp(DecompSysID, DecompID);
    if (Err != PIO_NOERR)
       LOG_ERROR("IODestroyDecomp: PIO error freeing decomposition");
 
@@ -700,6 +1386,8 @@ int readArray(void *Array,                // [out] array to be read
               int DecompID,               // [in] decomposition ID for this var
               int &VarID // [out] Id assigned to variable for later use
 ) {
+   TimerScope FuncTimer("IO:readArray");
+   AsyncIO.drain();
 
    int Err = 0; // default return code
 
@@ -730,16 +1418,100 @@ int writeArray(void *Array,     // [in] array to be written
                int DecompID,    // [in] decomposition ID for this var
                int VarID        // [in] variable ID assigned by defineVar
 ) {
+   TimerScope FuncTimer("IO:writeArray");
+   AsyncIO.drain();
+
    int Err = 0;
 
    PIO_Offset Asize = Size;
 
+   // Quantized variables are rounded in a copy so the input is unchanged
+   int SigDigits = writeSigDigits(FileID, VarID, DecompID);
+   if (SigDigits > 0) {
+      int VarType = DecompRegistry[DecompID].VarType;
+      std::vector<char> Quantized(typeBytes(VarType) * std::max(Size, 0));
+      std::memcpy(Quantized.data(), Array, Quantized.size());
+      quantizeArray(Quantized.data(), Size, FillValue, VarType, SigDigits);
+      Err = PIOc_write_darray(FileID, VarID, DecompID, Asize,
+                              Quantized.data(), FillValue);
+      return Err;
+   }
+
    Err = PIOc_write_darray(FileID, VarID, DecompID, Asize, Array, FillValue);
 
    return Err;
 
 } // end writeArray
 
+//------------------------------------------------------------------------------
+// Writes a distributed array asynchronously. The array and fill value are
+// copied into staging buffers and queued for the background IO thread so
+// the caller can reuse the array immediately. If MPI does not support
+// multiple threads, the array is written synchronously.
+int writeArrayAsync(void *Array,     // [in] array to be written
+                    int Size,        // [in] size of array to be written
+                    void *FillValue, // [in] value to use for missing entries
+                    int FileID,      // [in] ID of open file to write to
+                    int DecompID,    // [in] decomposition ID for this var
+                    int VarID        // [in] variable ID assigned by defineVar
+) {
+
+   TimerScope FuncTimer("IO:writeArrayAsync");
+
+   if (!AsyncIO.Enabled)
+      return writeArray(Array, Size, FillValue, FileID, DecompID, VarID);
+
+   // The element size is determined from the data type of the decomposition
+   auto Found = DecompRegistry.find(DecompID);
+   if (Found == DecompRegistry.end()) {
+      LOG_ERROR("IO::writeArrayAsync: unknown decomposition {}", DecompID);
+      return -1;
+   }
+   std::size_t ElemBytes = typeBytes(Found->second.VarType);
+   std::size_t Bytes     = ElemBytes * std::max(Size, 0);
+
+   // Snapshot the array and fill value into staging buffers
+   AsyncWrite Write;
+   Write.Data = AsyncIO.getBuffer(Bytes);
+   if (Bytes > 0)
+      std::memcpy(Write.Data.data(), Array, Bytes);
+   if (FillValue != nullptr) {
+      Write.Fill.resize(ElemBytes);
+      std::memcpy(Write.Fill.data(), FillValue, ElemBytes);
+   }
+
+   // Quantize the staged copy if requested for this variable
+   int SigDigits = writeSigDigits(FileID, VarID, DecompID);
+   if (SigDigits > 0)
+      quantizeArray(Write.Data.data(), Size, FillValue, Found->second.VarType,
+                    SigDigits);
+
+   Write.Size     = Size;
+   Write.FileID   = FileID;
+   Write.DecompID = DecompID;
+   Write.VarID    = VarID;
+
+   AsyncIO.push(std::move(Write));
+
+   return 0;
+
+} // end writeArrayAsync
+
+//------------------------------------------------------------------------------
+// Waits for all outstanding asynchronous writes to complete and returns
+// an error code if any of them failed
+int waitAll() {
+
+   TimerScope FuncTimer("IO:waitAll");
+
+   int Err = AsyncIO.wait();
+   if (Err != 0)
+      LOG_ERROR("IO::waitAll: Error in asynchronous write");
+
+   return Err;
+
+} // end waitAll
+
 //------------------------------------------------------------------------------
 
 } // end namespace IO
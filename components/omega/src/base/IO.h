@@ -14,13 +14,16 @@
 /// # Basic parallel IO configuration
 /// IO:
 ///    # Number of MPI tasks to use for IO
-///    # Default is 1 for safety but should be set to a subset of the
-///    #  total MPI tasks for efficiency, eg to map efficiently to the
-///    #  underlying hardware (network interfaces, NVM, etc)
-///    IOTasks:  1
+///    # Default is 0, which places one IO task on each node. It can be set
+///    #  to a different subset of the total MPI tasks, eg to map
+///    #  efficiently to the underlying hardware (network interfaces, NVM)
+///    IOTasks:  0
 ///    # The stride in MPI tasks when the number of IO tasks is less
-///    #  than the total number of MPI tasks
-///    IOStride: 1
+///    #  than the total number of MPI tasks. Default is 0, which uses the
+///    #  number of tasks per node (or total tasks / IO tasks if IOTasks set)
+///    IOStride: 0
+///    # The MPI task of the first IO task
+///    IOBaseTask: 0
 ///    # When using parallel IO, the data must be rearranged to match
 ///    #  the IO task decomposition. Choices are box and subset. Box is
 ///    #  the default and generally preferred (ensures each IO task has
@@ -32,6 +35,10 @@
 ///    #  through the streams interface. Choices include all the various
 ///    #  netCDF file formats as well as the ADIOS format.
 ///    IODefaultFormat: NetCDF4
+///    # The maximum size in MB of array data staged for asynchronous
+///    #  writes. Once reached, further asynchronous writes wait for
+///    #  earlier writes to complete.
+///    IOAsyncMaxStagedMB: 1024
 /// \EndConfigInput
 //
 //===----------------------------------------------------------------------===//
@@ -40,8 +47,10 @@
 #include "mpi.h"
 #include "pio.h"
 
+#include <cstddef>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace OMEGA {
 namespace IO {
@@ -91,6 +100,19 @@ enum class Precision {
    Single, /// Reduce all floating point variables to 32-bit reals
 };
 
+/// Compression options for variables in NetCDF4/HDF5 files. Deflate and
+/// shuffle are applied as HDF5 filters. SigDigits quantizes floating point
+/// variables before writing by rounding the mantissa to the number of bits
+/// needed for the requested significant decimal digits, which greatly
+/// improves the subsequent deflate compression. The default is no
+/// compression and library default chunking.
+struct Compression {
+   int DeflateLevel = 0;        ///< deflate level (1-9), 0 for none
+   bool Shuffle     = false;    ///< apply the byte shuffle filter
+   int SigDigits    = 0;        ///< significant digits to keep, 0 for all
+   std::vector<int> ChunkSizes; ///< chunk size for each dim, empty for default
+};
+
 /// Data types for PIO corresponding to Omega types
 enum IODataType {
    IOTypeI4      = PIO_INT,    /// 32-bit integer
@@ -113,6 +135,12 @@ extern FileFmt DefaultFileFmt;
 /// be assumed if not overridden during file open.
 extern Rearranger DefaultRearr;
 
+/// Maximum number of bytes that may be staged for asynchronous writes
+/// before writeArrayAsync blocks waiting for earlier writes to complete.
+/// The default of 1 GiB can be changed with IOAsyncMaxStagedMB in the
+/// configuration.
+extern std::size_t AsyncMaxStagedBytes;
+
 // Utilities
 
 /// Converts string choice for PIO rearranger to an enum
@@ -139,10 +167,51 @@ Precision PrecisionFromString(
 // Methods
 
 /// Initializes the IO system based on configuration inputs and
-/// default MPI communicator
+/// default MPI communicator. If the IO group is not present in the
+/// configuration, an automatic layout with one IO task per node is used
+/// together with the box rearranger.
 int init(const MPI_Comm &InComm ///< [in] MPI communicator to use
 );
 
+/// Initializes the IO system with an explicit IO task layout, rearranger
+/// and default file format. A zero value for the number of IO tasks or the
+/// stride selects the automatic layout.
+int init(const MPI_Comm &InComm, ///< [in] MPI communicator to use
+         int NumIOTasks,         ///< [in] number of IO tasks (0 for auto)
+         int IOStride,           ///< [in] stride between IO tasks (0 for auto)
+         int IOBaseTask,         ///< [in] task of first IO task
+         Rearranger Rearr,       ///< [in] default rearranger
+         FileFmt Format          ///< [in] default file format
+);
+
+/// Computes the automatic IO task layout for a communicator, with one IO
+/// task on each node and a stride equal to the number of tasks per node.
+int defaultLayout(const MPI_Comm &InComm, ///< [in] MPI communicator to use
+                  int &NumIOTasks,        ///< [out] number of IO tasks
+                  int &IOStride           ///< [out] stride between IO tasks
+);
+
+/// Creates an additional IO system with its own IO task layout, eg to read
+/// large input files with more IO tasks than are used for output. The
+/// communicator must be the one used in init. The default system in SysID
+/// is not changed; NewSysID is instead passed to openFile and createDecomp
+/// to open files and create decompositions with the new system.
+int createSystem(const MPI_Comm &InComm, ///< [in] MPI communicator to use
+                 int NumIOTasks, ///< [in] number of IO tasks (0 for auto)
+                 int IOStride,   ///< [in] stride between IO tasks (0 for auto)
+                 int IOBaseTask, ///< [in] task of first IO task
+                 Rearranger Rearr, ///< [in] rearranger for the system
+                 int &NewSysID     ///< [out] ID of the new IO system
+);
+
+/// Frees an IO system created by createSystem, including any
+/// decompositions created with that system
+int destroySystem(int &InSysID ///< [inout] ID of the IO system to free
+);
+
+/// Finalizes the IO system so that it can be re-initialized
+int finalize();
+
 /// This routine opens a file for reading or writing, depending on the
 /// Mode argument. The filename with full path must be supplied and
 /// a FileID is returned to be used by other IO functions.
@@ -150,20 +219,28 @@ int init(const MPI_Comm &InComm ///< [in] MPI communicator to use
 /// but can be optionally changed through this open function.
 /// For files to be written, optional arguments govern the behavior to be
 /// used if the file already exists, and the precision of any floating point
-/// variables. Returns an error code.
+/// variables. The file is opened with the default IO system unless another
+/// system created by createSystem is supplied. Returns an error code.
 int openFile(
     int &FileID,                      ///< [out] returned fileID for this file
     const std::string &Filename,      ///< [in] name (incl path) of file to open
     Mode Mode,                        ///< [in] mode (read or write)
-    FileFmt Format      = FmtDefault, ///< [in] (optional) file format
-    IfExists IfExists   = IfExists::Fail,   ///< [in] behavior if file exists
-    Precision Precision = Precision::Double ///< [in] precision of floats
+    FileFmt Format      = DefaultFileFmt, ///< [in] (optional) file format
+    IfExists IfExists   = IfExists::Fail, ///< [in] behavior if file exists
+    Precision Precision = Precision::Double, ///< [in] precision of floats
+    int InSysID         = SysID ///< [in] (optional) IO system to use
 );
 
 /// Closes an open file using the fileID, returns an error code
 int closeFile(int &FileID /// [in] ID of the file to be closed
 );
 
+/// Checks whether a variable with the given name exists in a file, eg to
+/// test for optional fields in an input file before reading them
+bool existsVar(int FileID,                ///< [in] ID of the file to check
+               const std::string &VarName ///< [in] name of variable
+);
+
 /// Retrieves a dimension length from an input file, given the name
 /// of the dimension. Returns the length if exists, but returns a negative
 /// value if a dimension of that length is not found in the file.
@@ -241,13 +318,17 @@ int readMeta(const std::string &MetaName, ///< [in] name of metadata
 
 /// Defines a variable for an output file. The name and dimensions of
 /// the variable must be supplied. An ID is assigned to the variable
-/// for later use in the writing of the variable.
+/// for later use in the writing of the variable. Optional compression
+/// settings are applied for NetCDF4/HDF5 file formats and ignored with a
+/// warning for other formats.
 int defineVar(int FileID, ///< [in] ID of the file containing dim
               const std::string &VarName, ///< [in] name of variable
               IODataType VarType,         ///< [in] data type for the variable
               int NDims,                  ///< [in] number of dimensions
               int *DimIDs, ///< [in] vector of NDims dimension IDs
-              int &VarID   ///< [out] id assigned to this variable
+              int &VarID,  ///< [out] id assigned to this variable
+              const Compression &Compress =
+                  Compression() ///< [in] (optional) compression settings
 );
 
 /// Ends define mode signifying all field definitions and metadata
@@ -256,7 +337,12 @@ int endDefinePhase(int FileID ///< [in] ID of the file being written
 );
 
 /// Creates a PIO decomposition description to describe the layout of
-/// a distributed array of given type.
+/// a distributed array of given type, using the default IO system unless
+/// another system created by createSystem is supplied. Decompositions are
+/// cached, so if an identical decomposition (same IO system, type,
+/// rearranger, dimensions and global indices) already exists, its ID is
+/// returned and its reference count is incremented rather than creating a
+/// new one. This is a collective call.
 int createDecomp(
     int &DecompID,                      ///< [out] ID for the new decomposition
     IODataType VarType,                 ///< [in] data type of array
@@ -264,10 +350,12 @@ int createDecomp(
     const std::vector<int> &DimLengths, ///< [in] global dimension lengths
     int Size,                           ///< [in] local size of array
     const std::vector<int> &GlobalIndx, ///< [in] global indx for each loc indx
-    Rearranger Rearr                    ///< [in] rearranger method to use
+    Rearranger Rearr,                   ///< [in] rearranger method to use
+    int InSysID = SysID ///< [in] (optional) IO system to use
 );
 
-/// Removes a PIO decomposition to free memory.
+/// Removes a PIO decomposition to free memory. For shared decompositions,
+/// the decomposition is only freed when the last reference is removed.
 int destroyDecomp(int &DecompID ///< [inout] ID for decomp to remove
 );
 
@@ -296,6 +384,24 @@ int writeArray(void *Array,     ///< [in] array to be written
                int VarID        ///< [in] variable ID assigned by defineVar
 );
 
+/// Writes a distributed array asynchronously. The array (on the host) is
+/// copied into an internal staging buffer and the routine returns
+/// immediately while a background IO thread performs the write. The array
+/// may be modified once the routine returns. Requires an MPI library
+/// initialized with MPI_THREAD_MULTIPLE; otherwise the write is performed
+/// synchronously. Errors from the background write are reported by waitAll.
+int writeArrayAsync(void *Array,     ///< [in] array to be written
+                    int Size,        ///< [in] size of array to be written
+                    void *FillValue, ///< [in] value to use for missing entries
+                    int FileID,      ///< [in] ID of open file to write to
+                    int DecompID,    ///< [in] decomposition ID for this var
+                    int VarID        ///< [in] variable ID assigned by defineVar
+);
+
+/// Waits for all outstanding asynchronous writes to complete. Returns a
+/// non-zero error code if any of the writes failed.
+int waitAll();
+
 } // end namespace IO
 } // end namespace OMEGA
 
@@ -15,8 +15,10 @@
 #include "MachEnv.h"
 #include "mpi.h"
 
+#include <algorithm>
 #include <map>
 #include <string>
+#include <vector>
 // Note that we should replace iostream and std::cerr with the logging
 // capability once that is enabled.
 #include <iostream>
@@ -66,6 +68,9 @@ MachEnv::MachEnv(const std::string Name, // [in] name of environment
    // All tasks are members of this communicator's group
    MemberFlag = true;
 
+   // Determine which tasks share memory on each node
+   setNodeLayout(0);
+
 #ifdef OMEGA_THREADED
    // total number of OpenMP threads
    NumThreads = omp_get_num_threads();
@@ -166,6 +171,9 @@ MachEnv::MachEnv(const std::string Name, // [in] name of environment
       MasterTaskFlag = false;
    }
 
+   // Determine which tasks share memory on each node
+   setNodeLayout(0);
+
 #ifdef OMEGA_THREADED
    // total number of OpenMP threads
    NumThreads = omp_get_num_threads();
@@ -267,6 +275,9 @@ MachEnv::MachEnv(const std::string Name, // [in] name of environment
       MasterTaskFlag = false;
    }
 
+   // Determine which tasks share memory on each node
+   setNodeLayout(0);
+
 #ifdef OMEGA_THREADED
    // total number of OpenMP threads
    NumThreads = omp_get_num_threads();
@@ -365,6 +376,9 @@ MachEnv::MachEnv(const std::string Name, // [in] name of environment
       MasterTaskFlag = false;
    }
 
+   // Determine which tasks share memory on each node
+   setNodeLayout(0);
+
 #ifdef OMEGA_THREADED
    // total number of OpenMP threads
    NumThreads = omp_get_num_threads();
@@ -377,6 +391,81 @@ MachEnv::MachEnv(const std::string Name, // [in] name of environment
 
 } // end constructor with selected tasks
 
+//------------------------------------------------------------------------------
+// Determines the node-level layout of the tasks. The communicator is split
+// into groups of tasks that can share memory and, if MaxNodeTasks is
+// positive, each of these is further split into groups of at most
+// MaxNodeTasks consecutive node tasks. Nodes are numbered in order of their
+// lowest task and the node of every task is gathered so that the node of
+// any task can be retrieved locally.
+
+int MachEnv::setNodeLayout(const int MaxNodeTasks // [in] max tasks per node
+) {
+
+   int Err = 0;
+
+   // Tasks outside the environment have no node information
+   if (!MemberFlag) {
+      NodeComm     = MPI_COMM_NULL;
+      MyNodeTask   = -999;
+      NumNodeTasks = -999;
+      MyNode       = -999;
+      NumNodes     = -999;
+      TaskNodes.clear();
+      return Err;
+   }
+
+   // Split the communicator into tasks that share memory
+   MPI_Comm SharedComm;
+   Err = MPI_Comm_split_type(Comm, MPI_COMM_TYPE_SHARED, MyTask,
+                             MPI_INFO_NULL, &SharedComm);
+   if (Err != MPI_SUCCESS) {
+      std::cerr << "Error creating node communicator in MachEnv" << std::endl;
+      return Err;
+   }
+
+   // Divide each shared-memory node into smaller groups if requested
+   if (MaxNodeTasks > 0) {
+      int SharedTask;
+      MPI_Comm_rank(SharedComm, &SharedTask);
+      Err = MPI_Comm_split(SharedComm, SharedTask / MaxNodeTasks, SharedTask,
+                           &NodeComm);
+      MPI_Comm_free(&SharedComm);
+      if (Err != MPI_SUCCESS) {
+         std::cerr << "Error splitting node communicator in MachEnv"
+                   << std::endl;
+         return Err;
+      }
+   } else {
+      NodeComm = SharedComm;
+   }
+
+   MPI_Comm_rank(NodeComm, &MyNodeTask);
+   MPI_Comm_size(NodeComm, &NumNodeTasks);
+
+   // Identify each node by its lowest task and number the nodes in order
+   int NodeLeader = MyTask;
+   MPI_Bcast(&NodeLeader, 1, MPI_INT, 0, NodeComm);
+   std::vector<int> TaskLeaders(NumTasks);
+   MPI_Allgather(&NodeLeader, 1, MPI_INT, TaskLeaders.data(), 1, MPI_INT,
+                 Comm);
+
+   std::vector<int> Leaders = TaskLeaders;
+   std::sort(Leaders.begin(), Leaders.end());
+   Leaders.erase(std::unique(Leaders.begin(), Leaders.end()), Leaders.end());
+   NumNodes = Leaders.size();
+
+   TaskNodes.resize(NumTasks);
+   for (int Task = 0; Task < NumTasks; ++Task)
+      TaskNodes[Task] =
+          std::lower_bound(Leaders.begin(), Leaders.end(), TaskLeaders[Task]) -
+          Leaders.begin();
+   MyNode = TaskNodes[MyTask];
+
+   return Err;
+
+} // end setNodeLayout
+
 //------------------------------------------------------------------------------
 // Initializes the Machine Environment by creating the DefaultEnv for Omega
 
@@ -458,6 +547,38 @@ int MachEnv::getMasterTask() const { return MasterTask; }
 
 bool MachEnv::isMasterTask() const { return MasterTaskFlag; }
 
+//------------------------------------------------------------------------------
+// Get communicator for tasks on the local node
+MPI_Comm MachEnv::getNodeComm() const { return NodeComm; }
+
+//------------------------------------------------------------------------------
+// Get local task ID within the node
+int MachEnv::getMyNodeTask() const { return MyNodeTask; }
+
+//------------------------------------------------------------------------------
+// Get number of tasks on the local node
+int MachEnv::getNumNodeTasks() const { return NumNodeTasks; }
+
+//------------------------------------------------------------------------------
+// Get ID of the local node
+int MachEnv::getMyNode() const { return MyNode; }
+
+//------------------------------------------------------------------------------
+// Get number of nodes spanned by the environment
+int MachEnv::getNumNodes() const { return NumNodes; }
+
+//------------------------------------------------------------------------------
+// Get the node ID for a task, or -1 for an invalid task
+
+int MachEnv::getTaskNode(const int TaskID) const {
+
+   if (TaskID < 0 || TaskID >= static_cast<int>(TaskNodes.size()))
+      return -1;
+
+   return TaskNodes[TaskID];
+
+} // end getTaskNode
+
 //------------------------------------------------------------------------------
 // Determine whether local task is in this communicator's group
 
@@ -491,6 +612,34 @@ int MachEnv::setMasterTask(const int TaskID) {
 
 } // end setMasterTask
 
+//------------------------------------------------------------------------------
+// Limit the number of tasks in each node group. The current node
+// communicator is freed and the node layout is recomputed.
+
+int MachEnv::setNodeSize(const int MaxNodeTasks // [in] max tasks per node
+) {
+
+   int Err = 0;
+
+   // If called from outside the group, don't do anything
+   if (!MemberFlag)
+      return Err;
+
+   if (MaxNodeTasks < 0) {
+      std::cerr << "Error: invalid MaxNodeTasks sent to MachEnv.setNodeSize "
+                << MaxNodeTasks << std::endl;
+      return -1;
+   }
+
+   if (NodeComm != MPI_COMM_NULL)
+      MPI_Comm_free(&NodeComm);
+
+   Err = setNodeLayout(MaxNodeTasks);
+
+   return Err;
+
+} // end setNodeSize
+
 //------------------------------------------------------------------------------
 // Print all members of a MachEnv
 
@@ -502,6 +651,10 @@ void MachEnv::print() const {
    std::cout << "  MasterTask     = " << MasterTask << std::endl;
    std::cout << "  MasterTaskFlag = " << MasterTaskFlag << std::endl;
    std::cout << "  MemberFlag     = " << MemberFlag << std::endl;
+   std::cout << "  MyNodeTask     = " << MyNodeTask << std::endl;
+   std::cout << "  NumNodeTasks   = " << NumNodeTasks << std::endl;
+   std::cout << "  MyNode         = " << MyNode << std::endl;
+   std::cout << "  NumNodes       = " << NumNodes << std::endl;
    std::cout << "  NumThreads     = " << NumThreads << std::endl;
    std::cout << "  VecLength      = " << VecLength << std::endl;
 
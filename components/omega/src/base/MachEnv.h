@@ -21,6 +21,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 namespace OMEGA {
 
@@ -49,10 +50,18 @@ class MachEnv {
    // Add threading variables here
    int NumThreads; ///< number of OpenMP threads per task
 
+   // Node-level layout of the tasks. A node is a group of tasks that can
+   // share memory, as determined by MPI_Comm_split_type.
+   MPI_Comm NodeComm;          ///< MPI communicator for tasks on local node
+   int MyNodeTask;             ///< task ID within the node communicator
+   int NumNodeTasks;           ///< number of tasks on the local node
+   int MyNode;                 ///< ID of the local node
+   int NumNodes;               ///< number of nodes spanned by environment
+   std::vector<int> TaskNodes; ///< node ID for every task in Comm
+
    // Add any other useful machine parameters here
    // It may be useful at some point to track the number
-   // of various devices per node (CPUs, GPUs), the number
-   // of tasks allocated per node, etc.
+   // of various devices per node (CPUs, GPUs), etc.
 
    /// The default environment describes the environment for OMEGA
    /// defined for most of the model. Because it is used most often,
@@ -70,6 +79,13 @@ class MachEnv {
            const MPI_Comm inComm   ///< [in] MPI communicator to use
    );
 
+   /// Determines the node-level layout of the tasks by splitting the
+   /// communicator into shared-memory node communicators. If MaxNodeTasks
+   /// is positive, each node is further divided into groups of at most
+   /// that many consecutive node tasks.
+   int setNodeLayout(const int MaxNodeTasks ///< [in] max tasks per node
+   );
+
  public:
    // Methods
 
@@ -145,13 +161,33 @@ class MachEnv {
    /// Determine whether local task is the master
    bool isMasterTask() const;
 
+   /// Get communicator for the tasks sharing memory on the local node
+   MPI_Comm getNodeComm() const;
+
+   /// Get local task ID within the node communicator
+   int getMyNodeTask() const;
+
+   /// Get number of tasks on the local node
+   int getNumNodeTasks() const;
+
+   /// Get ID of the local node (0 to NumNodes-1). Nodes are numbered in
+   /// order of their lowest task ID.
+   int getMyNode() const;
+
+   /// Get total number of nodes spanned by this environment
+   int getNumNodes() const;
+
+   /// Get the ID of the node holding any task in this environment
+   int getTaskNode(const int TaskID ///< [in] task ID in this environment
+   ) const;
+
    /// Determine whether local task is a member of this environment.
    /// This is primarily to prevent retrievals of non-existent
    /// values when a given environment uses only a subset of the
    /// tasks.
    bool isMember() const;
 
-   // Only one variable can be set
+   // Only the master task and node size can be set
 
    /// Set master task ID. By default, the master task is task 0 but
    /// can be set here to a different task if the master task has
@@ -160,6 +196,14 @@ class MachEnv {
    int setMasterTask(const int TaskID ///< [in] new task to use as master
    );
 
+   /// Limit the number of tasks in each node group. By default, a node
+   /// holds all tasks that can share memory. A positive MaxNodeTasks splits
+   /// each of these into groups of at most MaxNodeTasks consecutive tasks
+   /// (eg one per socket or NUMA domain), while zero restores the full
+   /// shared-memory nodes. This is collective over the environment.
+   int setNodeSize(const int MaxNodeTasks ///< [in] max tasks per node group
+   );
+
    /// Prints all members of a MachEnv (typically for debugging)
    void print() const;
 
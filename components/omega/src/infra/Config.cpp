@@ -14,10 +14,13 @@
 #include "DataTypes.h"
 #include "Logging.h"
 #include "MachEnv.h"
+#include "Timer.h"
 #include "mpi.h"
 #include "yaml-cpp/yaml.h"
 
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
 
 namespace OMEGA {
@@ -62,25 +65,51 @@ Config::Config() {
 // Reads the full configuration for omega and stores in it a static
 // YAML node for later use.  The file must be in YAML format and must be in
 // the same directory as the executable, though Unix soft links can be used
-// to point to a file in an alternate location.  The full configuration is
-// only read by the master task.  The accessor functions (get/set) will
-// broadcast or communicate the data as needed to/from other MPI tasks.
+// to point to a file in an alternate location.  The file is only read by the
+// master task and its contents are broadcast as a single string so that
+// every task parses and stores an identical copy of the configuration. All
+// later accessor functions (get/set/add) then operate on the local copy
+// without any communication.
 
 int Config::readAll(const std::string ConfigFile // [in] input YAML config file
 ) {
    int Err = 0;
 
+   TimerScope FuncTimer("Config:readAll");
+
    // Now give the full config the omega name and extract the
    // top-level omega node from the Root.
    ConfigAll.Name = "omega";
 
+   // Make sure the master task is known even if no other Config has been
+   // constructed yet
+   MachEnv *DefEnv      = MachEnv::getDefaultEnv();
+   Config::IsMasterTask = DefEnv->isMasterTask();
+
+   // Read the full file into a string on the master task. An empty string
+   // is used to signal a read failure to the other tasks.
+   std::string ConfigText;
    if (IsMasterTask) {
-      // Read temporary root node
-      YAML::Node RootNode = YAML::LoadFile(ConfigFile);
-      // Extract Omega node
-      ConfigAll.Node = RootNode["omega"];
+      std::ifstream InFile(ConfigFile);
+      if (InFile.good()) {
+         std::stringstream InStream;
+         InStream << InFile.rdbuf();
+         ConfigText = InStream.str();
+      }
+   }
+
+   // Broadcast the file contents to all tasks with a single broadcast
+   Broadcast(ConfigText);
+   if (ConfigText.empty()) {
+      LOG_ERROR("Config readAll: unable to read config file {}", ConfigFile);
+      Err = -1;
+      return Err;
    }
 
+   // Parse into a temporary root node and extract the Omega node
+   YAML::Node RootNode = YAML::Load(ConfigText);
+   ConfigAll.Node      = RootNode["omega"];
+
    return Err;
 
 } // end Config::readAll
@@ -91,15 +120,7 @@ int Config::readAll(const std::string ConfigFile // [in] input YAML config file
 // Retrieves the top-level OMEGA config
 Config *Config::getOmegaConfig() {
 
-   Config *retConfig;
-
-   if (Config::IsMasterTask) {
-      retConfig = &ConfigAll;
-   } else {
-      retConfig = nullptr;
-   }
-
-   return retConfig;
+   return &ConfigAll;
 }
 
 //------------------------------------------------------------------------------
@@ -109,16 +130,14 @@ Config *Config::getOmegaConfig() {
 int Config::get(Config &SubConfig // [inout] sub-configuration to retrieve
 ) {
    int Err = 0;
-   if (Config::IsMasterTask) {
-      std::string GroupName = SubConfig.Name;
-      if (Node[GroupName]) { // the group exists
-         SubConfig.Node = Node[GroupName];
-      } else {
-         LOG_ERROR("Config get group: could not find group {}", GroupName);
-         Err = -1;
-      }
+
+   std::string GroupName = SubConfig.Name;
+   if (Node[GroupName]) { // the group exists
+      SubConfig.Node = Node[GroupName];
+   } else {
+      LOG_ERROR("Config get group: could not find group {}", GroupName);
+      Err = -1;
    }
-   Broadcast(Err);
    return Err;
 }
 
@@ -128,23 +147,14 @@ int Config::get(Config &SubConfig // [inout] sub-configuration to retrieve
 int Config::get(const std::string VarName, // [in] name of variable to get
                 I4 &Value                  // [out] value of the variable
 ) {
-   int Err    = 0;
-   int ValErr = -9999;
-
-   // Extract variable from config on master task
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         Value = Node[VarName].as<OMEGA::I4>();
-      } else {
-         LOG_ERROR("Config get I4: could not find variable {}", VarName);
-         Value = ValErr;
-      }
-   }
+   int Err = 0;
 
-   // Broadcast the value to other tasks
-   Broadcast(Value);
-   if (Value == ValErr)
+   if (Node[VarName]) { // the variable exists
+      Value = Node[VarName].as<OMEGA::I4>();
+   } else {
+      LOG_ERROR("Config get I4: could not find variable {}", VarName);
       Err = -1;
+   }
 
    return Err;
 }
@@ -155,23 +165,14 @@ int Config::get(const std::string VarName, // [in] name of variable to get
 int Config::get(const std::string VarName, // [in] name of variable to get
                 I8 &Value                  // [out] value of the variable
 ) {
-   int Err   = 0;
-   I8 ValErr = -99999;
-
-   // Extract variable from config on master task
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         Value = Node[VarName].as<OMEGA::I8>();
-      } else {
-         LOG_ERROR("Config get I8: could not find variable {}", VarName);
-         Value = ValErr;
-      }
-   }
+   int Err = 0;
 
-   // Broadcast the value to other tasks
-   Broadcast(Value);
-   if (Value == ValErr)
+   if (Node[VarName]) { // the variable exists
+      Value = Node[VarName].as<OMEGA::I8>();
+   } else {
+      LOG_ERROR("Config get I8: could not find variable {}", VarName);
       Err = -1;
+   }
 
    return Err;
 }
@@ -182,23 +183,14 @@ int Config::get(const std::string VarName, // [in] name of variable to get
 int Config::get(const std::string VarName, // [in] name of variable to get
                 R4 &Value                  // [out] value of the variable
 ) {
-   int Err   = 0;
-   R4 ValErr = -999.999;
-
-   // Extract variable from config on master task
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         Value = Node[VarName].as<OMEGA::R4>();
-      } else {
-         LOG_ERROR("Config get R4: could not find variable {}", VarName);
-         Value = ValErr;
-      }
-   }
+   int Err = 0;
 
-   // Broadcast the value to other tasks
-   Broadcast(Value);
-   if (Value == ValErr)
+   if (Node[VarName]) { // the variable exists
+      Value = Node[VarName].as<OMEGA::R4>();
+   } else {
+      LOG_ERROR("Config get R4: could not find variable {}", VarName);
       Err = -1;
+   }
 
    return Err;
 }
@@ -209,23 +201,14 @@ int Config::get(const std::string VarName, // [in] name of variable to get
 int Config::get(const std::string VarName, // [in] name of variable to get
                 R8 &Value                  // [out] value of the variable
 ) {
-   int Err   = 0;
-   R8 ValErr = -99999.999;
-
-   // Extract variable from config on master task
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         Value = Node[VarName].as<OMEGA::R8>();
-      } else {
-         LOG_ERROR("Config get R8: could not find variable {}", VarName);
-         Value = ValErr;
-      }
-   }
+   int Err = 0;
 
-   // Broadcast the value to other tasks
-   Broadcast(Value);
-   if (Value == ValErr)
+   if (Node[VarName]) { // the variable exists
+      Value = Node[VarName].as<OMEGA::R8>();
+   } else {
+      LOG_ERROR("Config get R8: could not find variable {}", VarName);
       Err = -1;
+   }
 
    return Err;
 }
@@ -238,20 +221,13 @@ int Config::get(const std::string VarName, // [in] name of variable to get
 ) {
    int Err = 0;
 
-   // Extract variable from config on master task
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         Value = Node[VarName].as<bool>();
-      } else {
-         LOG_ERROR("Config get bool: could not find variable {}", VarName);
-         Err = -1;
-      }
+   if (Node[VarName]) { // the variable exists
+      Value = Node[VarName].as<bool>();
+   } else {
+      LOG_ERROR("Config get bool: could not find variable {}", VarName);
+      Err = -1;
    }
 
-   // Broadcast the value to other tasks
-   Broadcast(Value);
-   Broadcast(Err);
-
    return Err;
 }
 
@@ -261,27 +237,14 @@ int Config::get(const std::string VarName, // [in] name of variable to get
 int Config::get(const std::string VarName, // [in] name of variable to get
                 std::string &Value         // [out] value of the variable
 ) {
-   int Err            = 0;
-   std::string ValErr = "ConfigError";
-
-   // Extract variable from config on master task
-   std::string TmpVal;
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         TmpVal = Node[VarName].as<std::string>();
-      } else {
-         LOG_ERROR("Config get string: could not find variable {}", VarName);
-         TmpVal = ValErr;
-      }
-   }
+   int Err = 0;
 
-   // Broadcast the value to other tasks
-   // Note that the broadcast will automatically resize TmpVal to fit on
-   // non-master tasks
-   Broadcast(TmpVal);
-   Value = TmpVal;
-   if (Value == ValErr)
+   if (Node[VarName]) { // the variable exists
+      Value = Node[VarName].as<std::string>();
+   } else {
+      LOG_ERROR("Config get string: could not find variable {}", VarName);
       Err = -1;
+   }
 
    return Err;
 }
@@ -296,16 +259,12 @@ int Config::set(const std::string VarName, // [in] name of variable to set
 ) {
    int Err = 0;
 
-   // Config exists on master task
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         Node[VarName] = Value;
-      } else {
-         LOG_ERROR("Config set I4: could not find variable {}", VarName);
-         Err = -1;
-      }
+   if (Node[VarName]) { // the variable exists
+      Node[VarName] = Value;
+   } else {
+      LOG_ERROR("Config set I4: could not find variable {}", VarName);
+      Err = -1;
    }
-   Broadcast(Err);
 
    return Err;
 }
@@ -318,16 +277,12 @@ int Config::set(const std::string VarName, // [in] name of variable to set
 ) {
    int Err = 0;
 
-   // Config exists on master task
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         Node[VarName] = Value;
-      } else {
-         LOG_ERROR("Config set I8: could not find variable {}", VarName);
-         Err = -1;
-      }
+   if (Node[VarName]) { // the variable exists
+      Node[VarName] = Value;
+   } else {
+      LOG_ERROR("Config set I8: could not find variable {}", VarName);
+      Err = -1;
    }
-   Broadcast(Err);
 
    return Err;
 }
@@ -340,16 +295,12 @@ int Config::set(const std::string VarName, // [in] name of variable to set
 ) {
    int Err = 0;
 
-   // Config exists on master task
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         Node[VarName] = Value;
-      } else {
-         LOG_ERROR("Config set R4: could not find variable {}", VarName);
-         Err = -1;
-      }
+   if (Node[VarName]) { // the variable exists
+      Node[VarName] = Value;
+   } else {
+      LOG_ERROR("Config set R4: could not find variable {}", VarName);
+      Err = -1;
    }
-   Broadcast(Err);
 
    return Err;
 }
@@ -362,16 +313,12 @@ int Config::set(const std::string VarName, // [in] name of variable to set
 ) {
    int Err = 0;
 
-   // Config exists on master task
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         Node[VarName] = Value;
-      } else {
-         LOG_ERROR("Config set R8: could not find variable {}", VarName);
-         Err = -1;
-      }
+   if (Node[VarName]) { // the variable exists
+      Node[VarName] = Value;
+   } else {
+      LOG_ERROR("Config set R8: could not find variable {}", VarName);
+      Err = -1;
    }
-   Broadcast(Err);
 
    return Err;
 }
@@ -384,16 +331,12 @@ int Config::set(const std::string VarName, // [in] name of variable to set
 ) {
    int Err = 0;
 
-   // Config exists on master task
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         Node[VarName] = Value;
-      } else {
-         LOG_ERROR("Config set bool: could not find variable {}", VarName);
-         Err = -1;
-      }
+   if (Node[VarName]) { // the variable exists
+      Node[VarName] = Value;
+   } else {
+      LOG_ERROR("Config set bool: could not find variable {}", VarName);
+      Err = -1;
    }
-   Broadcast(Err);
 
    return Err;
 }
@@ -406,16 +349,12 @@ int Config::set(const std::string VarName, // [in] name of variable to set
 ) {
    int Err = 0;
 
-   // Config exists on master task
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         Node[VarName] = Value;
-      } else {
-         LOG_ERROR("Config set string: could not find variable {}", VarName);
-         Err = -1;
-      }
+   if (Node[VarName]) { // the variable exists
+      Node[VarName] = Value;
+   } else {
+      LOG_ERROR("Config set string: could not find variable {}", VarName);
+      Err = -1;
    }
-   Broadcast(Err);
 
    return Err;
 }
@@ -430,16 +369,13 @@ int Config::add(const Config SubConfig // [in] Config to add
    int Err = 0;
 
    std::string LocName = SubConfig.Name;
-   if (Config::IsMasterTask) {
-      if (Node[LocName]) { // the variable exists
-         LOG_ERROR("Config add group: cannot add, group {} already exists",
-                   LocName);
-         Err = -1;
-      } else {
-         Node[LocName] = SubConfig.Node;
-      }
+   if (Node[LocName]) { // the variable exists
+      LOG_ERROR("Config add group: cannot add, group {} already exists",
+                LocName);
+      Err = -1;
+   } else {
+      Node[LocName] = SubConfig.Node;
    }
-   Broadcast(Err);
 
    return Err;
 }
@@ -452,16 +388,13 @@ int Config::add(const std::string VarName, // [in] name of variable to add
 ) {
    int Err = 0;
 
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         LOG_ERROR("Config add I4: variable {} already exists use set instead",
-                   VarName);
-         Err = -1;
-      } else {
-         Node[VarName] = Value;
-      }
+   if (Node[VarName]) { // the variable exists
+      LOG_ERROR("Config add I4: variable {} already exists use set instead",
+                VarName);
+      Err = -1;
+   } else {
+      Node[VarName] = Value;
    }
-   Broadcast(Err);
 
    return Err;
 }
@@ -474,16 +407,13 @@ int Config::add(const std::string VarName, // [in] name of variable to add
 ) {
    int Err = 0;
 
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         LOG_ERROR("Config add I8: variable {} already exists use set instead",
-                   VarName);
-         Err = -1;
-      } else {
-         Node[VarName] = Value;
-      }
+   if (Node[VarName]) { // the variable exists
+      LOG_ERROR("Config add I8: variable {} already exists use set instead",
+                VarName);
+      Err = -1;
+   } else {
+      Node[VarName] = Value;
    }
-   Broadcast(Err);
 
    return Err;
 }
@@ -496,16 +426,13 @@ int Config::add(const std::string VarName, // [in] name of variable to add
 ) {
    int Err = 0;
 
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         LOG_ERROR("Config add R4: variable {} already exists use set instead",
-                   VarName);
-         Err = -1;
-      } else {
-         Node[VarName] = Value;
-      }
+   if (Node[VarName]) { // the variable exists
+      LOG_ERROR("Config add R4: variable {} already exists use set instead",
+                VarName);
+      Err = -1;
+   } else {
+      Node[VarName] = Value;
    }
-   Broadcast(Err);
 
    return Err;
 }
@@ -518,16 +445,13 @@ int Config::add(const std::string VarName, // [in] name of variable to add
 ) {
    int Err = 0;
 
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         LOG_ERROR("Config add R8: variable {} already exists use set instead",
-                   VarName);
-         Err = -1;
-      } else {
-         Node[VarName] = Value;
-      }
+   if (Node[VarName]) { // the variable exists
+      LOG_ERROR("Config add R8: variable {} already exists use set instead",
+                VarName);
+      Err = -1;
+   } else {
+      Node[VarName] = Value;
    }
-   Broadcast(Err);
 
    return Err;
 }
@@ -540,17 +464,14 @@ int Config::add(const std::string VarName, // [in] name of variable to add
 ) {
    int Err = 0;
 
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         LOG_ERROR(
-             "Config add bool: variable {} already exists use set instead",
-             VarName);
-         Err = -1;
-      } else {
-         Node[VarName] = Value;
-      }
+   if (Node[VarName]) { // the variable exists
+      LOG_ERROR(
+          "Config add bool: variable {} already exists use set instead",
+          VarName);
+      Err = -1;
+   } else {
+      Node[VarName] = Value;
    }
-   Broadcast(Err);
 
    return Err;
 }
@@ -563,16 +484,13 @@ int Config::add(const std::string VarName, // [in] name of variable to add
 ) {
    int Err = 0;
 
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         LOG_ERROR("Config add string: variable {} already exists - use set",
-                   VarName);
-         Err = -1;
-      } else {
-         Node[VarName] = Value;
-      }
+   if (Node[VarName]) { // the variable exists
+      LOG_ERROR("Config add string: variable {} already exists - use set",
+                VarName);
+      Err = -1;
+   } else {
+      Node[VarName] = Value;
    }
-   Broadcast(Err);
 
    return Err;
 }
@@ -585,10 +503,8 @@ int Config::remove(const std::string VarName // [in] name of variable to remove
 ) {
    int Err = 0;
 
-   if (Config::IsMasterTask) {
-      if (Node[VarName]) { // the variable exists
-         Node.remove(VarName);
-      }
+   if (Node[VarName]) { // the variable exists
+      Node.remove(VarName);
    }
 
    return Err;
@@ -602,11 +518,8 @@ int Config::remove(const std::string VarName // [in] name of variable to remove
 bool Config::existsGroup(std::string GroupName // [in] name of group to find
 ) {
    bool result = false;
-   if (Config::IsMasterTask) {
-      if (Node[GroupName])
-         result = true;
-   }
-   Broadcast(result);
+   if (Node[GroupName])
+      result = true;
    return result;
 }
 
@@ -614,11 +527,8 @@ bool Config::existsGroup(std::string GroupName // [in] name of group to find
 bool Config::existsVar(std::string VarName // [in] name of variable to find
 ) {
    bool result = false;
-   if (Config::IsMasterTask) {
-      if (Node[VarName])
-         result = true;
-   }
-   Broadcast(result);
+   if (Node[VarName])
+      result = true;
    return result;
 }
 
@@ -631,6 +541,7 @@ int Config::write(std::string FileName /// name of file for config
 ) {
    int Err = 0;
 
+   // All tasks hold the same configuration so only the master task writes
    if (Config::IsMasterTask) {
       std::ofstream Outfile(FileName);
       if (Outfile.good()) {
@@ -14,11 +14,13 @@
 //===----------------------------------------------------------------------===//
 
 #include "DataTypes.h"
+#include "Logging.h"
 #include "MachEnv.h"
 #include "mpi.h"
 #include "yaml-cpp/yaml.h"
 
 #include <string>
+#include <type_traits>
 
 namespace OMEGA {
 
@@ -42,10 +44,10 @@ class Config {
    /// The YAML node containing the configuration.
    YAML::Node Node;
 
-   /// We store the configuration on the master task and broadcast
-   /// as needed to other tasks via the get function. This flag determines
-   /// whether this is the master task and is copied from the default
-   /// MachEnv.
+   /// The configuration is read by the master task and broadcast once
+   /// to all tasks so that every task holds an identical copy. This flag
+   /// determines whether this is the master task (used for file reads and
+   /// writes) and is copied from the default MachEnv.
    static bool IsMasterTask;
 
    /// We do not use an initialization routine, so we include this
@@ -70,9 +72,11 @@ class Config {
    /// Reads the full configuration for omega and stores in it a static
    /// YAML node for later use.  The file must be in YAML format and must be in
    /// the same directory as the executable, though Unix soft links can be used
-   /// to point to a file in an alternate location.  The full configuration is
-   /// only read by the master task.  The accessor functions (get/set) will
-   /// broadcast or communicate the data as needed to/from other MPI tasks.
+   /// to point to a file in an alternate location.  The file is only read by
+   /// the master task and its contents are broadcast once so that every task
+   /// holds a full copy. The accessor functions (get/set/add/remove) are then
+   /// local operations that require no communication. Returns a non-zero
+   /// error code if the file could not be read.
    static int readAll(std::string FileName ///< [in] input omega config file
    );
 
@@ -238,6 +242,86 @@ class Config {
 
 }; // end class Config
 
+/// The ConfigParam class is a typed handle to a single configuration
+/// variable. The variable is looked up by name and converted once when the
+/// handle is constructed and the value is then cached, so retrieving it
+/// in the run loop involves no string lookup or YAML traversal. The handle
+/// keeps a (shared) reference to the parent configuration so the cached
+/// value can be updated with refresh if the configuration is changed with
+/// a set call. Modules that need parameters inside device kernels should
+/// copy the values from their handles into a plain struct of scalars that
+/// can be captured by value.
+template <typename T> class ConfigParam {
+
+   static_assert(std::is_same<T, I4>::value || std::is_same<T, I8>::value ||
+                     std::is_same<T, R4>::value || std::is_same<T, R8>::value ||
+                     std::is_same<T, bool>::value ||
+                     std::is_same<T, std::string>::value,
+                 "ConfigParam only supports I4, I8, R4, R8, bool and string");
+
+ private:
+   /// Name of the variable in the parent configuration
+   std::string Name;
+
+   /// Copy of the parent configuration (shares the underlying YAML node)
+   Config Parent;
+
+   /// Cached value of the variable
+   T Value{};
+
+   /// Flag that is true if the variable was found in the configuration
+   bool Valid = false;
+
+ public:
+   /// Constructor that resolves the variable in the parent configuration
+   /// and caches its value. If the variable does not exist, an error is
+   /// logged and isValid will return false.
+   ConfigParam(const Config &InConfig,   ///< [in] parent configuration
+               const std::string &InName ///< [in] name of variable
+               )
+       : Name(InName), Parent(InConfig) {
+      refresh();
+   }
+
+   /// Re-reads the value from the parent configuration, for example after
+   /// the variable has been changed with a set call.
+   /// Returns a non-zero error code if the variable does not exist
+   int refresh() {
+      int Err = Parent.get(Name, Value);
+      Valid   = (Err == 0);
+      return Err;
+   }
+
+   /// Checks that the cached value lies within the range [Min, Max]
+   /// Returns a non-zero error code if the variable is invalid or out of
+   /// range
+   int checkRange(const T &Min, ///< [in] minimum allowed value
+                  const T &Max  ///< [in] maximum allowed value
+   ) const {
+      int Err = 0;
+      if (!Valid) {
+         Err = -1;
+      } else if (Value < Min || Value > Max) {
+         LOG_ERROR("ConfigParam: variable {} outside of valid range", Name);
+         Err = -2;
+      }
+      return Err;
+   }
+
+   /// Returns true if the variable was found in the configuration
+   bool isValid() const { return Valid; }
+
+   /// Returns the name of the variable
+   const std::string &getName() const { return Name; }
+
+   /// Returns the cached value of the variable
+   const T &get() const { return Value; }
+
+   /// Implicit conversion to the cached value for convenience
+   operator const T &() const { return Value; }
+
+}; // end class ConfigParam
+
 } // end namespace OMEGA
 
 //===----------------------------------------------------------------------===//
@@ -3,15 +3,74 @@
 /// \file
 /// \brief implements Omega logging functions
 ///
-/// This implements Omega logging initialization.
+/// This implements Omega logging initialization, including the optional
+/// asynchronous logger and the aggregated logger that gathers messages
+/// from all tasks to a single writer task.
 //
 //===----------------------------------------------------------------------===//
 
 #include "Logging.h"
+#include <spdlog/async.h>
 #include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/sinks/null_sink.h>
+
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 namespace OMEGA {
 
+namespace {
+
+//------------------------------------------------------------------------------
+// Sink for aggregated logging that stores the level and unformatted message
+// text in memory until they are collected by gatherLogs.
+class GatherSink : public spdlog::sinks::base_sink<std::mutex> {
+
+ public:
+   explicit GatherSink(std::size_t InMaxBuffered)
+       : MaxBuffered(InMaxBuffered) {}
+
+   // Removes and returns the buffered messages and the number of messages
+   // dropped since the last call
+   void take(std::vector<std::pair<char, std::string>> &OutMsgs,
+             std::size_t &OutDropped) {
+      std::lock_guard<std::mutex> Lock(mutex_);
+      OutMsgs.clear();
+      OutMsgs.swap(Msgs);
+      OutDropped = Dropped;
+      Dropped    = 0;
+   }
+
+ protected:
+   void sink_it_(const spdlog::details::log_msg &Msg) override {
+      if (Msgs.size() < MaxBuffered) {
+         Msgs.emplace_back(static_cast<char>(Msg.level),
+                           std::string(Msg.payload.data(), Msg.payload.size()));
+      } else {
+         ++Dropped;
+      }
+   }
+
+   void flush_() override {} // messages are only written by gatherLogs
+
+ private:
+   std::vector<std::pair<char, std::string>> Msgs;
+   std::size_t MaxBuffered;
+   std::size_t Dropped = 0;
+};
+
+// State for aggregated logging
+std::shared_ptr<GatherSink> AggSink;
+MPI_Comm AggComm = MPI_COMM_NULL;
+int AggWriter    = 0;
+std::ofstream AggFile;
+
+} // end anonymous namespace
+
 void initLogging(std::shared_ptr<spdlog::logger> Logger) {
 
    try {
@@ -28,4 +87,235 @@ void initLogging(std::string const &LogFilePath) {
    initLogging(Logger);
 }
 
+void initLogging(std::string const &LogFilePath, LogMode Mode, bool WriteLog,
+                 std::size_t QueueSize, LogOverflow Overflow) {
+
+   try {
+      // Tasks that do not write use a sink that discards all messages
+      spdlog::sink_ptr Sink;
+      if (WriteLog) {
+         Sink =
+             std::make_shared<spdlog::sinks::basic_file_sink_mt>(LogFilePath);
+      } else {
+         Sink = std::make_shared<spdlog::sinks::null_sink_mt>();
+      }
+
+      std::shared_ptr<spdlog::logger> Logger;
+      if (Mode == LogModeAsync && WriteLog) {
+         // Messages are queued and written by a single background thread.
+         // An existing pool (and its queue size) is reused so that
+         // re-initializing does not start another thread.
+         if (!spdlog::thread_pool())
+            spdlog::init_thread_pool(QueueSize, 1);
+         auto Policy = (Overflow == LogOverflowBlock)
+                           ? spdlog::async_overflow_policy::block
+                           : spdlog::async_overflow_policy::overrun_oldest;
+
+         Logger = std::make_shared<spdlog::async_logger>(
+             "*", Sink, spdlog::thread_pool(), Policy);
+      } else {
+         Logger = std::make_shared<spdlog::logger>("*", Sink);
+      }
+
+      // Skip message formatting entirely on tasks that do not write
+      if (!WriteLog)
+         Logger->set_level(spdlog::level::off);
+
+      initLogging(Logger);
+
+   } catch (spdlog::spdlog_ex const &Ex) {
+      std::cout << "Log init failed: " << Ex.what() << std::endl;
+   }
+}
+
+//------------------------------------------------------------------------------
+// Initializes the default logger in aggregated mode. Messages are buffered on
+// each task and written by the writer task when gatherLogs is called.
+int initAggregatedLogging(std::string const &LogFilePath, MPI_Comm Comm,
+                          int WriterTask, std::size_t MaxBuffered) {
+
+   int Err = 0;
+
+   // Use a private communicator so gathers cannot interfere with other
+   // messages
+   if (AggComm != MPI_COMM_NULL)
+      MPI_Comm_free(&AggComm);
+   Err = MPI_Comm_dup(Comm, &AggComm);
+   if (Err != MPI_SUCCESS) {
+      std::cout << "Log init failed: unable to duplicate communicator"
+                << std::endl;
+      return Err;
+   }
+   AggWriter = WriterTask;
+
+   // Only the writer task touches the file system
+   int MyTask;
+   MPI_Comm_rank(AggComm, &MyTask);
+   if (MyTask == AggWriter) {
+      if (AggFile.is_open())
+         AggFile.close();
+      AggFile.open(LogFilePath, std::ios::out | std::ios::trunc);
+      if (!AggFile.good()) {
+         std::cout << "Log init failed: unable to open " << LogFilePath
+                   << std::endl;
+         Err = -1;
+      }
+   }
+
+   AggSink     = std::make_shared<GatherSink>(MaxBuffered);
+   auto Logger = std::make_shared<spdlog::logger>("*", AggSink);
+   initLogging(Logger);
+
+   MPI_Bcast(&Err, 1, MPI_INT, AggWriter, AggComm);
+   return Err;
+
+} // end initAggregatedLogging
+
+//------------------------------------------------------------------------------
+// Writes any remaining buffered messages and ends aggregated logging. The log
+// file is closed, the private communicator is freed and later messages are
+// discarded until logging is initialized again.
+int finalizeAggregatedLogging() {
+
+   int Err = 0;
+
+   // Nothing to do if aggregated logging has not been initialized
+   if (!AggSink)
+      return Err;
+
+   Err = gatherLogs();
+
+   if (AggFile.is_open())
+      AggFile.close();
+   AggSink.reset();
+   initLogging(std::make_shared<spdlog::logger>(
+       "*", std::make_shared<spdlog::sinks::null_sink_mt>()));
+
+   if (AggComm != MPI_COMM_NULL)
+      MPI_Comm_free(&AggComm);
+
+   return Err;
+
+} // end finalizeAggregatedLogging
+
+//------------------------------------------------------------------------------
+// Gathers buffered messages to the writer task, combines identical messages
+// from different tasks and appends them to the log file.
+int gatherLogs() {
+
+   int Err = 0;
+
+   // Nothing to do if aggregated logging has not been initialized
+   if (!AggSink)
+      return Err;
+
+   int MyTask, NTasks;
+   MPI_Comm_rank(AggComm, &MyTask);
+   MPI_Comm_size(AggComm, &NTasks);
+
+   // Collect local messages and report any that were dropped
+   std::vector<std::pair<char, std::string>> LocMsgs;
+   std::size_t NDropped;
+   AggSink->take(LocMsgs, NDropped);
+   if (NDropped > 0)
+      LocMsgs.emplace_back(static_cast<char>(spdlog::level::warn),
+                           std::to_string(NDropped) +
+                               " log messages dropped (buffer full)");
+
+   // Pack messages as a level character followed by a null-terminated string
+   std::string SendBuf;
+   for (const auto &Msg : LocMsgs) {
+      SendBuf.push_back(Msg.first);
+      SendBuf.append(Msg.second);
+      SendBuf.push_back('\0');
+   }
+   int SendSize = SendBuf.size();
+
+   // Gather the buffer sizes and then the buffers on the writer task
+   std::vector<int> RecvSizes;
+   std::vector<int> RecvDispls;
+   std::string RecvBuf;
+   if (MyTask == AggWriter)
+      RecvSizes.resize(NTasks);
+   Err = MPI_Gather(&SendSize, 1, MPI_INT, RecvSizes.data(), 1, MPI_INT,
+                    AggWriter, AggComm);
+   if (Err != MPI_SUCCESS)
+      return Err;
+
+   if (MyTask == AggWriter) {
+      RecvDispls.resize(NTasks);
+      int TotSize = 0;
+      for (int Task = 0; Task < NTasks; ++Task) {
+         RecvDispls[Task] = TotSize;
+         TotSize += RecvSizes[Task];
+      }
+      RecvBuf.resize(TotSize);
+   }
+   Err = MPI_Gatherv(SendBuf.data(), SendSize, MPI_CHAR, &RecvBuf[0],
+                     RecvSizes.data(), RecvDispls.data(), MPI_CHAR, AggWriter,
+                     AggComm);
+   if (Err != MPI_SUCCESS)
+      return Err;
+
+   if (MyTask != AggWriter)
+      return Err;
+
+   // Combine identical messages, keeping the order of first occurrence.
+   // For each unique message we keep the first reporting task and the
+   // number of distinct tasks reporting it.
+   struct MsgInfo {
+      int FirstTask;
+      int LastTask;
+      int NTasks;
+   };
+   std::map<std::pair<char, std::string>, std::size_t> MsgIndex;
+   std::vector<std::pair<char, std::string>> UniqueMsgs;
+   std::vector<MsgInfo> UniqueInfo;
+
+   for (int Task = 0; Task < NTasks; ++Task) {
+      std::size_t Pos = RecvDispls[Task];
+      std::size_t End = Pos + RecvSizes[Task];
+      while (Pos < End) {
+         char Level      = RecvBuf[Pos];
+         std::size_t Len = RecvBuf.find('\0', Pos + 1) - Pos - 1;
+         std::pair<char, std::string> Key(Level,
+                                          RecvBuf.substr(Pos + 1, Len));
+         Pos += Len + 2;
+
+         auto Found = MsgIndex.find(Key);
+         if (Found == MsgIndex.end()) {
+            MsgIndex[Key] = UniqueMsgs.size();
+            UniqueMsgs.push_back(Key);
+            UniqueInfo.push_back({Task, Task, 1});
+         } else {
+            MsgInfo &Info = UniqueInfo[Found->second];
+            if (Info.LastTask != Task) {
+               Info.LastTask = Task;
+               ++Info.NTasks;
+            }
+         }
+      }
+   }
+
+   // Write the combined messages
+   for (std::size_t I = 0; I < UniqueMsgs.size(); ++I) {
+      auto LevelName = spdlog::level::to_string_view(
+          static_cast<spdlog::level::level_enum>(UniqueMsgs[I].first));
+      AggFile << "[" << std::string(LevelName.data(), LevelName.size())
+              << "] ";
+      if (UniqueInfo[I].NTasks == 1) {
+         AggFile << "task " << UniqueInfo[I].FirstTask << " reported: ";
+      } else {
+         AggFile << UniqueInfo[I].NTasks << " tasks reported: ";
+      }
+      AggFile << UniqueMsgs[I].second << "\n";
+   }
+   AggFile.flush();
+   if (!AggFile.good())
+      Err = -1;
+
+   return Err;
+
+} // end gatherLogs
+
 } // namespace OMEGA
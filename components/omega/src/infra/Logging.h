@@ -6,19 +6,84 @@
 /// \brief Defines logging macros and spdlog custom formatters
 ///
 /// This header defines macros for logging. In addition, it includes
-/// Omega-specific log formatters.
+/// Omega-specific log formatters. The logger can be created either with a
+/// synchronous file sink or with an asynchronous sink in which messages are
+/// queued and written to the file by a background thread. For large task
+/// counts, an aggregated mode buffers messages on each task and periodically
+/// gathers them to a single writer task that removes duplicate messages.
 //
 //===----------------------------------------------------------------------===//
 
 #include "LogFormatters.h"
+#include "mpi.h"
 #include <spdlog/spdlog.h>
 
 namespace OMEGA {
 
 const std::string OmegaDefaultLogfile = "omega.log";
 
+/// Default number of messages that can be queued by an asynchronous logger
+constexpr std::size_t OmegaLogQueueSize = 8192;
+
+/// Logger modes. In synchronous mode, messages are formatted and written
+/// to the file by the calling thread. In asynchronous mode, the calling
+/// thread only formats and queues the message and a background thread
+/// writes (and flushes) the file.
+enum LogMode { LogModeSync, LogModeAsync };
+
+/// Policy for an asynchronous logger when the message queue is full.
+/// Block waits until there is space in the queue so no messages are lost.
+/// Drop overwrites the oldest queued message so logging never blocks.
+enum LogOverflow { LogOverflowBlock, LogOverflowDrop };
+
 void initLogging(std::shared_ptr<spdlog::logger> Logger);
 void initLogging(std::string const &LogFilePath);
+
+/// Initializes the default logger with the requested mode. If WriteLog is
+/// false (eg for MPI tasks that should not write to the file system), all
+/// messages are discarded and no file is opened. QueueSize and Overflow
+/// are only used in asynchronous mode. The asynchronous logger shares the
+/// spdlog thread pool, so QueueSize only applies when the pool is created
+/// (the first time or after spdlog::shutdown).
+void initLogging(std::string const &LogFilePath,            ///< [in] file
+                 LogMode Mode,                              ///< [in] mode
+                 bool WriteLog         = true,              ///< [in] write
+                 std::size_t QueueSize = OmegaLogQueueSize, ///< [in] queue
+                 LogOverflow Overflow  = LogOverflowDrop    ///< [in] policy
+);
+
+/// Default maximum number of messages buffered on each task between
+/// gathers in aggregated logging mode
+constexpr std::size_t OmegaLogMaxBuffered = 10000;
+
+/// Initializes the default logger in aggregated mode. Messages are buffered
+/// on each task in the communicator and only written when gatherLogs is
+/// called, at which point they are collected on the writer task and
+/// identical messages from different tasks are written once with the
+/// number of tasks reporting them. Only the writer task opens the log file.
+/// Messages beyond MaxBuffered on a task are dropped and counted.
+/// This is a collective call. Returns a non-zero error code on failure.
+int initAggregatedLogging(
+    std::string const &LogFilePath,               ///< [in] log file name
+    MPI_Comm Comm,                                ///< [in] tasks to gather
+    int WriterTask          = 0,                  ///< [in] task that writes
+    std::size_t MaxBuffered = OmegaLogMaxBuffered ///< [in] max msgs per task
+);
+
+/// Gathers all buffered messages to the writer task and appends them to
+/// the log file. Must be called collectively by all tasks in the
+/// aggregated logging communicator (eg at the end of init and periodically
+/// during the run). Does nothing if aggregated logging is not active.
+/// Returns a non-zero error code on failure.
+int gatherLogs();
+
+/// Gathers and writes any remaining buffered messages, closes the log file
+/// and frees the communicator used for aggregated logging. Messages logged
+/// afterward are discarded until logging is initialized again. Must be
+/// called collectively before MPI is finalized. Does nothing if aggregated
+/// logging is not active. Returns a non-zero error code on failure.
+int finalizeAggregatedLogging();
+
 } // namespace OMEGA
 
 #define LOG_LEVEL_TRACE    SPDLOG_LEVEL_TRACE
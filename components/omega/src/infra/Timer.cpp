@@ -0,0 +1,409 @@
+//===-- infra/Timer.cpp - hierarchical timer implementation -----*- C++ -*-===//
+//
+/// \file
+/// \brief Implements hierarchical timers for Omega
+///
+/// Each task keeps a tree of timed regions. Regions are started and
+/// stopped in nested order and each new region is added as a child of the
+/// region that is running when it is first started. At summary time, the
+/// region paths from all tasks are gathered so that every task reduces the
+/// same list of regions, even if some regions were not timed on all tasks.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Timer.h"
+#include "DataTypes.h"
+#include "Logging.h"
+#include "mpi.h"
+
+#include <limits>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace OMEGA {
+
+// Define the Timer static variables
+bool Timer::Enabled   = false;
+MPI_Comm Timer::Comm  = MPI_COMM_NULL;
+std::thread::id Timer::Owner;
+std::vector<Timer::Region> Timer::Tree;
+std::vector<I4> Timer::ActiveList;
+
+//------------------------------------------------------------------------------
+// Initializes the timer tree with an empty root region and records the
+// calling thread as the only thread that records timers.
+void Timer::init(MPI_Comm InComm, // [in] communicator for summaries
+                 bool Enable      // [in] start recording timers
+) {
+
+   Comm  = InComm;
+   Owner = std::this_thread::get_id();
+
+   Tree.clear();
+   Tree.push_back(Region{"", -1, {}, 0.0, 0, 0.0});
+   ActiveList.clear();
+   ActiveList.push_back(0);
+
+   Enabled = Enable;
+
+} // end init
+
+//------------------------------------------------------------------------------
+// Starts recording timers. Has no effect if timers were never initialized.
+void Timer::enable() { Enabled = !Tree.empty(); }
+
+//------------------------------------------------------------------------------
+// Stops recording timers
+void Timer::disable() { Enabled = false; }
+
+//------------------------------------------------------------------------------
+// Starts a region as a child of the currently running region. The child is
+// added to the tree the first time it is started under this parent.
+void Timer::start(const char *Name // [in] name of region
+) {
+
+   if (!Enabled || std::this_thread::get_id() != Owner)
+      return;
+
+   I4 Parent = ActiveList.back();
+
+   // Search the existing children of the running region
+   I4 Index = -1;
+   for (I4 Kid : Tree[Parent].Kids) {
+      if (Tree[Kid].Name == Name) {
+         Index = Kid;
+         break;
+      }
+   }
+
+   // Add a new region if this is the first call from this parent
+   if (Index < 0) {
+      Index = Tree.size();
+      Tree.push_back(Region{Name, Parent, {}, 0.0, 0, 0.0});
+      Tree[Parent].Kids.push_back(Index);
+   }
+
+   ActiveList.push_back(Index);
+   Tree[Index].StartTime = MPI_Wtime();
+
+} // end start
+
+//------------------------------------------------------------------------------
+// Stops the currently running region and accumulates its time. Regions
+// can be stopped even if timers have been disabled since they started.
+int Timer::stop(const char *Name // [in] name of region
+) {
+
+   R8 StopTime = MPI_Wtime();
+
+   if (Tree.empty() || std::this_thread::get_id() != Owner)
+      return 0;
+
+   if (ActiveList.size() <= 1) {
+      LOG_ERROR("Timer: stop called for {} with no running region", Name);
+      return -1;
+   }
+
+   Region &Current = Tree[ActiveList.back()];
+   if (Current.Name != Name) {
+      LOG_ERROR("Timer: stop called for {} while {} is running", Name,
+                Current.Name);
+      return -2;
+   }
+
+   Current.Total += StopTime - Current.StartTime;
+   ++Current.Count;
+   ActiveList.pop_back();
+
+   return 0;
+
+} // end stop
+
+//------------------------------------------------------------------------------
+// Returns the full path of a region by walking up to the root
+std::string Timer::getPath(I4 Index // [in] index of region
+) {
+
+   std::string Path = Tree[Index].Name;
+   for (I4 Parent = Tree[Index].Parent; Parent > 0;
+        Parent    = Tree[Parent].Parent)
+      Path = Tree[Parent].Name + "/" + Path;
+
+   return Path;
+
+} // end getPath
+
+//------------------------------------------------------------------------------
+// Returns the index of a region from its full path or -1 if not found
+I4 Timer::findPath(const std::string &Path // [in] full path of region
+) {
+
+   if (Tree.empty())
+      return -1;
+
+   I4 Index          = 0;
+   std::size_t Begin = 0;
+   while (Begin <= Path.size()) {
+      std::size_t End = Path.find('/', Begin);
+      if (End == std::string::npos)
+         End = Path.size();
+      std::string Name = Path.substr(Begin, End - Begin);
+
+      I4 Next = -1;
+      for (I4 Kid : Tree[Index].Kids) {
+         if (Tree[Kid].Name == Name) {
+            Next = Kid;
+            break;
+         }
+      }
+      if (Next < 0)
+         return -1;
+
+      Index = Next;
+      Begin = End + 1;
+   }
+
+   return Index;
+
+} // end findPath
+
+//------------------------------------------------------------------------------
+// Returns the accumulated local time of a region or zero if not timed
+R8 Timer::getTime(const std::string &Path // [in] full path of region
+) {
+   I4 Index = findPath(Path);
+   return Index > 0 ? Tree[Index].Total : 0.0;
+} // end getTime
+
+//------------------------------------------------------------------------------
+// Returns the number of completed local calls of a region
+I8 Timer::getCount(const std::string &Path // [in] full path of region
+) {
+   I4 Index = findPath(Path);
+   return Index > 0 ? Tree[Index].Count : 0;
+} // end getCount
+
+//------------------------------------------------------------------------------
+// Reduces all regions across the tasks in the timer communicator. The local
+// region paths are first gathered to all tasks so that every task reduces
+// the same ordered list of regions. Only completed calls are included for
+// regions that are still running.
+int Timer::summarize(
+    std::vector<TimerSummary> &Summary // [out] summary of all regions
+) {
+
+   int Err = 0;
+   Summary.clear();
+
+   if (Comm == MPI_COMM_NULL) {
+      LOG_ERROR("Timer: summarize called before init");
+      return -1;
+   }
+
+   int NumTasks;
+   MPI_Comm_size(Comm, &NumTasks);
+
+   // Serialize the local paths, each terminated with a newline
+   std::string LocPaths;
+   for (I4 Index = 1; Index < Tree.size(); ++Index)
+      LocPaths += getPath(Index) + "\n";
+
+   // Gather the paths from all tasks
+   int LocSize = LocPaths.size();
+   std::vector<int> Sizes(NumTasks);
+   std::vector<int> Offsets(NumTasks);
+   Err = MPI_Allgather(&LocSize, 1, MPI_INT, Sizes.data(), 1, MPI_INT, Comm);
+   if (Err != MPI_SUCCESS) {
+      LOG_ERROR("Timer: error gathering path sizes");
+      return Err;
+   }
+
+   int TotSize = 0;
+   for (int Task = 0; Task < NumTasks; ++Task) {
+      Offsets[Task] = TotSize;
+      TotSize += Sizes[Task];
+   }
+
+   std::vector<char> AllPaths(TotSize + 1);
+   Err = MPI_Allgatherv(LocPaths.data(), LocSize, MPI_CHAR, AllPaths.data(),
+                        Sizes.data(), Offsets.data(), MPI_CHAR, Comm);
+   if (Err != MPI_SUCCESS) {
+      LOG_ERROR("Timer: error gathering paths");
+      return Err;
+   }
+
+   // Build the ordered union of paths. Sorting the split paths places
+   // each region directly after its parent.
+   std::set<std::vector<std::string>> PathSet;
+   std::size_t Begin = 0;
+   for (std::size_t Pos = 0; Pos < TotSize; ++Pos) {
+      if (AllPaths[Pos] != '\n')
+         continue;
+      std::string Path(AllPaths.data() + Begin, Pos - Begin);
+      Begin = Pos + 1;
+
+      std::vector<std::string> Names;
+      std::size_t NameBegin = 0;
+      while (true) {
+         std::size_t NameEnd = Path.find('/', NameBegin);
+         Names.push_back(Path.substr(NameBegin, NameEnd - NameBegin));
+         if (NameEnd == std::string::npos)
+            break;
+         NameBegin = NameEnd + 1;
+      }
+      PathSet.insert(Names);
+   }
+
+   // Fill local values for every region in the global list
+   I4 NumRegions = PathSet.size();
+   std::vector<R8> LocMin(NumRegions);
+   std::vector<R8> LocMax(NumRegions);
+   std::vector<R8> LocSum(NumRegions);
+   std::vector<I8> LocCount(NumRegions);
+   std::vector<I4> LocHas(NumRegions);
+
+   Summary.resize(NumRegions);
+   I4 IReg = 0;
+   for (const std::vector<std::string> &Names : PathSet) {
+      std::string Path = Names[0];
+      for (std::size_t N = 1; N < Names.size(); ++N)
+         Path += "/" + Names[N];
+
+      Summary[IReg].Path  = Path;
+      Summary[IReg].Depth = Names.size() - 1;
+
+      I4 Index = findPath(Path);
+      if (Index > 0) {
+         LocMin[IReg]   = Tree[Index].Total;
+         LocMax[IReg]   = Tree[Index].Total;
+         LocSum[IReg]   = Tree[Index].Total;
+         LocCount[IReg] = Tree[Index].Count;
+         LocHas[IReg]   = 1;
+      } else {
+         LocMin[IReg]   = std::numeric_limits<R8>::max();
+         LocMax[IReg]   = 0.0;
+         LocSum[IReg]   = 0.0;
+         LocCount[IReg] = 0;
+         LocHas[IReg]   = 0;
+      }
+      ++IReg;
+   }
+
+   // Reduce across tasks
+   std::vector<R8> GlobMin(NumRegions);
+   std::vector<R8> GlobMax(NumRegions);
+   std::vector<R8> GlobSum(NumRegions);
+   std::vector<I8> GlobCount(NumRegions);
+   std::vector<I4> GlobHas(NumRegions);
+
+   Err = MPI_Allreduce(LocMin.data(), GlobMin.data(), NumRegions, MPI_DOUBLE,
+                       MPI_MIN, Comm);
+   if (Err == MPI_SUCCESS)
+      Err = MPI_Allreduce(LocMax.data(), GlobMax.data(), NumRegions,
+                          MPI_DOUBLE, MPI_MAX, Comm);
+   if (Err == MPI_SUCCESS)
+      Err = MPI_Allreduce(LocSum.data(), GlobSum.data(), NumRegions,
+                          MPI_DOUBLE, MPI_SUM, Comm);
+   if (Err == MPI_SUCCESS)
+      Err = MPI_Allreduce(LocCount.data(), GlobCount.data(), NumRegions,
+                          MPI_INT64_T, MPI_SUM, Comm);
+   if (Err == MPI_SUCCESS)
+      Err = MPI_Allreduce(LocHas.data(), GlobHas.data(), NumRegions, MPI_INT,
+                          MPI_SUM, Comm);
+   if (Err != MPI_SUCCESS) {
+      LOG_ERROR("Timer: error reducing region times");
+      Summary.clear();
+      return Err;
+   }
+
+   for (IReg = 0; IReg < NumRegions; ++IReg) {
+      TimerSummary &Sum = Summary[IReg];
+      Sum.NumTasks      = GlobHas[IReg];
+      Sum.Count         = GlobCount[IReg];
+      Sum.MinTime       = GlobMin[IReg];
+      Sum.MaxTime       = GlobMax[IReg];
+      Sum.MeanTime      = GlobSum[IReg] / GlobHas[IReg];
+      Sum.Imbalance =
+          Sum.MaxTime > 0.0 ? (Sum.MaxTime - Sum.MeanTime) / Sum.MaxTime : 0.0;
+   }
+
+   return 0;
+
+} // end summarize
+
+//------------------------------------------------------------------------------
+// Removes all timed regions, leaving an empty root
+int Timer::clear() {
+
+   if (ActiveList.size() > 1) {
+      LOG_ERROR("Timer: cannot clear timers while {} is running",
+                getPath(ActiveList.back()));
+      return -1;
+   }
+
+   if (!Tree.empty()) {
+      Tree.resize(1);
+      Tree[0].Kids.clear();
+   }
+
+   return 0;
+
+} // end clear
+
+//------------------------------------------------------------------------------
+// Writes the timer summary to the log on the master task, then clears and
+// disables the timers
+int Timer::finalize() {
+
+   int Err = 0;
+
+   // Nothing to do if timers were never initialized
+   if (Comm == MPI_COMM_NULL)
+      return 0;
+
+   // Close any regions left running so they are included in the summary
+   while (ActiveList.size() > 1) {
+      std::string Name = Tree[ActiveList.back()].Name;
+      LOG_WARN("Timer: region {} still running at finalize",
+               getPath(ActiveList.back()));
+      stop(Name.c_str());
+   }
+
+   std::vector<TimerSummary> Summary;
+   Err = summarize(Summary);
+   if (Err != 0) {
+      LOG_ERROR("Timer: error summarizing timers");
+      return Err;
+   }
+
+   int MyTask;
+   int NumTasks;
+   MPI_Comm_rank(Comm, &MyTask);
+   MPI_Comm_size(Comm, &NumTasks);
+
+   if (MyTask == 0 && !Summary.empty()) {
+      LOG_INFO("Timer summary over {} tasks (times in seconds)", NumTasks);
+      LOG_INFO("{:<40} {:>5} {:>10} {:>12} {:>12} {:>12} {:>7}", "Region",
+               "Tasks", "Calls", "Min", "Max", "Mean", "Imbal");
+      for (const TimerSummary &Sum : Summary) {
+         // Indent nested regions and show only the last name in the path
+         std::string Label(2 * Sum.Depth, ' ');
+         Label += Sum.Path.substr(Sum.Path.rfind('/') + 1);
+         LOG_INFO("{:<40} {:>5} {:>10} {:>12.6f} {:>12.6f} {:>12.6f} {:>7.3f}",
+                  Label, Sum.NumTasks, Sum.Count, Sum.MinTime, Sum.MaxTime,
+                  Sum.MeanTime, Sum.Imbalance);
+      }
+   }
+
+   Err     = clear();
+   Enabled = false;
+
+   return Err;
+
+} // end finalize
+
+} // end namespace OMEGA
+
+//===----------------------------------------------------------------------===//
@@ -0,0 +1,155 @@
+#ifndef OMEGA_TIMER_H
+#define OMEGA_TIMER_H
+//===-- infra/Timer.h - hierarchical timers ---------------------*- C++ -*-===//
+//
+/// \file
+/// \brief Defines hierarchical timers for Omega
+///
+/// Timers measure the wall clock time spent in named regions of the code.
+/// Regions can be nested and each region is identified by its path from
+/// the outermost region (eg "Halo:finish/Halo:wait"), so the same name
+/// can appear under different parents. Regions are usually timed with a
+/// TimerScope object that starts the timer on construction and stops it
+/// when it goes out of scope. When timers are disabled, a TimerScope only
+/// checks a single flag, so instrumented code can remain in place. At
+/// finalize, the times on all tasks are reduced to a min/max/mean summary
+/// and load imbalance that is written to the log.
+///
+/// Timers are only recorded on the thread that initialized them. Calls
+/// from any other thread (eg the asynchronous IO writer) are ignored.
+//
+//===----------------------------------------------------------------------===//
+
+#include "DataTypes.h"
+#include "mpi.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace OMEGA {
+
+/// Cross-task summary of a single timed region
+struct TimerSummary {
+   std::string Path; ///< full path of region, names separated by '/'
+   I4 Depth;         ///< nesting depth, outermost regions have depth 0
+   I4 NumTasks;      ///< number of tasks that timed this region
+   I8 Count;         ///< number of calls summed over all tasks
+   R8 MinTime;       ///< minimum time (seconds) over tasks
+   R8 MaxTime;       ///< maximum time (seconds) over tasks
+   R8 MeanTime;      ///< mean time (seconds) over tasks timing region
+   R8 Imbalance;     ///< load imbalance (Max - Mean)/Max
+};
+
+/// The Timer class holds the tree of timed regions for the local task.
+/// All members are static since there is a single timer tree per task.
+class Timer {
+
+ private:
+   /// A single timed region within the timer tree
+   struct Region {
+      std::string Name;     ///< name of region
+      I4 Parent;            ///< index of parent region (-1 for root)
+      std::vector<I4> Kids; ///< indices of nested regions
+      R8 Total;             ///< accumulated time in seconds
+      I8 Count;             ///< number of completed calls
+      R8 StartTime;         ///< time of most recent start
+   };
+
+   static bool Enabled;               ///< true if timers are recorded
+   static MPI_Comm Comm;              ///< communicator for summaries
+   static std::thread::id Owner;      ///< thread that records timers
+   static std::vector<Region> Tree;   ///< all regions, index 0 is root
+   static std::vector<I4> ActiveList; ///< stack of running regions
+
+   /// Returns the full path of a region
+   static std::string getPath(I4 Index ///< [in] index of region
+   );
+
+   /// Returns the index of a region from its full path or -1 if not found
+   static I4 findPath(const std::string &Path ///< [in] full path of region
+   );
+
+ public:
+   /// Initializes the timers. Summaries are reduced over the tasks in
+   /// InComm. If Enable is false, timers can be turned on later with
+   /// enable().
+   static void init(MPI_Comm InComm,   ///< [in] communicator for summaries
+                    bool Enable = true ///< [in] start recording timers
+   );
+
+   /// Returns true if timers are being recorded
+   static bool isEnabled() { return Enabled; }
+
+   /// Starts recording timers
+   static void enable();
+
+   /// Stops recording timers. Regions that are already running can still
+   /// be stopped.
+   static void disable();
+
+   /// Starts a region nested within the currently running region
+   static void start(const char *Name ///< [in] name of region
+   );
+
+   /// Stops the currently running region, which must match Name
+   static int stop(const char *Name ///< [in] name of region
+   );
+
+   /// Returns the accumulated local time of a region from its full path or
+   /// zero if the region has not been timed
+   static R8 getTime(const std::string &Path ///< [in] full path of region
+   );
+
+   /// Returns the number of completed local calls of a region
+   static I8 getCount(const std::string &Path ///< [in] full path of region
+   );
+
+   /// Reduces all regions across tasks. Must be called by all tasks in the
+   /// timer communicator. Regions appear in tree order with nested regions
+   /// following their parent.
+   static int summarize(
+       std::vector<TimerSummary> &Summary ///< [out] summary of all regions
+   );
+
+   /// Removes all timed regions. Fails if any region is still running.
+   static int clear();
+
+   /// Writes the timer summary to the log on the master task, then clears
+   /// and disables the timers. Must be called by all tasks.
+   static int finalize();
+
+}; // end class Timer
+
+/// A TimerScope times the enclosing scope. The region is started on
+/// construction and stopped on destruction if timers were enabled at
+/// construction.
+class TimerScope {
+
+ private:
+   const char *Name; ///< name of region
+   bool Active;      ///< true if the region was started
+
+ public:
+   explicit TimerScope(const char *InName ///< [in] name of region
+                       )
+       : Name(InName), Active(Timer::isEnabled()) {
+      if (Active)
+         Timer::start(Name);
+   }
+
+   ~TimerScope() {
+      if (Active)
+         Timer::stop(Name);
+   }
+
+   // Forbid copy and move so each region is stopped exactly once
+   TimerScope(const TimerScope &)            = delete;
+   TimerScope &operator=(const TimerScope &) = delete;
+
+}; // end class TimerScope
+
+} // namespace OMEGA
+
+//===----------------------------------------------------------------------===//
+#endif // defined OMEGA_TIMER_H
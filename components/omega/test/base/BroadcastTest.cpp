@@ -14,6 +14,8 @@
 #include "mpi.h"
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 template <class MyType>
 void TestBroadcast(OMEGA::MachEnv *Env, std::string TypeName) {
@@ -123,6 +125,85 @@ void TestBroadcast(OMEGA::MachEnv *Env, std::string TypeName) {
    }
 }
 
+//------------------------------------------------------------------------------
+// Tests a BroadcastPack of mixed values using both the blocking and
+// non-blocking broadcasts, along with the vector<bool> broadcast
+void TestBroadcastPack(OMEGA::MachEnv *Env) {
+
+   const int MyTask   = Env->getMyTask();
+   const int RootTask = 2;
+   const bool IsRoot  = (MyTask == RootTask);
+
+   for (bool NonBlocking : {false, true}) {
+
+      OMEGA::I4 ValI4 = -1;
+      OMEGA::I8 ValI8 = -1;
+      OMEGA::R4 ValR4 = -1.0;
+      OMEGA::R8 ValR8 = -1.0;
+      bool ValBool    = false;
+      std::string ValStr;
+      std::vector<OMEGA::I4> VecI4;
+      std::vector<OMEGA::R8> VecR8(2, -1.0);
+      std::vector<bool> VecBool;
+
+      if (IsRoot) {
+         ValI4   = 4;
+         ValI8   = 8000000000;
+         ValR4   = 4.5;
+         ValR8   = 8.5;
+         ValBool = true;
+         ValStr  = "BroadcastPack";
+         VecI4   = {1, 2, 3};
+         VecR8   = {1.5, 2.5, 3.5, 4.5};
+         VecBool = {true, false, true};
+      }
+
+      OMEGA::BroadcastPack Pack(Env, RootTask);
+      Pack.add(ValI4);
+      Pack.add(ValI8);
+      Pack.add(ValR4);
+      Pack.add(ValR8);
+      Pack.add(ValBool);
+      Pack.add(ValStr);
+      Pack.add(VecI4);
+      Pack.add(VecR8);
+      Pack.add(VecBool);
+
+      int Err = 0;
+      if (NonBlocking) {
+         Err = Pack.ibroadcast();
+         if (Err == 0)
+            Err = Pack.wait();
+      } else {
+         Err = Pack.broadcast();
+      }
+
+      std::string Mode = NonBlocking ? "non-blocking" : "blocking";
+      if (Err == 0 && ValI4 == 4 && ValI8 == 8000000000 && ValR4 == 4.5 &&
+          ValR8 == 8.5 && ValBool && ValStr == "BroadcastPack" &&
+          VecI4 == std::vector<OMEGA::I4>{1, 2, 3} &&
+          VecR8 == std::vector<OMEGA::R8>{1.5, 2.5, 3.5, 4.5} &&
+          VecBool == std::vector<bool>{true, false, true})
+         std::cout << Mode << " BroadcastPack at rank " << MyTask << ": PASS"
+                   << std::endl;
+      else
+         std::cout << Mode << " BroadcastPack at rank " << MyTask << ": FAIL"
+                   << std::endl;
+   }
+
+   // Test broadcasting a vector of bools
+   std::vector<bool> MyVector;
+   if (IsRoot)
+      MyVector = {false, true, true, false, true};
+   OMEGA::Broadcast(MyVector, Env, RootTask);
+   if (MyVector == std::vector<bool>{false, true, true, false, true})
+      std::cout << "bool vector broadcast at rank " << MyTask << ": PASS"
+                << std::endl;
+   else
+      std::cout << "bool vector broadcast at rank " << MyTask << ": FAIL"
+                << std::endl;
+}
+
 //------------------------------------------------------------------------------
 // The test driver for MachEnv. This tests the values stored in the Default
 // Environment and three other based on the three subsetting options.  All
@@ -174,6 +255,9 @@ int main(int argc, char *argv[]) {
    // string Broadcast tests
    TestBroadcast<std::string>(DefEnv, "string");
 
+   // Mixed value BroadcastPack tests
+   TestBroadcastPack(DefEnv);
+
    // Initialize general subset environment
    int InclSize     = 4;
    int InclTasks[4] = {1, 2, 5, 7};
@@ -13,12 +13,19 @@
 
 #include "Decomp.h"
 #include "DataTypes.h"
+#include "Halo.h"
 #include "IO.h"
 #include "Logging.h"
 #include "MachEnv.h"
+#include "Timer.h"
 #include "mpi.h"
 
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
 
 //------------------------------------------------------------------------------
 // The initialization routine for Decomp testing. It calls various
@@ -35,6 +42,10 @@ int initDecompTest() {
    OMEGA::MachEnv *DefEnv = OMEGA::MachEnv::getDefaultEnv();
    MPI_Comm DefComm       = DefEnv->getComm();
 
+   // Initialize the timers, which are used to check which path was taken
+   // when a decomposition is created
+   OMEGA::Timer::init(DefComm);
+
    // Initialize the IO system
    Err = OMEGA::IO::init(DefComm);
    if (Err != 0)
@@ -48,6 +59,590 @@ int initDecompTest() {
    return Err;
 }
 
+//------------------------------------------------------------------------------
+// Creates a decomposition of the same mesh with the distributed ParMETIS
+// KWay method and checks that all cells, edges and vertices are owned by
+// exactly one task and that the cell locations are consistent.
+
+int parMetisDecompTest(const OMEGA::Decomp *RefDecomp // [in] default decomp
+) {
+
+   int Err = 0;
+
+   OMEGA::MachEnv *DefEnv = OMEGA::MachEnv::getDefaultEnv();
+   MPI_Comm Comm          = DefEnv->getComm();
+   OMEGA::I4 MyTask       = DefEnv->getMyTask();
+   OMEGA::I4 NumTasks     = DefEnv->getNumTasks();
+
+   OMEGA::Decomp ParDecompTmp("ParMetis", DefEnv, NumTasks,
+                              OMEGA::PartMethodParMetisKWay,
+                              RefDecomp->HaloWidth, "OmegaMesh.nc");
+   OMEGA::Decomp *ParDecomp = OMEGA::Decomp::get("ParMetis");
+   if (ParDecomp == nullptr) {
+      LOG_INFO("DecompTest: ParMetis decomp creation FAIL");
+      return -1;
+   }
+
+   if (ParDecomp->NCellsGlobal == RefDecomp->NCellsGlobal &&
+       ParDecomp->NEdgesGlobal == RefDecomp->NEdgesGlobal &&
+       ParDecomp->NVerticesGlobal == RefDecomp->NVerticesGlobal) {
+      LOG_INFO("DecompTest: ParMetis global size test PASS");
+   } else {
+      LOG_INFO("DecompTest: ParMetis global size test FAIL");
+      Err = -1;
+   }
+
+   // Each owned cell must be located on this task at its own index and
+   // each halo cell must be located on a remote task
+   OMEGA::I4 LocErrs = 0;
+   for (int Cell = 0; Cell < ParDecomp->NCellsOwned; ++Cell) {
+      if (ParDecomp->CellLocH(Cell, 0) != MyTask ||
+          ParDecomp->CellLocH(Cell, 1) != Cell)
+         ++LocErrs;
+   }
+   for (int Cell = ParDecomp->NCellsOwned; Cell < ParDecomp->NCellsAll;
+        ++Cell) {
+      if (ParDecomp->CellLocH(Cell, 0) == MyTask)
+         ++LocErrs;
+   }
+   if (LocErrs == 0) {
+      LOG_INFO("DecompTest: ParMetis cell location test PASS");
+   } else {
+      LOG_INFO("DecompTest: ParMetis cell location test FAIL {}", LocErrs);
+      Err = -1;
+   }
+
+   // Sum the owned IDs across tasks as in the default decomposition test
+   OMEGA::I4 LocSums[3] = {0, 0, 0};
+   OMEGA::I4 Sums[3]    = {0, 0, 0};
+   OMEGA::I4 RefSums[3] = {0, 0, 0};
+   for (int n = 0; n < ParDecomp->NCellsGlobal; ++n)
+      RefSums[0] += n + 1;
+   for (int n = 0; n < ParDecomp->NEdgesGlobal; ++n)
+      RefSums[1] += n + 1;
+   for (int n = 0; n < ParDecomp->NVerticesGlobal; ++n)
+      RefSums[2] += n + 1;
+   for (int n = 0; n < ParDecomp->NCellsOwned; ++n)
+      LocSums[0] += ParDecomp->CellIDH(n);
+   for (int n = 0; n < ParDecomp->NEdgesOwned; ++n)
+      LocSums[1] += ParDecomp->EdgeIDH(n);
+   for (int n = 0; n < ParDecomp->NVerticesOwned; ++n)
+      LocSums[2] += ParDecomp->VertexIDH(n);
+   MPI_Allreduce(LocSums, Sums, 3, MPI_INT32_T, MPI_SUM, Comm);
+
+   if (Sums[0] == RefSums[0] && Sums[1] == RefSums[1] &&
+       Sums[2] == RefSums[2]) {
+      LOG_INFO("DecompTest: ParMetis sum ID test PASS");
+   } else {
+      LOG_INFO("DecompTest: ParMetis sum ID test FAIL");
+      Err = -1;
+   }
+
+   OMEGA::Decomp::erase("ParMetis");
+
+   return Err;
+
+} // end parMetisDecompTest
+
+//------------------------------------------------------------------------------
+// Counts the number of entries that differ between two host index arrays
+
+template <class ArrayType>
+OMEGA::I4 countDiffs(const ArrayType &Array1, // [in] first array to compare
+                     const ArrayType &Array2  // [in] second array to compare
+) {
+   if (Array1.totElems() != Array2.totElems())
+      return 1;
+   OMEGA::I4 NDiffs = 0;
+   for (int n = 0; n < Array1.totElems(); ++n) {
+      if (Array1.data()[n] != Array2.data()[n])
+         ++NDiffs;
+   }
+   return NDiffs;
+}
+
+//------------------------------------------------------------------------------
+// Creates a decomposition that writes a decomposition cache and a second
+// decomposition that reads the cache, and checks that both reproduce the
+// default decomposition. A decomposition with a different halo width must
+// not use the cache.
+
+int decompCacheTest(const OMEGA::Decomp *RefDecomp // [in] default decomp
+) {
+
+   int Err = 0;
+
+   OMEGA::MachEnv *DefEnv    = OMEGA::MachEnv::getDefaultEnv();
+   MPI_Comm Comm             = DefEnv->getComm();
+   OMEGA::I4 NumTasks        = DefEnv->getNumTasks();
+   std::string CacheFile     = "DecompTestCache.bin";
+   std::string CacheReadPath = "Decomp:create/Decomp:readCache";
+   std::string PartitionPath = "Decomp:create/Decomp:partitionMesh";
+
+   // Remove any cache left over from a previous test
+   if (DefEnv->isMasterTask())
+      std::remove(CacheFile.c_str());
+   MPI_Barrier(Comm);
+
+   // The first decomposition computes the partition and writes the cache,
+   // the second reads it
+   OMEGA::DecompOptions CacheOptions;
+   CacheOptions.CacheFileName = CacheFile;
+   OMEGA::Decomp WriteDecompTmp("CacheWrite", DefEnv, NumTasks,
+                                OMEGA::PartMethodMetisKWay,
+                                RefDecomp->HaloWidth, "OmegaMesh.nc",
+                                CacheOptions);
+   OMEGA::I8 ReadCount = OMEGA::Timer::getCount(CacheReadPath);
+   OMEGA::I8 PartCount = OMEGA::Timer::getCount(PartitionPath);
+   OMEGA::Decomp ReadDecompTmp("CacheRead", DefEnv, NumTasks,
+                               OMEGA::PartMethodMetisKWay,
+                               RefDecomp->HaloWidth, "OmegaMesh.nc",
+                               CacheOptions);
+
+   // The second decomposition must have been read from the cache rather
+   // than recomputed
+   if (OMEGA::Timer::getCount(CacheReadPath) == ReadCount + 1 &&
+       OMEGA::Timer::getCount(PartitionPath) == PartCount) {
+      LOG_INFO("DecompTest: CacheRead read path test PASS");
+   } else {
+      LOG_INFO("DecompTest: CacheRead read path test FAIL");
+      Err = -1;
+   }
+
+   for (std::string Name : {"CacheWrite", "CacheRead"}) {
+      OMEGA::Decomp *TstDecomp = OMEGA::Decomp::get(Name);
+      if (TstDecomp == nullptr) {
+         LOG_INFO("DecompTest: {} decomp creation FAIL", Name);
+         Err = -1;
+         continue;
+      }
+
+      OMEGA::I4 NDiffs = 0;
+      if (TstDecomp->NCellsOwned != RefDecomp->NCellsOwned ||
+          TstDecomp->NCellsAll != RefDecomp->NCellsAll ||
+          TstDecomp->NEdgesOwned != RefDecomp->NEdgesOwned ||
+          TstDecomp->NEdgesAll != RefDecomp->NEdgesAll ||
+          TstDecomp->NVerticesOwned != RefDecomp->NVerticesOwned ||
+          TstDecomp->NVerticesAll != RefDecomp->NVerticesAll)
+         ++NDiffs;
+      NDiffs += countDiffs(TstDecomp->NCellsHaloH, RefDecomp->NCellsHaloH);
+      NDiffs += countDiffs(TstDecomp->CellIDH, RefDecomp->CellIDH);
+      NDiffs += countDiffs(TstDecomp->CellLocH, RefDecomp->CellLocH);
+      NDiffs += countDiffs(TstDecomp->EdgeIDH, RefDecomp->EdgeIDH);
+      NDiffs += countDiffs(TstDecomp->EdgeLocH, RefDecomp->EdgeLocH);
+      NDiffs += countDiffs(TstDecomp->VertexIDH, RefDecomp->VertexIDH);
+      NDiffs += countDiffs(TstDecomp->VertexLocH, RefDecomp->VertexLocH);
+      NDiffs += countDiffs(TstDecomp->CellsOnCellH, RefDecomp->CellsOnCellH);
+      NDiffs += countDiffs(TstDecomp->EdgesOnCellH, RefDecomp->EdgesOnCellH);
+      NDiffs += countDiffs(TstDecomp->NEdgesOnCellH, RefDecomp->NEdgesOnCellH);
+      NDiffs +=
+          countDiffs(TstDecomp->VerticesOnCellH, RefDecomp->VerticesOnCellH);
+      NDiffs += countDiffs(TstDecomp->CellsOnEdgeH, RefDecomp->CellsOnEdgeH);
+      NDiffs += countDiffs(TstDecomp->EdgesOnEdgeH, RefDecomp->EdgesOnEdgeH);
+      NDiffs += countDiffs(TstDecomp->NEdgesOnEdgeH, RefDecomp->NEdgesOnEdgeH);
+      NDiffs +=
+          countDiffs(TstDecomp->VerticesOnEdgeH, RefDecomp->VerticesOnEdgeH);
+      NDiffs +=
+          countDiffs(TstDecomp->CellsOnVertexH, RefDecomp->CellsOnVertexH);
+      NDiffs +=
+          countDiffs(TstDecomp->EdgesOnVertexH, RefDecomp->EdgesOnVertexH);
+
+      if (NDiffs == 0) {
+         LOG_INFO("DecompTest: {} cache test PASS", Name);
+      } else {
+         LOG_INFO("DecompTest: {} cache test FAIL {}", Name, NDiffs);
+         Err = -1;
+      }
+   }
+
+   // A different halo width changes the cache key so the decomposition
+   // must be recomputed with the new halo width
+   OMEGA::I4 NewHaloWidth = RefDecomp->HaloWidth - 1;
+   OMEGA::Decomp HaloDecompTmp("CacheHalo", DefEnv, NumTasks,
+                               OMEGA::PartMethodMetisKWay, NewHaloWidth,
+                               "OmegaMesh.nc", CacheOptions);
+   OMEGA::Decomp *HaloDecomp = OMEGA::Decomp::get("CacheHalo");
+   if (HaloDecomp != nullptr && HaloDecomp->HaloWidth == NewHaloWidth &&
+       HaloDecomp->NCellsHaloH.totElems() == NewHaloWidth &&
+       HaloDecomp->NCellsOwned == RefDecomp->NCellsOwned &&
+       HaloDecomp->NCellsAll <= RefDecomp->NCellsAll) {
+      LOG_INFO("DecompTest: cache key mismatch test PASS");
+   } else {
+      LOG_INFO("DecompTest: cache key mismatch test FAIL");
+      Err = -1;
+   }
+
+   OMEGA::Decomp::erase("CacheWrite");
+   OMEGA::Decomp::erase("CacheRead");
+   OMEGA::Decomp::erase("CacheHalo");
+   MPI_Barrier(Comm);
+   if (DefEnv->isMasterTask())
+      std::remove(CacheFile.c_str());
+
+   return Err;
+
+} // end decompCacheTest
+
+//------------------------------------------------------------------------------
+// Tests reading the mesh with a dedicated IO layout in which every task is
+// an IO task. The result must match the default decomposition and the
+// default IO system must be unchanged afterwards.
+
+int meshIOTasksTest(const OMEGA::Decomp *RefDecomp // [in] default decomp
+) {
+
+   int Err = 0;
+
+   OMEGA::MachEnv *DefEnv = OMEGA::MachEnv::getDefaultEnv();
+   OMEGA::I4 NumTasks     = DefEnv->getNumTasks();
+   int DefaultSysID       = OMEGA::IO::SysID;
+
+   OMEGA::DecompOptions MeshIOOptions;
+   MeshIOOptions.MeshIOTasks = NumTasks;
+   OMEGA::Decomp MeshIODecompTmp("MeshIO", DefEnv, NumTasks,
+                                 OMEGA::PartMethodMetisKWay,
+                                 RefDecomp->HaloWidth, "OmegaMesh.nc",
+                                 MeshIOOptions);
+
+   OMEGA::Decomp *MeshIODecomp = OMEGA::Decomp::get("MeshIO");
+   if (MeshIODecomp == nullptr) {
+      LOG_INFO("DecompTest: MeshIO decomp creation FAIL");
+      return -1;
+   }
+
+   OMEGA::I4 NDiffs = 0;
+   if (MeshIODecomp->NCellsAll != RefDecomp->NCellsAll ||
+       MeshIODecomp->NEdgesAll != RefDecomp->NEdgesAll ||
+       MeshIODecomp->NVerticesAll != RefDecomp->NVerticesAll)
+      ++NDiffs;
+   NDiffs += countDiffs(MeshIODecomp->CellIDH, RefDecomp->CellIDH);
+   NDiffs += countDiffs(MeshIODecomp->CellsOnCellH, RefDecomp->CellsOnCellH);
+   NDiffs += countDiffs(MeshIODecomp->EdgesOnEdgeH, RefDecomp->EdgesOnEdgeH);
+   NDiffs +=
+       countDiffs(MeshIODecomp->EdgesOnVertexH, RefDecomp->EdgesOnVertexH);
+
+   if (NDiffs == 0 && OMEGA::IO::SysID == DefaultSysID) {
+      LOG_INFO("DecompTest: mesh IO tasks test PASS");
+   } else {
+      LOG_INFO("DecompTest: mesh IO tasks test FAIL {}", NDiffs);
+      Err = -1;
+   }
+
+   OMEGA::Decomp::erase("MeshIO");
+
+   return Err;
+
+} // end meshIOTasksTest
+
+//------------------------------------------------------------------------------
+// Checks that every global cell of a decomposition is owned by exactly one
+// task and that a halo exchange of the global IDs reproduces the halo IDs.
+// Returns the number of differences found.
+
+int checkCellPartition(OMEGA::Decomp *InDecomp // [in] decomp to check
+) {
+
+   OMEGA::MachEnv *DefEnv = OMEGA::MachEnv::getDefaultEnv();
+   MPI_Comm Comm          = DefEnv->getComm();
+
+   // Each cell is owned exactly once so the owned counts and the sum
+   // of owned IDs must match those of all global cells
+   OMEGA::I8 LocCounts[2] = {InDecomp->NCellsOwned, 0};
+   for (int Cell = 0; Cell < InDecomp->NCellsOwned; ++Cell)
+      LocCounts[1] += InDecomp->CellIDH(Cell);
+   OMEGA::I8 GlobCounts[2] = {0, 0};
+   MPI_Allreduce(LocCounts, GlobCounts, 2, MPI_INT64_T, MPI_SUM, Comm);
+   OMEGA::I8 NCellsGlobal = InDecomp->NCellsGlobal;
+
+   OMEGA::I4 NDiffs = 0;
+   if (GlobCounts[0] != NCellsGlobal ||
+       GlobCounts[1] != NCellsGlobal * (NCellsGlobal + 1) / 2)
+      ++NDiffs;
+
+   // Exchange the global IDs of the owned cells to fill the halo
+   OMEGA::Halo CheckHalo(DefEnv, InDecomp);
+   OMEGA::ArrayHost1DI4 CellIDs("CellIDs", InDecomp->NCellsSize);
+   yakl::memset(CellIDs, 0);
+   for (int Cell = 0; Cell < InDecomp->NCellsOwned; ++Cell)
+      CellIDs(Cell) = InDecomp->CellIDH(Cell);
+   if (CheckHalo.exchangeFullArrayHalo(CellIDs, OMEGA::OnCell) != 0)
+      ++NDiffs;
+   for (int Cell = 0; Cell < InDecomp->NCellsAll; ++Cell) {
+      if (CellIDs(Cell) != InDecomp->CellIDH(Cell))
+         ++NDiffs;
+   }
+
+   return NDiffs;
+
+} // end checkCellPartition
+
+//------------------------------------------------------------------------------
+// Reads the active levels (maxLevelCell) of the owned cells of a
+// decomposition and returns the load imbalance of the level count across
+// tasks, defined as the maximum over the mean of the per-task sums. Returns
+// non-zero if the levels could not be read or do not vary across cells.
+
+int levelImbalance(const OMEGA::Decomp *InDecomp, // [in] decomp to check
+                   OMEGA::R8 &Imbalance           // [out] max/mean levels
+) {
+
+   int Err = 0;
+
+   OMEGA::MachEnv *DefEnv = OMEGA::MachEnv::getDefaultEnv();
+   MPI_Comm Comm          = DefEnv->getComm();
+   OMEGA::I4 NumTasks     = DefEnv->getNumTasks();
+
+   int FileID;
+   Err = OMEGA::IO::openFile(FileID, "OmegaMesh.nc", OMEGA::IO::ModeRead);
+   if (Err != 0)
+      return Err;
+   if (!OMEGA::IO::existsVar(FileID, "maxLevelCell")) {
+      OMEGA::IO::closeFile(FileID);
+      return 1;
+   }
+
+   OMEGA::I4 NCellsOwned = InDecomp->NCellsOwned;
+   std::vector<OMEGA::I4> Dims{InDecomp->NCellsGlobal};
+   std::vector<OMEGA::I4> Offset(NCellsOwned);
+   for (int Cell = 0; Cell < NCellsOwned; ++Cell)
+      Offset[Cell] = InDecomp->CellIDH(Cell) - 1;
+
+   int LevelsDecomp;
+   Err = OMEGA::IO::createDecomp(LevelsDecomp, OMEGA::IO::IOTypeI4, 1, Dims,
+                                 NCellsOwned, Offset, OMEGA::IO::RearrBox);
+   std::vector<OMEGA::I4> Levels(NCellsOwned, 0);
+   int LevelsID;
+   if (Err == 0) {
+      Err = OMEGA::IO::readArray(Levels.data(), NCellsOwned, "maxLevelCell",
+                                 FileID, LevelsDecomp, LevelsID);
+      OMEGA::IO::destroyDecomp(LevelsDecomp);
+   }
+   OMEGA::IO::closeFile(FileID);
+   if (Err != 0)
+      return Err;
+
+   // Sum the levels on each task and check that the levels vary, reducing
+   // the minimum and the negative of the maximum level with one MPI_MIN
+   const OMEGA::I4 MaxI4 = std::numeric_limits<OMEGA::I4>::max();
+   OMEGA::I8 LocLevels   = 0;
+   OMEGA::I4 LocRange[2] = {MaxI4, MaxI4};
+   for (int Cell = 0; Cell < NCellsOwned; ++Cell) {
+      LocLevels += Levels[Cell];
+      LocRange[0] = std::min(LocRange[0], Levels[Cell]);
+      LocRange[1] = std::min(LocRange[1], -Levels[Cell]);
+   }
+   OMEGA::I4 Range[2];
+   MPI_Allreduce(LocRange, Range, 2, MPI_INT32_T, MPI_MIN, Comm);
+   if (-Range[1] <= Range[0])
+      return 1;
+
+   OMEGA::I8 MaxLevels = 0;
+   OMEGA::I8 SumLevels = 0;
+   MPI_Allreduce(&LocLevels, &MaxLevels, 1, MPI_INT64_T, MPI_MAX, Comm);
+   MPI_Allreduce(&LocLevels, &SumLevels, 1, MPI_INT64_T, MPI_SUM, Comm);
+   Imbalance = static_cast<OMEGA::R8>(MaxLevels) * NumTasks / SumLevels;
+
+   return Err;
+
+} // end levelImbalance
+
+//------------------------------------------------------------------------------
+// Creates decompositions weighted by the active levels in each cell, with
+// and without the additional cell-count constraint, and checks them. The
+// levels must be present in the mesh and the level count summed over the
+// owned cells of each task must be better balanced than in the unweighted
+// default decomposition.
+
+int weightedDecompTest(const OMEGA::Decomp *RefDecomp // [in] default decomp
+) {
+
+   int Err = 0;
+
+   OMEGA::MachEnv *DefEnv = OMEGA::MachEnv::getDefaultEnv();
+   OMEGA::I4 NumTasks     = DefEnv->getNumTasks();
+
+   OMEGA::R8 RefImbalance = 0.0;
+   if (levelImbalance(RefDecomp, RefImbalance) == 0) {
+      LOG_INFO("DecompTest: weighted decomp read levels PASS");
+   } else {
+      LOG_INFO("DecompTest: weighted decomp read levels FAIL");
+      return -1;
+   }
+
+   std::vector<OMEGA::PartWeight> Weights{OMEGA::PartWeightLevels,
+                                          OMEGA::PartWeightLevelsMemory};
+   for (OMEGA::PartWeight Weight : Weights) {
+
+      OMEGA::DecompOptions WgtOptions;
+      WgtOptions.Weight = Weight;
+      OMEGA::Decomp WgtDecompTmp("Weighted", DefEnv, NumTasks,
+                                 OMEGA::PartMethodMetisKWay,
+                                 RefDecomp->HaloWidth, "OmegaMesh.nc",
+                                 WgtOptions);
+      OMEGA::Decomp *WgtDecomp = OMEGA::Decomp::get("Weighted");
+      if (WgtDecomp == nullptr) {
+         LOG_INFO("DecompTest: weighted decomp creation FAIL");
+         return -1;
+      }
+
+      OMEGA::I4 NDiffs = checkCellPartition(WgtDecomp);
+      if (NDiffs == 0) {
+         LOG_INFO("DecompTest: weighted decomp test PASS");
+      } else {
+         LOG_INFO("DecompTest: weighted decomp test FAIL {}", NDiffs);
+         Err = -1;
+      }
+
+      // A single task has nothing to balance
+      OMEGA::R8 WgtImbalance = 0.0;
+      int BalErr             = levelImbalance(WgtDecomp, WgtImbalance);
+      if (BalErr == 0 && (NumTasks == 1 || WgtImbalance < RefImbalance)) {
+         LOG_INFO("DecompTest: weighted decomp balance PASS");
+      } else {
+         LOG_INFO("DecompTest: weighted decomp balance FAIL {} {}",
+                  WgtImbalance, RefImbalance);
+         Err = -1;
+      }
+
+      OMEGA::Decomp::erase("Weighted");
+   }
+
+   return Err;
+
+} // end weightedDecompTest
+
+//------------------------------------------------------------------------------
+// Creates a decomposition partitioned first across nodes and then within
+// each node. Nodes are limited to four tasks so several nodes are tested
+// on a single machine. Every task must own cells and the partition must
+// pass the ownership and halo checks.
+
+int nodeDecompTest(const OMEGA::Decomp *RefDecomp // [in] default decomp
+) {
+
+   int Err = 0;
+
+   OMEGA::MachEnv *DefEnv = OMEGA::MachEnv::getDefaultEnv();
+   OMEGA::I4 NumTasks     = DefEnv->getNumTasks();
+
+   DefEnv->setNodeSize(4);
+
+   OMEGA::Decomp NodeDecompTmp("Node", DefEnv, NumTasks,
+                               OMEGA::PartMethodMetisKWayNode,
+                               RefDecomp->HaloWidth, "OmegaMesh.nc");
+   OMEGA::Decomp *NodeDecomp = OMEGA::Decomp::get("Node");
+   if (NodeDecomp == nullptr) {
+      LOG_INFO("DecompTest: node decomp creation FAIL");
+      DefEnv->setNodeSize(0);
+      return -1;
+   }
+
+   OMEGA::I4 NDiffs = checkCellPartition(NodeDecomp);
+   if (NodeDecomp->NCellsOwned <= 0)
+      ++NDiffs;
+
+   if (NDiffs == 0) {
+      LOG_INFO("DecompTest: node decomp test PASS");
+   } else {
+      LOG_INFO("DecompTest: node decomp test FAIL {}", NDiffs);
+      Err = -1;
+   }
+
+   OMEGA::Decomp::erase("Node");
+   DefEnv->setNodeSize(0);
+
+   return Err;
+
+} // end nodeDecompTest
+
+//------------------------------------------------------------------------------
+// Creates a decomposition with reverse Cuthill-McKee ordering of the owned
+// cells. The same cells must be owned as in the default decomposition and
+// a halo exchange of the global IDs must reproduce the halo IDs, which
+// verifies that the halo locations were updated to the new ordering.
+
+int rcmDecompTest(const OMEGA::Decomp *RefDecomp // [in] default decomp
+) {
+
+   int Err = 0;
+
+   OMEGA::MachEnv *DefEnv = OMEGA::MachEnv::getDefaultEnv();
+   OMEGA::I4 NumTasks     = DefEnv->getNumTasks();
+
+   OMEGA::DecompOptions RCMOptions;
+   RCMOptions.Order = OMEGA::CellOrderRCM;
+   OMEGA::Decomp RCMDecompTmp("RCM", DefEnv, NumTasks,
+                              OMEGA::PartMethodMetisKWay,
+                              RefDecomp->HaloWidth, "OmegaMesh.nc",
+                              RCMOptions);
+   OMEGA::Decomp *RCMDecomp = OMEGA::Decomp::get("RCM");
+   if (RCMDecomp == nullptr) {
+      LOG_INFO("DecompTest: RCM decomp creation FAIL");
+      return -1;
+   }
+
+   // The owned cells are the same set in a different order and the halo
+   // cells are unchanged
+   std::vector<OMEGA::I4> RefOwned(RefDecomp->CellIDH.data(),
+                                   RefDecomp->CellIDH.data() +
+                                       RefDecomp->NCellsOwned);
+   std::vector<OMEGA::I4> RCMOwned(RCMDecomp->CellIDH.data(),
+                                   RCMDecomp->CellIDH.data() +
+                                       RCMDecomp->NCellsOwned);
+   std::sort(RCMOwned.begin(), RCMOwned.end());
+   OMEGA::I4 NDiffs = (RefOwned == RCMOwned) ? 0 : 1;
+   if (RCMDecomp->NCellsAll != RefDecomp->NCellsAll) {
+      ++NDiffs;
+   } else {
+      for (int Cell = RefDecomp->NCellsOwned; Cell < RefDecomp->NCellsAll;
+           ++Cell) {
+         if (RCMDecomp->CellIDH(Cell) != RefDecomp->CellIDH(Cell))
+            ++NDiffs;
+      }
+   }
+   if (NDiffs == 0) {
+      LOG_INFO("DecompTest: RCM cell list test PASS");
+   } else {
+      LOG_INFO("DecompTest: RCM cell list test FAIL {}", NDiffs);
+      Err = -1;
+   }
+
+   // Exchange the global IDs of the owned cells and edges to fill the halos
+   OMEGA::Halo RCMHalo(DefEnv, RCMDecomp);
+   OMEGA::ArrayHost1DI4 CellIDs("CellIDs", RCMDecomp->NCellsSize);
+   OMEGA::ArrayHost1DI4 EdgeIDs("EdgeIDs", RCMDecomp->NEdgesSize);
+   yakl::memset(CellIDs, 0);
+   yakl::memset(EdgeIDs, 0);
+   for (int Cell = 0; Cell < RCMDecomp->NCellsOwned; ++Cell)
+      CellIDs(Cell) = RCMDecomp->CellIDH(Cell);
+   for (int Edge = 0; Edge < RCMDecomp->NEdgesOwned; ++Edge)
+      EdgeIDs(Edge) = RCMDecomp->EdgeIDH(Edge);
+   if (RCMHalo.exchangeFullArrayHalo(CellIDs, OMEGA::OnCell) != 0 ||
+       RCMHalo.exchangeFullArrayHalo(EdgeIDs, OMEGA::OnEdge) != 0)
+      Err = -1;
+
+   NDiffs = 0;
+   for (int Cell = 0; Cell < RCMDecomp->NCellsAll; ++Cell) {
+      if (CellIDs(Cell) != RCMDecomp->CellIDH(Cell))
+         ++NDiffs;
+   }
+   for (int Edge = 0; Edge < RCMDecomp->NEdgesAll; ++Edge) {
+      if (EdgeIDs(Edge) != RCMDecomp->EdgeIDH(Edge))
+         ++NDiffs;
+   }
+   if (NDiffs == 0) {
+      LOG_INFO("DecompTest: RCM halo location test PASS");
+   } else {
+      LOG_INFO("DecompTest: RCM halo location test FAIL {}", NDiffs);
+      Err = -1;
+   }
+
+   OMEGA::Decomp::erase("RCM");
+
+   return Err;
+
+} // end rcmDecompTest
+
 //------------------------------------------------------------------------------
 // The test driver for Decomp. This tests the decomposition of a sample
 // horizontal domain and verifies the mesh is decomposed correctly.
@@ -130,7 +725,26 @@ int main(int argc, char *argv[]) {
                RefSumVertices);
    }
 
+   // Test the distributed ParMETIS partitioning of the same mesh
+   Err += parMetisDecompTest(DefDecomp);
+
+   // Test writing and reading a decomposition cache
+   Err += decompCacheTest(DefDecomp);
+
+   // Test the reverse Cuthill-McKee ordering of owned cells
+   Err += rcmDecompTest(DefDecomp);
+
+   // Test reading the mesh with a dedicated IO task layout
+   Err += meshIOTasksTest(DefDecomp);
+
+   // Test partitions weighted by the active levels in each cell
+   Err += weightedDecompTest(DefDecomp);
+
+   // Test partitioning across nodes and then within each node
+   Err += nodeDecompTest(DefDecomp);
+
    // Clean up
+   OMEGA::Timer::finalize();
    OMEGA::Decomp::clear();
    OMEGA::MachEnv::removeAll();
 
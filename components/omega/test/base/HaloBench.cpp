@@ -0,0 +1,411 @@
+//===-- Benchmark driver for OMEGA Halo and Decomp ---------------*- C++ -*-===/
+//
+/// \file
+/// \brief Benchmark driver for OMEGA halo exchanges and decompositions
+///
+/// This driver times the construction of decompositions of the default mesh
+/// with a range of halo widths, broken into the phases recorded by the Decomp
+/// timers (mesh read, cell partition, edge and vertex partition and
+/// rearrangement), and times exchangeFullArrayHalo on device arrays of
+/// several ranks, element types and vertical sizes for each halo width. For
+/// every measurement the minimum, maximum and mean across MPI tasks are
+/// reported in JSON, written to a file by the master task, so that results
+/// from different machines, task layouts or code versions can be compared.
+/// The driver accepts the following optional arguments:
+///   --reps N          number of timed exchanges for each array (default 100)
+///   --levels N1,N2..  vertical sizes of the arrays (default 16,64)
+///   --widths W1,W2..  halo widths of the decompositions (default 1,2,3)
+///   --backend NAME    PointToPoint, NeighborCollective or SharedMemory
+///   --output FILE     JSON output file (default HaloBench.json)
+///   --timers on|off   record Omega timers and add their summary to the
+///                     JSON output (default off). The Decomp timers are
+///                     always recorded while the decompositions are created.
+///
+//
+//===-----------------------------------------------------------------------===/
+
+#include "DataTypes.h"
+#include "Decomp.h"
+#include "Halo.h"
+#include "IO.h"
+#include "Logging.h"
+#include "MachEnv.h"
+#include "Timer.h"
+#include "mpi.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Minimum, maximum and mean across tasks of a per-task measurement
+
+struct BenchStats {
+   double Min{0.0};
+   double Max{0.0};
+   double Mean{0.0};
+};
+
+BenchStats reduceStats(double LocalVal, // [in] value on the local task
+                       MPI_Comm Comm    // [in] communicator to reduce over
+) {
+
+   BenchStats Stats;
+   int NumTasks;
+   MPI_Comm_size(Comm, &NumTasks);
+
+   MPI_Allreduce(&LocalVal, &Stats.Min, 1, MPI_DOUBLE, MPI_MIN, Comm);
+   MPI_Allreduce(&LocalVal, &Stats.Max, 1, MPI_DOUBLE, MPI_MAX, Comm);
+   MPI_Allreduce(&LocalVal, &Stats.Mean, 1, MPI_DOUBLE, MPI_SUM, Comm);
+   Stats.Mean /= NumTasks;
+
+   return Stats;
+
+} // end reduceStats
+
+//------------------------------------------------------------------------------
+// Returns the JSON object for a set of statistics
+
+std::string statsToJson(const BenchStats &Stats // [in] stats to write
+) {
+
+   std::ostringstream Out;
+   Out << std::setprecision(6) << std::scientific;
+   Out << "{\"min\": " << Stats.Min << ", \"max\": " << Stats.Max
+       << ", \"mean\": " << Stats.Mean << "}";
+
+   return Out.str();
+
+} // end statsToJson
+
+//------------------------------------------------------------------------------
+// Parses a comma-separated list of integers
+
+std::vector<OMEGA::I4> parseList(const std::string &List // [in] list to parse
+) {
+
+   std::vector<OMEGA::I4> Vals;
+   std::stringstream Stream(List);
+   std::string Item;
+   while (std::getline(Stream, Item, ',')) {
+      if (!Item.empty())
+         Vals.push_back(std::stoi(Item));
+   }
+
+   return Vals;
+
+} // end parseList
+
+//------------------------------------------------------------------------------
+// Returns the local time accumulated so far in a set of timed regions within
+// the partitioning of the mesh when a decomposition is created
+
+double partitionTime(
+    const std::vector<std::string> &Phases // [in] names of timed regions
+) {
+
+   double Time = 0.0;
+   for (const std::string &Phase : Phases)
+      Time += OMEGA::Timer::getTime("Decomp:create/Decomp:partitionMesh/" +
+                                    Phase);
+
+   return Time;
+
+} // end partitionTime
+
+//------------------------------------------------------------------------------
+// This function template times NReps full halo exchanges of the input array
+// and appends a JSON record with the time per exchange and the number of
+// bytes received per exchange to the list of results. The array is exchanged
+// once before timing so that the exchange plan is created.
+
+template <typename T>
+int benchExchange(
+    OMEGA::Halo &MyHalo,              // [in] Halo to exchange with
+    T &Array,                         // [in] array to exchange
+    OMEGA::MeshElement ThisElem,      // [in] index space of the array
+    const std::string &Label,         // [in] name of the array type
+    OMEGA::I4 HaloWidth,              // [in] halo width of the decomposition
+    OMEGA::I4 VertSize,               // [in] size of the vertical dimension
+    OMEGA::I4 NHaloElems,             // [in] number of local halo elements
+    OMEGA::I4 NReps,                  // [in] number of exchanges to time
+    MPI_Comm Comm,                    // [in] communicator of the halo
+    std::vector<std::string> &Results // [inout] JSON records of each case
+) {
+
+   int Err = 0;
+
+   Err += MyHalo.exchangeFullArrayHalo(Array, ThisElem);
+
+   MPI_Barrier(Comm);
+   double StartTime = MPI_Wtime();
+   for (int IRep = 0; IRep < NReps; ++IRep) {
+      Err += MyHalo.exchangeFullArrayHalo(Array, ThisElem);
+   }
+   double LocalTime = (MPI_Wtime() - StartTime) / NReps;
+
+   // Bytes received per exchange: every value of the array at each halo
+   // element of the local task. The mesh element dimension is the second
+   // from the right, or the only dimension of 1D arrays.
+   OMEGA::I4 Rank     = Array.get_rank();
+   OMEGA::I4 ElemDim  = (Rank > 1) ? Rank - 2 : 0;
+   double ValsPerElem = Array.totElems() / Array.extent(ElemDim);
+   double RecvBytes   = NHaloElems * ValsPerElem * sizeof(typename T::type);
+
+   BenchStats TimeStats  = reduceStats(LocalTime, Comm);
+   BenchStats BytesStats = reduceStats(RecvBytes, Comm);
+
+   const char *ElemName = (ThisElem == OMEGA::OnCell)   ? "cell"
+                          : (ThisElem == OMEGA::OnEdge) ? "edge"
+                                                        : "vertex";
+
+   std::ostringstream Record;
+   Record << "{\"haloWidth\": " << HaloWidth << ", \"array\": \"" << Label
+          << "\", \"element\": \"" << ElemName
+          << "\", \"vertSize\": " << VertSize
+          << ", \"time\": " << statsToJson(TimeStats)
+          << ", \"recvBytes\": " << statsToJson(BytesStats) << "}";
+   Results.push_back(Record.str());
+
+   LOG_INFO("HaloBench: width {} {} {} vert {} mean {} s max {} s", HaloWidth,
+            Label, ElemName, VertSize, TimeStats.Mean, TimeStats.Max);
+
+   return Err;
+
+} // end benchExchange
+
+//------------------------------------------------------------------------------
+// The benchmark driver. Initializes the machine environment, IO and default
+// decomposition, then for each requested halo width creates and times a new
+// decomposition and times halo exchanges of a set of arrays on it.
+
+int main(int argc, char *argv[]) {
+
+   int Err = 0;
+
+   // Set default options and parse the command line
+   OMEGA::I4 NReps = 100;
+   std::vector<OMEGA::I4> VertSizes{16, 64};
+   std::vector<OMEGA::I4> HaloWidths{1, 2, 3};
+   std::string BackendName = "PointToPoint";
+   std::string OutFile     = "HaloBench.json";
+   bool UseTimers          = false;
+
+   for (int IArg = 1; IArg + 1 < argc; IArg += 2) {
+      std::string Opt = argv[IArg];
+      std::string Val = argv[IArg + 1];
+      if (Opt == "--reps") {
+         NReps = std::stoi(Val);
+      } else if (Opt == "--levels") {
+         VertSizes = parseList(Val);
+      } else if (Opt == "--widths") {
+         HaloWidths = parseList(Val);
+      } else if (Opt == "--backend") {
+         BackendName = Val;
+      } else if (Opt == "--output") {
+         OutFile = Val;
+      } else if (Opt == "--timers") {
+         UseTimers = (Val == "on");
+      }
+   }
+
+   OMEGA::HaloBackend Backend = OMEGA::PointToPoint;
+   if (BackendName == "NeighborCollective") {
+      Backend = OMEGA::NeighborCollective;
+   } else if (BackendName == "SharedMemory") {
+      Backend = OMEGA::SharedMemory;
+   } else {
+      BackendName = "PointToPoint";
+   }
+
+   // Initialize global MPI environment and YAKL
+   MPI_Init(&argc, &argv);
+   yakl::init();
+
+   // Initialize the machine environment, IO and the default decomposition
+   OMEGA::MachEnv::init(MPI_COMM_WORLD);
+   OMEGA::MachEnv *DefEnv = OMEGA::MachEnv::getDefaultEnv();
+   MPI_Comm DefComm       = DefEnv->getComm();
+   OMEGA::I4 NumTasks     = DefEnv->getNumTasks();
+
+   OMEGA::Timer::init(DefComm, UseTimers);
+
+   Err = OMEGA::IO::init(DefComm);
+   if (Err != 0)
+      LOG_ERROR("HaloBench: error initializing parallel IO");
+
+   Err = OMEGA::Decomp::init();
+   if (Err != 0)
+      LOG_ERROR("HaloBench: error initializing default decomposition");
+
+   // The timed regions in each reported phase of creating a decomposition
+   std::vector<std::string> ReadPhases{"Decomp:readMesh",
+                                       "Decomp:readCellLevels"};
+   std::vector<std::string> CellPhases{"Decomp:partCells",
+                                       "Decomp:reorderCells"};
+   std::vector<std::string> EVPhases{"Decomp:partEdges",
+                                     "Decomp:partVertices"};
+   std::vector<std::string> MovePhases{"Decomp:rearrangeCells",
+                                       "Decomp:rearrangeEdges",
+                                       "Decomp:rearrangeVertices"};
+
+   std::vector<std::string> DecompResults;
+   std::vector<std::string> HaloResults;
+   OMEGA::I4 NTracers = 4;
+
+   for (OMEGA::I4 HaloWidth : HaloWidths) {
+
+      // Time the creation of a decomposition with this halo width and
+      // collect the times of its phases from the Decomp timers, which
+      // accumulate over the halo widths
+      double ReadTime = partitionTime(ReadPhases);
+      double CellTime = partitionTime(CellPhases);
+      double EVTime   = partitionTime(EVPhases);
+      double MoveTime = partitionTime(MovePhases);
+      OMEGA::Timer::enable();
+
+      MPI_Barrier(DefComm);
+      double StartTime = MPI_Wtime();
+      OMEGA::Decomp BenchDecompTmp("Bench", DefEnv, NumTasks,
+                                   OMEGA::PartMethodMetisKWay, HaloWidth,
+                                   "OmegaMesh.nc");
+      double DecompTime          = MPI_Wtime() - StartTime;
+
+      if (!UseTimers)
+         OMEGA::Timer::disable();
+      ReadTime = partitionTime(ReadPhases) - ReadTime;
+      CellTime = partitionTime(CellPhases) - CellTime;
+      EVTime   = partitionTime(EVPhases) - EVTime;
+      MoveTime = partitionTime(MovePhases) - MoveTime;
+      OMEGA::Decomp *BenchDecomp = OMEGA::Decomp::get("Bench");
+      if (BenchDecomp == nullptr) {
+         LOG_ERROR("HaloBench: error creating decomposition FAIL");
+         Err = -1;
+         break;
+      }
+
+      StartTime = MPI_Wtime();
+      OMEGA::Halo BenchHalo(DefEnv, BenchDecomp, Backend);
+      double HaloTime = MPI_Wtime() - StartTime;
+
+      std::ostringstream Record;
+      Record << "{\"haloWidth\": " << HaloWidth
+             << ", \"total\": " << statsToJson(reduceStats(DecompTime, DefComm))
+             << ", \"readMesh\": "
+             << statsToJson(reduceStats(ReadTime, DefComm))
+             << ", \"partCells\": "
+             << statsToJson(reduceStats(CellTime, DefComm))
+             << ", \"partEdgesVertices\": "
+             << statsToJson(reduceStats(EVTime, DefComm))
+             << ", \"rearrange\": "
+             << statsToJson(reduceStats(MoveTime, DefComm))
+             << ", \"haloInit\": "
+             << statsToJson(reduceStats(HaloTime, DefComm)) << "}";
+      DecompResults.push_back(Record.str());
+
+      OMEGA::I4 NCellsSize = BenchDecomp->NCellsSize;
+      OMEGA::I4 NEdgesSize = BenchDecomp->NEdgesSize;
+      OMEGA::I4 NCellsHalo = BenchDecomp->NCellsAll - BenchDecomp->NCellsOwned;
+      OMEGA::I4 NEdgesHalo = BenchDecomp->NEdgesAll - BenchDecomp->NEdgesOwned;
+
+      // Time exchanges of a 1D cell array, then of arrays of each rank and
+      // type for each vertical size
+      OMEGA::Array1DR8 Cell1DR8("Cell1DR8", NCellsSize);
+      Err += benchExchange(BenchHalo, Cell1DR8, OMEGA::OnCell, "1DR8",
+                           HaloWidth, 1, NCellsHalo, NReps, DefComm,
+                           HaloResults);
+
+      for (OMEGA::I4 VertSize : VertSizes) {
+         OMEGA::Array2DI4 Cell2DI4("Cell2DI4", NCellsSize, VertSize);
+         OMEGA::Array2DR4 Cell2DR4("Cell2DR4", NCellsSize, VertSize);
+         OMEGA::Array2DR8 Cell2DR8("Cell2DR8", NCellsSize, VertSize);
+         OMEGA::Array2DR8 Edge2DR8("Edge2DR8", NEdgesSize, VertSize);
+         OMEGA::Array3DR8 Cell3DR8("Cell3DR8", NTracers, NCellsSize,
+                                   VertSize);
+
+         Err += benchExchange(BenchHalo, Cell2DI4, OMEGA::OnCell, "2DI4",
+                              HaloWidth, VertSize, NCellsHalo, NReps, DefComm,
+                              HaloResults);
+         Err += benchExchange(BenchHalo, Cell2DR4, OMEGA::OnCell, "2DR4",
+                              HaloWidth, VertSize, NCellsHalo, NReps, DefComm,
+                              HaloResults);
+         Err += benchExchange(BenchHalo, Cell2DR8, OMEGA::OnCell, "2DR8",
+                              HaloWidth, VertSize, NCellsHalo, NReps, DefComm,
+                              HaloResults);
+         Err += benchExchange(BenchHalo, Edge2DR8, OMEGA::OnEdge, "2DR8",
+                              HaloWidth, VertSize, NEdgesHalo, NReps, DefComm,
+                              HaloResults);
+         Err += benchExchange(BenchHalo, Cell3DR8, OMEGA::OnCell, "3DR8",
+                              HaloWidth, VertSize, NCellsHalo, NReps, DefComm,
+                              HaloResults);
+      }
+
+      OMEGA::Decomp::erase("Bench");
+   }
+
+   // Collect the summary of the Omega timers if requested
+   std::vector<std::string> TimerResults;
+   if (UseTimers) {
+      std::vector<OMEGA::TimerSummary> Summary;
+      Err += OMEGA::Timer::summarize(Summary);
+      for (const OMEGA::TimerSummary &Sum : Summary) {
+         std::ostringstream Record;
+         Record << std::setprecision(6) << std::scientific;
+         Record << "{\"path\": \"" << Sum.Path
+                << "\", \"tasks\": " << Sum.NumTasks
+                << ", \"calls\": " << Sum.Count << ", \"time\": {\"min\": "
+                << Sum.MinTime << ", \"max\": " << Sum.MaxTime
+                << ", \"mean\": " << Sum.MeanTime
+                << "}, \"imbalance\": " << Sum.Imbalance << "}";
+         TimerResults.push_back(Record.str());
+      }
+   }
+
+   // Write the results as JSON from the master task
+   if (DefEnv->isMasterTask()) {
+      std::ofstream Out(OutFile);
+      Out << "{\n  \"numTasks\": " << NumTasks << ",\n  \"reps\": " << NReps
+          << ",\n  \"backend\": \"" << BackendName
+          << "\",\n  \"decomp\": [\n";
+      for (size_t I = 0; I < DecompResults.size(); ++I) {
+         Out << "    " << DecompResults[I]
+             << (I + 1 < DecompResults.size() ? ",\n" : "\n");
+      }
+      Out << "  ],\n  \"halo\": [\n";
+      for (size_t I = 0; I < HaloResults.size(); ++I) {
+         Out << "    " << HaloResults[I]
+             << (I + 1 < HaloResults.size() ? ",\n" : "\n");
+      }
+      Out << "  ]";
+      if (UseTimers) {
+         Out << ",\n  \"timers\": [\n";
+         for (size_t I = 0; I < TimerResults.size(); ++I) {
+            Out << "    " << TimerResults[I]
+                << (I + 1 < TimerResults.size() ? ",\n" : "\n");
+         }
+         Out << "  ]";
+      }
+      Out << "\n}\n";
+      if (!Out.good()) {
+         LOG_ERROR("HaloBench: error writing {}", OutFile);
+         Err = -1;
+      }
+   }
+
+   // Log the timer summary and clean up memory
+   Err += OMEGA::Timer::finalize();
+   OMEGA::Decomp::clear();
+   OMEGA::MachEnv::removeAll();
+
+   if (Err == 0) {
+      LOG_INFO("HaloBench: Successful completion, results in {}", OutFile);
+   } else {
+      LOG_INFO("HaloBench: FAIL");
+   }
+   yakl::finalize();
+   MPI_Finalize();
+
+} // end of main
+//===-----------------------------------------------------------------------===/
@@ -10,6 +10,15 @@
 /// type and dimensionality supported in OMEGA, initializing each array based
 /// on global IDs of the mesh elememts, performing halo exchanges, and
 /// confirming the exchanged arrays are identical to the initial arrays.
+/// Each test is performed first on a device copy of the arrays and then on
+/// the host arrays themselves. The split-phase exchange (startExchange and
+/// finishExchange) is also tested for a subset of the array types, as is the
+/// exchange of only the first halo layer over part of the vertical range, and
+/// group and repeated exchanges are tested with each communication backend.
+/// Edge and vertex exchanges are also tested on decompositions with narrow
+/// halos, where some neighbors only send or only receive halo elements.
+/// If the driver is run with the --timing argument, exchanges with each
+/// backend are also timed to help select the faster backend for a machine.
 ///
 //
 //===-----------------------------------------------------------------------===/
@@ -22,6 +31,10 @@
 #include "MachEnv.h"
 #include "mpi.h"
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 //------------------------------------------------------------------------------
 // This function template performs a single test on a YAKL array type in a
 // given index space. Two YAKL arrays of the same type and size are input,
@@ -85,6 +98,548 @@ void haloExchangeTest(
 
 } // end haloExchangeTest
 
+//------------------------------------------------------------------------------
+// This function template performs the same test as haloExchangeTest above on
+// a device copy of the input host arrays. The halo exchange is performed on
+// the device copy of TestArray, which is then copied back to the host and
+// compared to InitArray. TestArray itself is left unchanged so that the host
+// test can be performed on it afterward.
+
+template <typename T>
+void haloDeviceExchangeTest(
+    OMEGA::Halo MyHalo,
+    T InitArray, /// Array initialized based on global IDs of mesh elements
+    T TestArray, /// Array only initialized in owned elements
+    const char *Label,                          /// Unique label for test
+    OMEGA::I4 &TotErr,                          /// Integer to track errors
+    OMEGA::MeshElement ThisElem = OMEGA::OnCell /// index space, cell by default
+) {
+
+   OMEGA::I4 IErr{0}; // error code
+
+   // Set total array size and ensure arrays are of same size
+   OMEGA::I4 NTot = InitArray.totElems();
+   if (NTot != TestArray.totElems()) {
+      LOG_ERROR("HaloTest: {} device arrays must be of same size", Label);
+      TotErr += -1;
+      return;
+   }
+
+   // Perform halo exchange on a device copy of the test array and copy
+   // the result back to the host
+   auto TestArrayDev = TestArray.createDeviceCopy();
+   IErr              = MyHalo.exchangeFullArrayHalo(TestArrayDev, ThisElem);
+   if (IErr != 0) {
+      LOG_ERROR("HaloTest: Error during {} device halo exchange", Label);
+      TotErr += -1;
+      return;
+   }
+   auto TestArrayH = TestArrayDev.createHostCopy();
+
+   // Collapse arrays to 1D for easy iteration
+   auto CollapsedInit = InitArray.collapse();
+   auto CollapsedTest = TestArrayH.collapse();
+
+   // Confirm all elements are identical, if not set error code
+   // and break out of loop
+   for (int N = 0; N < NTot; ++N) {
+      if (CollapsedInit(N) != CollapsedTest(N)) {
+         IErr = -1;
+         break;
+      }
+   }
+
+   if (IErr == 0) {
+      LOG_INFO("HaloTest: {} device exchange test PASS", Label);
+   } else {
+      LOG_INFO("HaloTest: {} device exchange test FAIL", Label);
+      TotErr += -1;
+   }
+
+   return;
+
+} // end haloDeviceExchangeTest
+
+//------------------------------------------------------------------------------
+// This function template tests the split-phase exchange on a copy of the input
+// host TestArray. The exchange is started, and while messages are in flight
+// the halo elements of the copy are compared to InitArray in place of the
+// computation that would normally overlap with the communication. A second
+// exchange may not be started on the same Halo until the first is finished,
+// which is also verified here. After finishExchange the copy is compared to
+// InitArray as in haloExchangeTest. TestArray itself is left unchanged.
+
+template <typename T>
+void haloSplitExchangeTest(
+    OMEGA::Halo MyHalo,
+    T InitArray, /// Array initialized based on global IDs of mesh elements
+    T TestArray, /// Array only initialized in owned elements
+    const char *Label,                          /// Unique label for test
+    OMEGA::I4 &TotErr,                          /// Integer to track errors
+    OMEGA::MeshElement ThisElem = OMEGA::OnCell /// index space, cell by default
+) {
+
+   OMEGA::I4 IErr{0}; // error code
+
+   // Set total array size and ensure arrays are of same size
+   OMEGA::I4 NTot = InitArray.totElems();
+   if (NTot != TestArray.totElems()) {
+      LOG_ERROR("HaloTest: {} split arrays must be of same size", Label);
+      TotErr += -1;
+      return;
+   }
+
+   auto SplitArray = TestArray.createHostCopy();
+
+   // Start the exchange, a second start before finishing must fail
+   OMEGA::Halo::ExchangeHandle Handle;
+   OMEGA::Halo::ExchangeHandle ExtraHandle;
+   IErr = MyHalo.startExchange(SplitArray, ThisElem, Handle);
+   if (IErr != 0) {
+      LOG_ERROR("HaloTest: Error starting {} split exchange", Label);
+      TotErr += -1;
+      return;
+   }
+   if (MyHalo.startExchange(SplitArray, ThisElem, ExtraHandle) == 0)
+      IErr = -1;
+
+   // Work on the array while messages are in flight, here the halo
+   // elements, which were set to junk values in TestArray, are counted along
+   // with those that already match InitArray
+   auto CollapsedInit  = InitArray.collapse();
+   auto CollapsedTest  = TestArray.collapse();
+   auto CollapsedSplit = SplitArray.collapse();
+   OMEGA::I4 NHalo{0};
+   OMEGA::I4 NMatch{0};
+   for (int N = 0; N < NTot; ++N) {
+      if (CollapsedInit(N) != CollapsedTest(N)) {
+         ++NHalo;
+         if (CollapsedInit(N) == CollapsedSplit(N))
+            ++NMatch;
+      }
+   }
+
+   // Finish the exchange and confirm all elements are now identical
+   if (MyHalo.finishExchange(Handle) != 0)
+      IErr = -1;
+
+   for (int N = 0; N < NTot; ++N) {
+      if (CollapsedInit(N) != CollapsedSplit(N)) {
+         IErr = -1;
+         break;
+      }
+   }
+   // The halo elements are only filled by finishExchange, so none of them
+   // can have matched before the exchange finished. On a task without halo
+   // elements (eg a single task run) there is nothing to check.
+   if (NHalo > 0 and NMatch == NHalo)
+      IErr = -1;
+
+   if (IErr == 0) {
+      LOG_INFO("HaloTest: {} split exchange test PASS", Label);
+   } else {
+      LOG_INFO("HaloTest: {} split exchange test FAIL", Label);
+      TotErr += -1;
+   }
+
+   return;
+
+} // end haloSplitExchangeTest
+
+//------------------------------------------------------------------------------
+// This function template returns the number of elements of the host array
+// Array that differ from the corresponding elements of InitArray
+
+template <typename T>
+OMEGA::I4 countDiffs(T InitArray, /// Array with expected values
+                     T Array      /// Array to compare
+) {
+
+   OMEGA::I4 NDiff{0};
+   auto CollapsedInit  = InitArray.collapse();
+   auto CollapsedArray = Array.collapse();
+   for (int N = 0; N < InitArray.totElems(); ++N) {
+      if (CollapsedInit(N) != CollapsedArray(N))
+         ++NDiff;
+   }
+
+   return NDiff;
+
+} // end countDiffs
+
+//------------------------------------------------------------------------------
+// This function template tests the exchange of a subset of the halo layers
+// and vertical range of a 2D array, first on the device and then on the
+// host. The halo elements of a copy of TestArray are set to junk values, and
+// after exchanging the first NLayers halo layers and the vertical indices
+// from VertBegin up to VertEnd, those elements must match InitArray while
+// the other halo elements must keep their junk values. Edges and vertices
+// have one more halo layer than cells. Requests for more halo layers than
+// available or a vertical range outside the array must fail.
+
+template <typename T>
+void haloPartialExchangeTest(
+    OMEGA::Halo MyHalo,
+    const OMEGA::Decomp *MyDecomp, /// Decomposition of the arrays
+    T InitArray,         /// Array initialized based on global IDs
+    T TestArray,         /// Array only initialized in owned elements
+    OMEGA::I4 NLayers,   /// Number of halo layers to exchange
+    OMEGA::I4 VertBegin, /// First vertical index to exchange
+    OMEGA::I4 VertEnd,   /// End of vertical range to exchange
+    const char *Label,   /// Unique label for test
+    OMEGA::I4 &TotErr,   /// Integer to track errors
+    OMEGA::MeshElement ThisElem = OMEGA::OnCell /// index space of arrays
+) {
+
+   OMEGA::I4 IErr{0}; // error code
+
+   // The last halo layer of edges and vertices extends to the end of the
+   // local elements
+   OMEGA::I4 NumAll;
+   OMEGA::I4 NumOwned;
+   OMEGA::ArrayHost1DI4 NHalo;
+   OMEGA::I4 MaxLayers = MyDecomp->HaloWidth + 1;
+   switch (ThisElem) {
+   case OMEGA::OnCell:
+      NumAll    = MyDecomp->NCellsAll;
+      NumOwned  = MyDecomp->NCellsOwned;
+      NHalo     = MyDecomp->NCellsHaloH;
+      MaxLayers = MyDecomp->HaloWidth;
+      break;
+   case OMEGA::OnEdge:
+      NumAll   = MyDecomp->NEdgesAll;
+      NumOwned = MyDecomp->NEdgesOwned;
+      NHalo    = MyDecomp->NEdgesHaloH;
+      break;
+   case OMEGA::OnVertex:
+      NumAll   = MyDecomp->NVerticesAll;
+      NumOwned = MyDecomp->NVerticesOwned;
+      NHalo    = MyDecomp->NVerticesHaloH;
+      break;
+   }
+   OMEGA::I4 NumExch = (NLayers < MaxLayers) ? NHalo(NLayers - 1) : NumAll;
+   OMEGA::I4 NVert   = InitArray.extent(1);
+
+   // Set all halo elements to junk values, then build the expected result
+   // with the initial values in the exchanged layers and vertical range
+   auto JunkArray = TestArray.createHostCopy();
+   for (int IElem = NumOwned; IElem < NumAll; ++IElem) {
+      for (int J = 0; J < NVert; ++J) {
+         JunkArray(IElem, J) = -1;
+      }
+   }
+   auto Expected = JunkArray.createHostCopy();
+   for (int IElem = NumOwned; IElem < NumExch; ++IElem) {
+      for (int J = VertBegin; J < VertEnd; ++J) {
+         Expected(IElem, J) = InitArray(IElem, J);
+      }
+   }
+
+   // Exchange on the device and then on the host
+   auto DevArray = JunkArray.createDeviceCopy();
+   IErr += MyHalo.exchangePartialArrayHalo(DevArray, ThisElem, NLayers,
+                                           VertBegin, VertEnd);
+   auto DevResult = DevArray.createHostCopy();
+
+   auto HostArray = JunkArray.createHostCopy();
+   IErr += MyHalo.exchangePartialArrayHalo(HostArray, ThisElem, NLayers,
+                                           VertBegin, VertEnd);
+
+   if (countDiffs(Expected, DevResult) != 0 or
+       countDiffs(Expected, HostArray) != 0)
+      IErr = -1;
+
+   // A full exchange afterward must restore the remaining halo elements
+   IErr += MyHalo.exchangeFullArrayHalo(HostArray, ThisElem);
+   if (countDiffs(InitArray, HostArray) != 0)
+      IErr = -1;
+
+   // Invalid layer counts and vertical ranges must be rejected
+   OMEGA::I4 TooMany = MaxLayers + 1;
+   if (MyHalo.exchangePartialArrayHalo(HostArray, ThisElem, TooMany) == 0 or
+       MyHalo.exchangePartialArrayHalo(HostArray, ThisElem, NLayers, 0,
+                                       NVert + 1) == 0)
+      IErr = -1;
+
+   if (IErr == 0) {
+      LOG_INFO("HaloTest: {} partial exchange test PASS", Label);
+   } else {
+      LOG_INFO("HaloTest: {} partial exchange test FAIL", Label);
+      TotErr += -1;
+   }
+
+   return;
+
+} // end haloPartialExchangeTest
+
+//------------------------------------------------------------------------------
+// This function template tests the exchange of a group of three arrays of
+// different types and index spaces with a single message per neighbor. Copies
+// of the input host test arrays are registered in an ExchangeGroup, first on
+// the host and then on the device, and after each group exchange all three
+// copies are compared to the corresponding initial arrays. A group mixing
+// host and device arrays must be rejected, which is also verified here.
+
+template <typename TA, typename TB, typename TC>
+void haloGroupExchangeTest(
+    OMEGA::Halo MyHalo,
+    TA InitA,                 /// First array set in all elements
+    TA TestA,                 /// First array only set in owned elements
+    OMEGA::MeshElement ElemA, /// index space of first array
+    TB InitB,                 /// Second array set in all elements
+    TB TestB,                 /// Second array only set in owned elements
+    OMEGA::MeshElement ElemB, /// index space of second array
+    TC InitC,                 /// Third array set in all elements
+    TC TestC,                 /// Third array only set in owned elements
+    OMEGA::MeshElement ElemC, /// index space of third array
+    const char *Label,        /// Unique label for test
+    OMEGA::I4 &TotErr         /// Integer to track errors
+) {
+
+   OMEGA::I4 IErr{0}; // error code
+
+   // Exchange host copies of the test arrays as one group
+   auto GroupA = TestA.createHostCopy();
+   auto GroupB = TestB.createHostCopy();
+   auto GroupC = TestC.createHostCopy();
+
+   OMEGA::Halo::ExchangeGroup HostGroup;
+   HostGroup.registerField(GroupA, ElemA);
+   HostGroup.registerField(GroupB, ElemB);
+   HostGroup.registerField(GroupC, ElemC);
+   if (HostGroup.getNumFields() != 3)
+      IErr = -1;
+
+   if (MyHalo.exchangeGroupHalo(HostGroup) != 0)
+      IErr = -1;
+
+   OMEGA::I4 NDiff = countDiffs(InitA, GroupA) + countDiffs(InitB, GroupB) +
+                     countDiffs(InitC, GroupC);
+   if (NDiff != 0)
+      IErr = -1;
+
+   // Exchange device copies of the test arrays as one group
+   auto DevA = TestA.createDeviceCopy();
+   auto DevB = TestB.createDeviceCopy();
+   auto DevC = TestC.createDeviceCopy();
+
+   OMEGA::Halo::ExchangeGroup DevGroup;
+   DevGroup.registerField(DevA, ElemA);
+   DevGroup.registerField(DevB, ElemB);
+   DevGroup.registerField(DevC, ElemC);
+
+   // A host array cannot be added to a group of device arrays
+   if (DevGroup.registerField(GroupA, ElemA) == 0)
+      IErr = -1;
+
+   if (MyHalo.exchangeGroupHalo(DevGroup) != 0)
+      IErr = -1;
+
+   NDiff = countDiffs(InitA, DevA.createHostCopy()) +
+           countDiffs(InitB, DevB.createHostCopy()) +
+           countDiffs(InitC, DevC.createHostCopy());
+   if (NDiff != 0)
+      IErr = -1;
+
+   if (IErr == 0) {
+      LOG_INFO("HaloTest: {} group exchange test PASS", Label);
+   } else {
+      LOG_INFO("HaloTest: {} group exchange test FAIL", Label);
+      TotErr += -1;
+   }
+
+   return;
+
+} // end haloGroupExchangeTest
+
+//------------------------------------------------------------------------------
+// This function template tests repeated exchanges of two arrays of different
+// types, which reuse the exchange plan created by the first exchange of each
+// array. In each of several iterations, fresh copies of both input test
+// arrays are exchanged in turn, first on the host and then on the device, and
+// compared to the corresponding initial arrays.
+
+template <typename TA, typename TB>
+void haloRepeatedExchangeTest(
+    OMEGA::Halo MyHalo,
+    TA InitA,          /// First array set in all elements
+    TA TestA,          /// First array only set in owned elements
+    TB InitB,          /// Second array set in all elements
+    TB TestB,          /// Second array only set in owned elements
+    const char *Label, /// Unique label for test
+    OMEGA::I4 &TotErr  /// Integer to track errors
+) {
+
+   OMEGA::I4 IErr{0};    // error code
+   OMEGA::I4 NRepeat{3}; // number of exchanges of each array
+
+   for (int IRepeat = 0; IRepeat < NRepeat; ++IRepeat) {
+      auto HostA = TestA.createHostCopy();
+      auto HostB = TestB.createHostCopy();
+      auto DevA  = TestA.createDeviceCopy();
+      auto DevB  = TestB.createDeviceCopy();
+
+      if (MyHalo.exchangeFullArrayHalo(HostA, OMEGA::OnCell) != 0 or
+          MyHalo.exchangeFullArrayHalo(HostB, OMEGA::OnCell) != 0 or
+          MyHalo.exchangeFullArrayHalo(DevA, OMEGA::OnCell) != 0 or
+          MyHalo.exchangeFullArrayHalo(DevB, OMEGA::OnCell) != 0)
+         IErr = -1;
+
+      OMEGA::I4 NDiff = countDiffs(InitA, HostA) + countDiffs(InitB, HostB) +
+                        countDiffs(InitA, DevA.createHostCopy()) +
+                        countDiffs(InitB, DevB.createHostCopy());
+      if (NDiff != 0)
+         IErr = -1;
+   }
+
+   if (IErr == 0) {
+      LOG_INFO("HaloTest: {} repeated exchange test PASS", Label);
+   } else {
+      LOG_INFO("HaloTest: {} repeated exchange test FAIL", Label);
+      TotErr += -1;
+   }
+
+   return;
+
+} // end haloRepeatedExchangeTest
+
+//------------------------------------------------------------------------------
+// This function tests the halo exchange of edge and vertex arrays on a new
+// decomposition with a narrow halo. The outer edge and vertex halo layers can
+// then be owned by tasks that own no halo cells of the local task, and a task
+// can need elements of another task that needs none of its elements, so
+// neighbors cannot be found from the cell halo alone. The number of such
+// elements and one-sided neighbors is written to the log, since it depends
+// on the partition and task count.
+
+void haloNeighborTest(OMEGA::MachEnv *DefEnv, /// Machine environment
+                      OMEGA::I4 HaloWidth,    /// Halo width of decomposition
+                      OMEGA::I4 &TotErr       /// Integer to track errors
+) {
+
+   OMEGA::I4 IErr{0}; // error code
+
+   OMEGA::Decomp NarrowDecompTmp("Narrow", DefEnv, DefEnv->getNumTasks(),
+                                 OMEGA::PartMethodMetisKWay, HaloWidth,
+                                 "OmegaMesh.nc");
+   OMEGA::Decomp *NarrowDecomp = OMEGA::Decomp::get("Narrow");
+   if (NarrowDecomp == nullptr) {
+      LOG_INFO("HaloTest: narrow halo decomposition FAIL");
+      TotErr += -1;
+      return;
+   }
+
+   // Count the halo edges and vertices owned by a task that owns none of the
+   // halo cells, and the tasks that need locally owned elements while
+   // owning none of the local halo elements
+   MPI_Comm Comm          = DefEnv->getComm();
+   OMEGA::I4 NumTasks     = DefEnv->getNumTasks();
+   OMEGA::I4 LocCounts[2] = {0, 0};
+   std::vector<OMEGA::I4> CellOwner(NumTasks, 0);
+   std::vector<OMEGA::I4> NeedFrom(NumTasks, 0);
+   std::vector<OMEGA::I4> NeededBy(NumTasks, 0);
+   for (int ICell = NarrowDecomp->NCellsOwned; ICell < NarrowDecomp->NCellsAll;
+        ++ICell) {
+      CellOwner[NarrowDecomp->CellLocH(ICell, 0)] = 1;
+      NeedFrom[NarrowDecomp->CellLocH(ICell, 0)]  = 1;
+   }
+   for (int IEdge = NarrowDecomp->NEdgesOwned; IEdge < NarrowDecomp->NEdgesAll;
+        ++IEdge) {
+      OMEGA::I4 Owner = NarrowDecomp->EdgeLocH(IEdge, 0);
+      LocCounts[0] += (CellOwner[Owner] == 0);
+      NeedFrom[Owner] = 1;
+   }
+   for (int IVertex = NarrowDecomp->NVerticesOwned;
+        IVertex < NarrowDecomp->NVerticesAll; ++IVertex) {
+      OMEGA::I4 Owner = NarrowDecomp->VertexLocH(IVertex, 0);
+      LocCounts[0] += (CellOwner[Owner] == 0);
+      NeedFrom[Owner] = 1;
+   }
+   MPI_Alltoall(NeedFrom.data(), 1, MPI_INT32_T, NeededBy.data(), 1,
+                MPI_INT32_T, Comm);
+   for (int ITask = 0; ITask < NumTasks; ++ITask)
+      LocCounts[1] += (NeededBy[ITask] != 0 and NeedFrom[ITask] == 0);
+
+   OMEGA::I4 Counts[2] = {0, 0};
+   MPI_Allreduce(LocCounts, Counts, 2, MPI_INT32_T, MPI_SUM, Comm);
+   LOG_INFO("HaloTest: halo width {} has {} halo edges and vertices owned "
+            "outside the cell halo and {} one-sided neighbors",
+            HaloWidth, Counts[0], Counts[1]);
+
+   OMEGA::Halo NarrowHalo(DefEnv, NarrowDecomp);
+
+   // Exchange edge and vertex arrays of global IDs
+   OMEGA::ArrayHost1DI4 InitEdge("InitEdge", NarrowDecomp->NEdgesSize);
+   OMEGA::ArrayHost1DI4 TestEdge("TestEdge", NarrowDecomp->NEdgesSize);
+   InitEdge = NarrowDecomp->EdgeIDH;
+   InitEdge.deep_copy_to(TestEdge);
+   for (int IEdge = NarrowDecomp->NEdgesOwned; IEdge < NarrowDecomp->NEdgesAll;
+        ++IEdge)
+      TestEdge(IEdge) = -1;
+
+   OMEGA::ArrayHost1DI4 InitVertex("InitVertex", NarrowDecomp->NVerticesSize);
+   OMEGA::ArrayHost1DI4 TestVertex("TestVertex", NarrowDecomp->NVerticesSize);
+   InitVertex = NarrowDecomp->VertexIDH;
+   InitVertex.deep_copy_to(TestVertex);
+   for (int IVertex = NarrowDecomp->NVerticesOwned;
+        IVertex < NarrowDecomp->NVerticesAll; ++IVertex)
+      TestVertex(IVertex) = -1;
+
+   std::string Label = "Width " + std::to_string(HaloWidth) + " 1DI4";
+   haloExchangeTest(NarrowHalo, InitEdge, TestEdge, (Label + " Edge").c_str(),
+                    TotErr, OMEGA::OnEdge);
+   haloExchangeTest(NarrowHalo, InitVertex, TestVertex,
+                    (Label + " Vertex").c_str(), TotErr, OMEGA::OnVertex);
+
+   OMEGA::Decomp::erase("Narrow");
+
+   return;
+
+} // end haloNeighborTest
+
+//------------------------------------------------------------------------------
+// This function template times repeated halo exchanges of a device copy of the
+// input TestArray with each communication backend, so the faster backend can
+// be chosen for a given machine. The average time per exchange, maximized
+// over all tasks, is written to the log for each backend. It is only run when
+// the test driver is called with the --timing argument.
+
+template <typename T>
+void haloTimingTest(
+    OMEGA::Halo P2PHalo,  /// Halo using the PointToPoint backend
+    OMEGA::Halo CollHalo, /// Halo using the NeighborCollective backend
+    T TestArray,          /// Array to exchange
+    const char *Label,    /// Unique label for test
+    OMEGA::I4 NIter,      /// Number of exchanges to time
+    MPI_Comm Comm         /// MPI communicator of the halos
+) {
+
+   auto DevArray = TestArray.createDeviceCopy();
+
+   OMEGA::Halo *Halos[2]    = {&P2PHalo, &CollHalo};
+   const char *BackNames[2] = {"PointToPoint", "NeighborCollective"};
+
+   for (int IBack = 0; IBack < 2; ++IBack) {
+      // Exchange once before timing so the exchange plan is created
+      Halos[IBack]->exchangeFullArrayHalo(DevArray, OMEGA::OnCell);
+
+      MPI_Barrier(Comm);
+      double StartTime = MPI_Wtime();
+      for (int IIter = 0; IIter < NIter; ++IIter) {
+         Halos[IBack]->exchangeFullArrayHalo(DevArray, OMEGA::OnCell);
+      }
+      double LocalTime = (MPI_Wtime() - StartTime) / NIter;
+
+      double MaxTime{0.0};
+      MPI_Allreduce(&LocalTime, &MaxTime, 1, MPI_DOUBLE, MPI_MAX, Comm);
+      LOG_INFO("HaloTest: {} {} backend time per exchange: {} s", Label,
+               BackNames[IBack], MaxTime);
+   }
+
+   return;
+
+} // end haloTimingTest
+
 //------------------------------------------------------------------------------
 // The test driver. Performs halo exchange tests of all index spaces and all
 // supported YAKL array types. For each test, an initial array is set based on
@@ -100,6 +655,13 @@ int main(int argc, char *argv[]) {
    OMEGA::I4 TotErr{0};
    OMEGA::I4 IErr{0};
 
+   // Exchanges with each backend are timed if requested
+   bool TimingMode = false;
+   for (int IArg = 1; IArg < argc; ++IArg) {
+      if (std::string(argv[IArg]) == "--timing")
+         TimingMode = true;
+   }
+
    // Initialize global MPI environment and YAKL
    MPI_Init(&argc, &argv);
    yakl::init();
@@ -124,8 +686,10 @@ int main(int argc, char *argv[]) {
    // Retrieve the default decomposition
    OMEGA::Decomp *DefDecomp = OMEGA::Decomp::getDefault();
 
-   // Create the halo exchange object for the given MachEnv and Decomp
+   // Create the halo exchange objects for the given MachEnv and Decomp, with
+   // the default PointToPoint backend and the NeighborCollective backend
    OMEGA::Halo MyHalo(DefEnv, DefDecomp);
+   OMEGA::Halo CollHalo(DefEnv, DefDecomp, OMEGA::NeighborCollective);
 
    OMEGA::I4 NumOwned;
    OMEGA::I4 NumAll;
@@ -143,6 +707,8 @@ int main(int argc, char *argv[]) {
       Test1DI4Cell(ICell) = -1;
    }
 
+   haloDeviceExchangeTest(MyHalo, Init1DI4Cell, Test1DI4Cell, "1DI4 Cell",
+                          TotErr);
    haloExchangeTest(MyHalo, Init1DI4Cell, Test1DI4Cell, "1DI4 Cell", TotErr);
 
    OMEGA::ArrayHost1DI4 Init1DI4Edge("Init1DI4Edge", DefDecomp->NEdgesSize);
@@ -156,6 +722,10 @@ int main(int argc, char *argv[]) {
       Test1DI4Edge(IEdge) = -1;
    }
 
+   haloDeviceExchangeTest(MyHalo, Init1DI4Edge, Test1DI4Edge, "1DI4 Edge",
+                          TotErr, OMEGA::OnEdge);
+   haloSplitExchangeTest(MyHalo, Init1DI4Edge, Test1DI4Edge, "1DI4 Edge",
+                         TotErr, OMEGA::OnEdge);
    haloExchangeTest(MyHalo, Init1DI4Edge, Test1DI4Edge, "1DI4 Edge", TotErr,
                     OMEGA::OnEdge);
 
@@ -171,6 +741,8 @@ int main(int argc, char *argv[]) {
    for (int IVertex = NumOwned; IVertex < NumAll; ++IVertex) {
       Test1DI4Vertex(IVertex) = -1;
    }
+   haloDeviceExchangeTest(MyHalo, Init1DI4Vertex, Test1DI4Vertex, "1DI4 Vertex",
+                          TotErr, OMEGA::OnVertex);
    haloExchangeTest(MyHalo, Init1DI4Vertex, Test1DI4Vertex, "1DI4 Vertex",
                     TotErr, OMEGA::OnVertex);
 
@@ -242,6 +814,9 @@ int main(int argc, char *argv[]) {
       Test1DR8(ICell) = -1;
    }
 
+   haloDeviceExchangeTest(MyHalo, Init1DI8, Test1DI8, "1DI8", TotErr);
+   haloDeviceExchangeTest(MyHalo, Init1DR4, Test1DR4, "1DR4", TotErr);
+   haloDeviceExchangeTest(MyHalo, Init1DR8, Test1DR8, "1DR8", TotErr);
    haloExchangeTest(MyHalo, Init1DI8, Test1DI8, "1DI8", TotErr);
    haloExchangeTest(MyHalo, Init1DR4, Test1DR4, "1DR4", TotErr);
    haloExchangeTest(MyHalo, Init1DR8, Test1DR8, "1DR8", TotErr);
@@ -270,6 +845,10 @@ int main(int argc, char *argv[]) {
       }
    }
 
+   haloDeviceExchangeTest(MyHalo, Init2DI4, Test2DI4, "2DI4", TotErr);
+   haloDeviceExchangeTest(MyHalo, Init2DI8, Test2DI8, "2DI8", TotErr);
+   haloDeviceExchangeTest(MyHalo, Init2DR4, Test2DR4, "2DR4", TotErr);
+   haloDeviceExchangeTest(MyHalo, Init2DR8, Test2DR8, "2DR8", TotErr);
    haloExchangeTest(MyHalo, Init2DI4, Test2DI4, "2DI4", TotErr);
    haloExchangeTest(MyHalo, Init2DI8, Test2DI8, "2DI8", TotErr);
    haloExchangeTest(MyHalo, Init2DR4, Test2DR4, "2DR4", TotErr);
@@ -303,6 +882,12 @@ int main(int argc, char *argv[]) {
       }
    }
 
+   haloDeviceExchangeTest(MyHalo, Init3DI4, Test3DI4, "3DI4", TotErr);
+   haloDeviceExchangeTest(MyHalo, Init3DI8, Test3DI8, "3DI8", TotErr);
+   haloDeviceExchangeTest(MyHalo, Init3DR4, Test3DR4, "3DR4", TotErr);
+   haloDeviceExchangeTest(MyHalo, Init3DR8, Test3DR8, "3DR8", TotErr);
+   haloSplitExchangeTest(MyHalo, Init3DI4, Test3DI4, "3DI4", TotErr);
+   haloSplitExchangeTest(MyHalo, Init3DR8, Test3DR8, "3DR8", TotErr);
    haloExchangeTest(MyHalo, Init3DI4, Test3DI4, "3DI4", TotErr);
    haloExchangeTest(MyHalo, Init3DI8, Test3DI8, "3DI8", TotErr);
    haloExchangeTest(MyHalo, Init3DR4, Test3DR4, "3DR4", TotErr);
@@ -341,6 +926,10 @@ int main(int argc, char *argv[]) {
       }
    }
 
+   haloDeviceExchangeTest(MyHalo, Init4DI4, Test4DI4, "4DI4", TotErr);
+   haloDeviceExchangeTest(MyHalo, Init4DI8, Test4DI8, "4DI8", TotErr);
+   haloDeviceExchangeTest(MyHalo, Init4DR4, Test4DR4, "4DR4", TotErr);
+   haloDeviceExchangeTest(MyHalo, Init4DR8, Test4DR8, "4DR8", TotErr);
    haloExchangeTest(MyHalo, Init4DI4, Test4DI4, "4DI4", TotErr);
    haloExchangeTest(MyHalo, Init4DI8, Test4DI8, "4DI8", TotErr);
    haloExchangeTest(MyHalo, Init4DR4, Test4DR4, "4DR4", TotErr);
@@ -383,11 +972,104 @@ int main(int argc, char *argv[]) {
       }
    }
 
+   haloDeviceExchangeTest(MyHalo, Init5DI4, Test5DI4, "5DI4", TotErr);
+   haloDeviceExchangeTest(MyHalo, Init5DI8, Test5DI8, "5DI8", TotErr);
+   haloDeviceExchangeTest(MyHalo, Init5DR4, Test5DR4, "5DR4", TotErr);
+   haloDeviceExchangeTest(MyHalo, Init5DR8, Test5DR8, "5DR8", TotErr);
    haloExchangeTest(MyHalo, Init5DI4, Test5DI4, "5DI4", TotErr);
    haloExchangeTest(MyHalo, Init5DI8, Test5DI8, "5DI8", TotErr);
    haloExchangeTest(MyHalo, Init5DR4, Test5DR4, "5DR4", TotErr);
    haloExchangeTest(MyHalo, Init5DR8, Test5DR8, "5DR8", TotErr);
 
+   // Exchange only the first halo layer, over part of the vertical range and
+   // then over the full vertical range
+   haloPartialExchangeTest(MyHalo, DefDecomp, Init2DR8, Test2DR8, 1, 5, 12,
+                           "2DR8 one layer", TotErr);
+   haloPartialExchangeTest(MyHalo, DefDecomp, Init2DI4, Test2DI4, 1, 0, N2,
+                           "2DI4 one layer", TotErr);
+
+   // Exchange edge and vertex arrays over the first halo layer and over all
+   // of their halo layers, which is one more than for cells
+   OMEGA::I4 EdgeLayers = DefDecomp->HaloWidth + 1;
+   OMEGA::ArrayHost2DI4 Init2DI4Edge("Init2DI4Edge", DefDecomp->NEdgesSize, N2);
+   OMEGA::ArrayHost2DI4 Test2DI4Edge("Test2DI4Edge", DefDecomp->NEdgesSize, N2);
+   for (int IEdge = 0; IEdge < DefDecomp->NEdgesAll; ++IEdge) {
+      for (int J = 0; J < N2; ++J) {
+         Init2DI4Edge(IEdge, J) = (J + 1) * DefDecomp->EdgeIDH(IEdge);
+      }
+   }
+   Init2DI4Edge.deep_copy_to(Test2DI4Edge);
+
+   OMEGA::ArrayHost2DI4 Init2DI4Vertex("Init2DI4Vertex",
+                                       DefDecomp->NVerticesSize, N2);
+   OMEGA::ArrayHost2DI4 Test2DI4Vertex("Test2DI4Vertex",
+                                       DefDecomp->NVerticesSize, N2);
+   for (int IVertex = 0; IVertex < DefDecomp->NVerticesAll; ++IVertex) {
+      for (int J = 0; J < N2; ++J) {
+         Init2DI4Vertex(IVertex, J) = (J + 1) * DefDecomp->VertexIDH(IVertex);
+      }
+   }
+   Init2DI4Vertex.deep_copy_to(Test2DI4Vertex);
+
+   haloPartialExchangeTest(MyHalo, DefDecomp, Init2DI4Edge, Test2DI4Edge, 1, 5,
+                           12, "2DI4 Edge one layer", TotErr, OMEGA::OnEdge);
+   haloPartialExchangeTest(MyHalo, DefDecomp, Init2DI4Edge, Test2DI4Edge,
+                           EdgeLayers, 0, N2, "2DI4 Edge all layers", TotErr,
+                           OMEGA::OnEdge);
+   haloPartialExchangeTest(MyHalo, DefDecomp, Init2DI4Vertex, Test2DI4Vertex, 1,
+                           5, 12, "2DI4 Vertex one layer", TotErr,
+                           OMEGA::OnVertex);
+   haloPartialExchangeTest(MyHalo, DefDecomp, Init2DI4Vertex, Test2DI4Vertex,
+                           EdgeLayers, 0, N2, "2DI4 Vertex all layers", TotErr,
+                           OMEGA::OnVertex);
+
+   // Exchange arrays of different types, ranks and index spaces as a group
+   haloGroupExchangeTest(MyHalo, Init1DI4Edge, Test1DI4Edge, OMEGA::OnEdge,
+                         Init3DR8, Test3DR8, OMEGA::OnCell, Init5DR4, Test5DR4,
+                         OMEGA::OnCell, "1DI4 Edge/3DR8/5DR4", TotErr);
+
+   // Repeat exchanges of the same arrays, reusing the exchange plans
+   haloRepeatedExchangeTest(MyHalo, Init2DI4, Test2DI4, Init4DR8, Test4DR8,
+                            "2DI4/4DR8", TotErr);
+
+   // Repeat the group and repeated exchange tests with the NeighborCollective
+   // backend
+   haloGroupExchangeTest(CollHalo, Init1DI4Edge, Test1DI4Edge, OMEGA::OnEdge,
+                         Init3DR8, Test3DR8, OMEGA::OnCell, Init5DR4, Test5DR4,
+                         OMEGA::OnCell, "Collective 1DI4 Edge/3DR8/5DR4",
+                         TotErr);
+   haloRepeatedExchangeTest(CollHalo, Init2DI4, Test2DI4, Init4DR8, Test4DR8,
+                            "Collective 2DI4/4DR8", TotErr);
+
+   // Repeat the group and repeated exchange tests with the SharedMemory
+   // backend, first with all tasks on one node (on a single machine) and
+   // then with nodes limited to two tasks so that neighbors are exchanged
+   // through both shared memory and MPI messages
+   OMEGA::Halo ShmHalo(DefEnv, DefDecomp, OMEGA::SharedMemory);
+   haloGroupExchangeTest(ShmHalo, Init1DI4Edge, Test1DI4Edge, OMEGA::OnEdge,
+                         Init3DR8, Test3DR8, OMEGA::OnCell, Init5DR4, Test5DR4,
+                         OMEGA::OnCell, "Shared 1DI4 Edge/3DR8/5DR4", TotErr);
+   haloRepeatedExchangeTest(ShmHalo, Init2DI4, Test2DI4, Init4DR8, Test4DR8,
+                            "Shared 2DI4/4DR8", TotErr);
+
+   DefEnv->setNodeSize(2);
+   OMEGA::Halo ShmNodeHalo(DefEnv, DefDecomp, OMEGA::SharedMemory);
+   haloGroupExchangeTest(ShmNodeHalo, Init1DI4Edge, Test1DI4Edge, OMEGA::OnEdge,
+                         Init3DR8, Test3DR8, OMEGA::OnCell, Init5DR4, Test5DR4,
+                         OMEGA::OnCell, "Node 1DI4 Edge/3DR8/5DR4", TotErr);
+   haloRepeatedExchangeTest(ShmNodeHalo, Init2DI4, Test2DI4, Init4DR8,
+                            Test4DR8, "Node 2DI4/4DR8", TotErr);
+   DefEnv->setNodeSize(0);
+
+   // Exchange edge and vertex arrays with narrow halos
+   haloNeighborTest(DefEnv, 1, TotErr);
+   haloNeighborTest(DefEnv, 2, TotErr);
+
+   if (TimingMode) {
+      haloTimingTest(MyHalo, CollHalo, Test3DR8, "3DR8", 100, DefComm);
+      haloTimingTest(MyHalo, CollHalo, Test5DR8, "5DR8", 100, DefComm);
+   }
+
    // Memory clean up
    OMEGA::Decomp::clear();
    OMEGA::MachEnv::removeAll();
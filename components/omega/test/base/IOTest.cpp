@@ -5,6 +5,9 @@
 ///
 /// This driver tests the OMEGA lower-level IO routines. It writes several
 /// distributed arrays and then reads the same file to verify the contents.
+/// It also tests asynchronous and compressed writes. If the driver is run
+/// with the --benchmark argument, a small benchmark that sweeps IO task
+/// layouts and rearrangers is also run.
 ///
 //
 //===-----------------------------------------------------------------------===/
@@ -16,7 +19,11 @@
 #include "MachEnv.h"
 #include "mpi.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <string>
+#include <vector>
 
 //------------------------------------------------------------------------------
 // The initialization routine for IO testing. It calls various
@@ -46,6 +53,300 @@ int initIOTest() {
    return Err;
 }
 
+//------------------------------------------------------------------------------
+// Tests asynchronous writes. Several time levels of a 2-d R8 array on cells
+// are written with writeArrayAsync, modifying the source array after each
+// call to verify that the data is snapshot on submission. After waitAll,
+// the file is re-read and compared against the expected values.
+
+int asyncWriteTest(OMEGA::Decomp *DefDecomp, MPI_Comm Comm) {
+
+   int Err = 0;
+
+   OMEGA::I4 NCellsSize   = DefDecomp->NCellsSize;
+   OMEGA::I4 NCellsOwned  = DefDecomp->NCellsOwned;
+   OMEGA::I4 NCellsGlobal = DefDecomp->NCellsGlobal;
+   OMEGA::I4 NVertLevels  = 16;
+   OMEGA::I4 NTimes       = 4;
+   int ArraySize          = NCellsSize * NVertLevels;
+
+   std::vector<int> Offset(ArraySize, -1);
+   for (int Cell = 0; Cell < NCellsOwned; ++Cell) {
+      int GlobalCellAdd = DefDecomp->CellIDH(Cell) - 1;
+      for (int k = 0; k < NVertLevels; ++k) {
+         Offset[Cell * NVertLevels + k] = GlobalCellAdd * NVertLevels + k;
+      }
+   }
+   std::vector<int> Dims{NCellsGlobal, NVertLevels};
+
+   int DecompID;
+   Err += OMEGA::IO::createDecomp(DecompID, OMEGA::IO::IOTypeR8, 2, Dims,
+                                  ArraySize, Offset, OMEGA::IO::RearrDefault);
+
+   // Define one variable for each time level
+   int FileID;
+   int DimIDs[2];
+   std::vector<int> VarIDs(NTimes);
+   OMEGA::R8 FillR8 = -1.23456789e30;
+   Err += OMEGA::IO::openFile(FileID, "IOTestAsync.nc", OMEGA::IO::ModeWrite,
+                              OMEGA::IO::FmtDefault,
+                              OMEGA::IO::IfExists::Replace);
+   Err += OMEGA::IO::defineDim(FileID, "NCells", NCellsGlobal, DimIDs[0]);
+   Err += OMEGA::IO::defineDim(FileID, "NVertLevels", NVertLevels, DimIDs[1]);
+   for (int Time = 0; Time < NTimes; ++Time) {
+      std::string VarName = "AsyncR8_" + std::to_string(Time);
+      Err += OMEGA::IO::defineVar(FileID, VarName, OMEGA::IO::IOTypeR8, 2,
+                                  DimIDs, VarIDs[Time]);
+   }
+   Err += OMEGA::IO::endDefinePhase(FileID);
+
+   // Write each time level from the same source array, which is updated
+   // immediately after each submission
+   std::vector<OMEGA::R8> Data(ArraySize, 0.0);
+   for (int Time = 0; Time < NTimes; ++Time) {
+      for (int Add = 0; Add < ArraySize; ++Add)
+         Data[Add] = Offset[Add] + 1000.0 * Time;
+      Err += OMEGA::IO::writeArrayAsync(Data.data(), ArraySize, &FillR8,
+                                        FileID, DecompID, VarIDs[Time]);
+      std::fill(Data.begin(), Data.end(), FillR8);
+   }
+   Err += OMEGA::IO::waitAll();
+   Err += OMEGA::IO::closeFile(FileID);
+
+   // Read each time level and compare the owned values
+   int NDiffs = 0;
+   Err += OMEGA::IO::openFile(FileID, "IOTestAsync.nc", OMEGA::IO::ModeRead);
+   for (int Time = 0; Time < NTimes; ++Time) {
+      std::string VarName = "AsyncR8_" + std::to_string(Time);
+      std::vector<OMEGA::R8> NewData(ArraySize, 0.0);
+      int VarID;
+      Err += OMEGA::IO::readArray(NewData.data(), ArraySize, VarName, FileID,
+                                  DecompID, VarID);
+      for (int Add = 0; Add < NCellsOwned * NVertLevels; ++Add) {
+         if (NewData[Add] != Offset[Add] + 1000.0 * Time)
+            ++NDiffs;
+      }
+   }
+   Err += OMEGA::IO::closeFile(FileID);
+   Err += OMEGA::IO::destroyDecomp(DecompID);
+
+   MPI_Allreduce(MPI_IN_PLACE, &NDiffs, 1, MPI_INT, MPI_SUM, Comm);
+   if (Err == 0 && NDiffs == 0) {
+      LOG_INFO("IOTest: asynchronous write test PASS");
+   } else {
+      LOG_INFO("IOTest: asynchronous write test FAIL");
+      Err = -1;
+   }
+
+   return Err;
+}
+
+//------------------------------------------------------------------------------
+// Tests compressed output. A 2-d R8 array on cells is written with deflate,
+// shuffle and quantization to three significant digits, then re-read and
+// checked against the original values using a relative tolerance.
+
+int compressionTest(OMEGA::Decomp *DefDecomp, MPI_Comm Comm) {
+
+   int Err = 0;
+
+   OMEGA::I4 NCellsSize   = DefDecomp->NCellsSize;
+   OMEGA::I4 NCellsOwned  = DefDecomp->NCellsOwned;
+   OMEGA::I4 NCellsGlobal = DefDecomp->NCellsGlobal;
+   OMEGA::I4 NVertLevels  = 16;
+   int ArraySize          = NCellsSize * NVertLevels;
+
+   std::vector<int> Offset(ArraySize, -1);
+   std::vector<OMEGA::R8> RefData(ArraySize, 0.0);
+   for (int Cell = 0; Cell < NCellsOwned; ++Cell) {
+      int GlobalCellAdd = DefDecomp->CellIDH(Cell) - 1;
+      for (int k = 0; k < NVertLevels; ++k) {
+         int VectorAdd      = Cell * NVertLevels + k;
+         Offset[VectorAdd]  = GlobalCellAdd * NVertLevels + k;
+         RefData[VectorAdd] = 20.0 + std::sin(GlobalCellAdd * 0.001) / (k + 1);
+      }
+   }
+   std::vector<int> Dims{NCellsGlobal, NVertLevels};
+
+   int DecompID;
+   Err += OMEGA::IO::createDecomp(DecompID, OMEGA::IO::IOTypeR8, 2, Dims,
+                                  ArraySize, Offset, OMEGA::IO::RearrDefault);
+
+   OMEGA::IO::Compression Compress;
+   Compress.DeflateLevel = 4;
+   Compress.Shuffle      = true;
+   Compress.SigDigits    = 3;
+   Compress.ChunkSizes   = {std::min(NCellsGlobal, 1024), NVertLevels};
+
+   int FileID;
+   int DimIDs[2];
+   int VarID;
+   OMEGA::R8 FillR8 = -1.23456789e30;
+   Err += OMEGA::IO::openFile(FileID, "IOTestCompress.nc", OMEGA::IO::ModeWrite,
+                              OMEGA::IO::FmtNetCDF4c,
+                              OMEGA::IO::IfExists::Replace);
+   Err += OMEGA::IO::defineDim(FileID, "NCells", NCellsGlobal, DimIDs[0]);
+   Err += OMEGA::IO::defineDim(FileID, "NVertLevels", NVertLevels, DimIDs[1]);
+   Err += OMEGA::IO::defineVar(FileID, "CompressR8", OMEGA::IO::IOTypeR8, 2,
+                               DimIDs, VarID, Compress);
+   Err += OMEGA::IO::endDefinePhase(FileID);
+   Err += OMEGA::IO::writeArray(RefData.data(), ArraySize, &FillR8, FileID,
+                                DecompID, VarID);
+   Err += OMEGA::IO::closeFile(FileID);
+
+   // Re-read and check that values agree to the requested digits
+   std::vector<OMEGA::R8> NewData(ArraySize, 0.0);
+   Err += OMEGA::IO::openFile(FileID, "IOTestCompress.nc", OMEGA::IO::ModeRead);
+   Err += OMEGA::IO::readArray(NewData.data(), ArraySize, "CompressR8", FileID,
+                               DecompID, VarID);
+   Err += OMEGA::IO::closeFile(FileID);
+   Err += OMEGA::IO::destroyDecomp(DecompID);
+
+   int NDiffs = 0;
+   for (int Add = 0; Add < NCellsOwned * NVertLevels; ++Add) {
+      if (std::abs(NewData[Add] - RefData[Add]) > 1.0e-3 * RefData[Add])
+         ++NDiffs;
+   }
+   MPI_Allreduce(MPI_IN_PLACE, &NDiffs, 1, MPI_INT, MPI_SUM, Comm);
+   if (Err == 0 && NDiffs == 0) {
+      LOG_INFO("IOTest: compressed write test PASS");
+   } else {
+      LOG_INFO("IOTest: compressed write test FAIL");
+      Err = -1;
+   }
+
+   return Err;
+}
+
+//------------------------------------------------------------------------------
+// Benchmark that sweeps IO task layouts and rearrangers. For each setting,
+// the IO system is re-initialized and a 2-d R8 array on cells is written
+// and read back. The maximum write and read times across tasks are logged
+// and the data read is checked against the data written.
+
+int ioBenchmark(OMEGA::Decomp *DefDecomp, MPI_Comm Comm) {
+
+   int Err = 0;
+
+   OMEGA::I4 NumTasks;
+   MPI_Comm_size(Comm, &NumTasks);
+
+   OMEGA::I4 NCellsSize   = DefDecomp->NCellsSize;
+   OMEGA::I4 NCellsOwned  = DefDecomp->NCellsOwned;
+   OMEGA::I4 NCellsGlobal = DefDecomp->NCellsGlobal;
+   OMEGA::I4 NVertLevels  = 64;
+   int ArraySize          = NCellsSize * NVertLevels;
+
+   std::vector<int> Offset(ArraySize, -1);
+   std::vector<OMEGA::R8> RefData(ArraySize, 0.0);
+   for (int Cell = 0; Cell < NCellsOwned; ++Cell) {
+      int GlobalCellAdd = DefDecomp->CellIDH(Cell) - 1;
+      for (int k = 0; k < NVertLevels; ++k) {
+         int VectorAdd      = Cell * NVertLevels + k;
+         Offset[VectorAdd]  = GlobalCellAdd * NVertLevels + k;
+         RefData[VectorAdd] = GlobalCellAdd * k * 1.23456789;
+      }
+   }
+   std::vector<int> Dims{NCellsGlobal, NVertLevels};
+
+   // Settings to sweep: number of IO tasks, stride and rearranger. A zero
+   // number of IO tasks selects the automatic layout.
+   struct IOSetting {
+      int NumIOTasks;
+      int IOStride;
+      OMEGA::IO::Rearranger Rearr;
+   };
+   std::vector<IOSetting> Settings{
+       {0, 0, OMEGA::IO::RearrBox},
+       {0, 0, OMEGA::IO::RearrSubset},
+       {1, 1, OMEGA::IO::RearrBox},
+       {std::max(1, NumTasks / 2), 2, OMEGA::IO::RearrBox},
+       {std::max(1, NumTasks / 2), 2, OMEGA::IO::RearrSubset},
+       {NumTasks, 1, OMEGA::IO::RearrBox},
+       {NumTasks, 1, OMEGA::IO::RearrSubset}};
+
+   for (const IOSetting &Setting : Settings) {
+
+      int LocErr = 0;
+      LocErr += OMEGA::IO::finalize();
+      LocErr += OMEGA::IO::init(Comm, Setting.NumIOTasks, Setting.IOStride, 0,
+                                Setting.Rearr, OMEGA::IO::FmtDefault);
+
+      int DecompID;
+      LocErr += OMEGA::IO::createDecomp(DecompID, OMEGA::IO::IOTypeR8, 2, Dims,
+                                        ArraySize, Offset, Setting.Rearr);
+
+      // Time the write of the array, including the file open and close
+      MPI_Barrier(Comm);
+      double StartTime = MPI_Wtime();
+
+      int FileID;
+      int DimIDs[2];
+      int VarID;
+      OMEGA::R8 FillR8 = -1.23456789e30;
+      LocErr += OMEGA::IO::openFile(
+          FileID, "IOBenchmark.nc", OMEGA::IO::ModeWrite, OMEGA::IO::FmtDefault,
+          OMEGA::IO::IfExists::Replace, OMEGA::IO::Precision::Double);
+      LocErr += OMEGA::IO::defineDim(FileID, "NCells", NCellsGlobal, DimIDs[0]);
+      LocErr +=
+          OMEGA::IO::defineDim(FileID, "NVertLevels", NVertLevels, DimIDs[1]);
+      LocErr += OMEGA::IO::defineVar(FileID, "BenchR8", OMEGA::IO::IOTypeR8, 2,
+                                     DimIDs, VarID);
+      LocErr += OMEGA::IO::endDefinePhase(FileID);
+      LocErr += OMEGA::IO::writeArray(RefData.data(), ArraySize, &FillR8,
+                                      FileID, DecompID, VarID);
+      LocErr += OMEGA::IO::closeFile(FileID);
+
+      double WriteTime = MPI_Wtime() - StartTime;
+
+      // Time the read of the same array
+      MPI_Barrier(Comm);
+      StartTime = MPI_Wtime();
+
+      std::vector<OMEGA::R8> NewData(ArraySize, 0.0);
+      LocErr += OMEGA::IO::openFile(FileID, "IOBenchmark.nc",
+                                    OMEGA::IO::ModeRead);
+      LocErr += OMEGA::IO::readArray(NewData.data(), ArraySize, "BenchR8",
+                                     FileID, DecompID, VarID);
+      LocErr += OMEGA::IO::closeFile(FileID);
+
+      double ReadTime = MPI_Wtime() - StartTime;
+
+      LocErr += OMEGA::IO::destroyDecomp(DecompID);
+
+      // Check the owned data
+      int NDiffs = 0;
+      for (int Add = 0; Add < NCellsOwned * NVertLevels; ++Add) {
+         if (NewData[Add] != RefData[Add])
+            ++NDiffs;
+      }
+      MPI_Allreduce(MPI_IN_PLACE, &NDiffs, 1, MPI_INT, MPI_SUM, Comm);
+      MPI_Allreduce(MPI_IN_PLACE, &WriteTime, 1, MPI_DOUBLE, MPI_MAX, Comm);
+      MPI_Allreduce(MPI_IN_PLACE, &ReadTime, 1, MPI_DOUBLE, MPI_MAX, Comm);
+
+      std::string RearrName =
+          (Setting.Rearr == OMEGA::IO::RearrBox) ? "box" : "subset";
+      LOG_INFO("IOTest benchmark: IOTasks {} IOStride {} Rearranger {} "
+               "write {:.6f}s read {:.6f}s",
+               Setting.NumIOTasks, Setting.IOStride, RearrName, WriteTime,
+               ReadTime);
+      if (LocErr == 0 && NDiffs == 0) {
+         LOG_INFO("IOTest: benchmark IOTasks {} IOStride {} {} PASS",
+                  Setting.NumIOTasks, Setting.IOStride, RearrName);
+      } else {
+         LOG_INFO("IOTest: benchmark IOTasks {} IOStride {} {} FAIL",
+                  Setting.NumIOTasks, Setting.IOStride, RearrName);
+         Err = -1;
+      }
+   }
+
+   // Restore the default IO configuration
+   Err += OMEGA::IO::finalize();
+   Err += OMEGA::IO::init(Comm);
+
+   return Err;
+}
+
 //------------------------------------------------------------------------------
 // The test driver for IO. This creates several distributed arrays and
 // associated metadata, writes that data to a file, then re-reads the data
@@ -53,8 +354,17 @@ int initIOTest() {
 //
 int main(int argc, char *argv[]) {
 
-   // Initialize the global MPI environment
-   MPI_Init(&argc, &argv);
+   // The IO layout benchmark is only run if requested
+   bool BenchmarkMode = false;
+   for (int IArg = 1; IArg < argc; ++IArg) {
+      if (std::string(argv[IArg]) == "--benchmark")
+         BenchmarkMode = true;
+   }
+
+   // Initialize the global MPI environment. Full thread support is
+   // requested so that asynchronous writes can use a separate IO thread.
+   int ThreadLevel;
+   MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &ThreadLevel);
    yakl::init();
 
    // Call initialization routine to create the default decomposition
@@ -235,6 +545,39 @@ int main(int argc, char *argv[]) {
    if (Err != 0)
       LOG_ERROR("IOTest: error creating vertex decomp R8 FAIL");
 
+   // Creating an identical decomposition should reuse the existing one
+   // and destroying it should only remove the extra reference
+   int DecompCellR8Dup;
+   Err = OMEGA::IO::createDecomp(DecompCellR8Dup, OMEGA::IO::IOTypeR8, 2,
+                                 CellDims, CellArraySize, OffsetCell,
+                                 OMEGA::IO::DefaultRearr);
+   if (Err == 0 && DecompCellR8Dup == DecompCellR8) {
+      LOG_INFO("IOTest: reuse of identical decomposition PASS");
+   } else {
+      LOG_INFO("IOTest: reuse of identical decomposition FAIL");
+   }
+   Err = OMEGA::IO::destroyDecomp(DecompCellR8Dup);
+   if (Err != 0)
+      LOG_ERROR("IOTest: error destroying shared decomp FAIL");
+
+   // A decomposition with the same sizes but a different index order on
+   // only one task must not reuse the existing one
+   std::vector<int> OffsetSwap(OffsetCell);
+   if (MyTask == 0 && CellArraySize > 1)
+      std::swap(OffsetSwap[0], OffsetSwap[CellArraySize - 1]);
+   int DecompCellR8Swap;
+   Err = OMEGA::IO::createDecomp(DecompCellR8Swap, OMEGA::IO::IOTypeR8, 2,
+                                 CellDims, CellArraySize, OffsetSwap,
+                                 OMEGA::IO::DefaultRearr);
+   if (Err == 0 && DecompCellR8Swap != DecompCellR8) {
+      LOG_INFO("IOTest: distinct decomposition with reordered indices PASS");
+   } else {
+      LOG_INFO("IOTest: distinct decomposition with reordered indices FAIL");
+   }
+   Err = OMEGA::IO::destroyDecomp(DecompCellR8Swap);
+   if (Err != 0)
+      LOG_ERROR("IOTest: error destroying reordered decomp FAIL");
+
    // Open a file for output
    int OutFileID;
    Err = OMEGA::IO::openFile(
@@ -822,6 +1165,23 @@ int main(int argc, char *argv[]) {
    if (Err != 0)
       LOG_ERROR("IOTest: error destroying decomp Vrtx R8 FAIL");
 
+   // Test asynchronous writes
+   Err = asyncWriteTest(DefDecomp, Comm);
+   if (Err != 0)
+      LOG_ERROR("IOTest: error in asynchronous write test FAIL");
+
+   // Test compressed output
+   Err = compressionTest(DefDecomp, Comm);
+   if (Err != 0)
+      LOG_ERROR("IOTest: error in compressed write test FAIL");
+
+   // Sweep IO layouts and rearrangers if requested
+   if (BenchmarkMode) {
+      Err = ioBenchmark(DefDecomp, Comm);
+      if (Err != 0)
+         LOG_ERROR("IOTest: error in IO benchmark FAIL");
+   }
+
    // Exit environments
    OMEGA::Decomp::clear();
    OMEGA::MachEnv::removeAll();
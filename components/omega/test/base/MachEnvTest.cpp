@@ -436,6 +436,48 @@ int main(int argc, char *argv[]) {
 
    } // end if member of general subset env
 
+   //---------------------------------------------------------------------------
+   // Test the node layout of the default environment. Every task must be
+   // counted on exactly one node and tasks sharing a node communicator must
+   // report the same node. The node size is then limited to two tasks to
+   // test the splitting of nodes and finally restored.
+
+   for (int MaxNodeTasks : {0, 2, 0}) {
+
+      if (DefEnv->setNodeSize(MaxNodeTasks) != 0)
+         std::cout << "DefaultEnv set node size test: FAIL" << std::endl;
+
+      int NumNodes      = DefEnv->getNumNodes();
+      int NumNodeTasks  = DefEnv->getNumNodeTasks();
+      int MyNode        = DefEnv->getMyNode();
+      int DefTask       = DefEnv->getMyTask();
+      MPI_Comm NodeComm = DefEnv->getNodeComm();
+
+      // Sum the tasks on each node from the first task on each node
+      int NodeCount = (DefEnv->getMyNodeTask() == 0) ? NumNodeTasks : 0;
+      int TaskCount = 0;
+      MPI_Allreduce(&NodeCount, &TaskCount, 1, MPI_INT, MPI_SUM,
+                    MPI_COMM_WORLD);
+
+      // All tasks in the node communicator must be on the same node
+      int MinNode, MaxNode;
+      MPI_Allreduce(&MyNode, &MinNode, 1, MPI_INT, MPI_MIN, NodeComm);
+      MPI_Allreduce(&MyNode, &MaxNode, 1, MPI_INT, MPI_MAX, NodeComm);
+
+      bool NodeSizeOK = MaxNodeTasks == 0 || NumNodeTasks <= MaxNodeTasks;
+
+      if (TaskCount == WorldSize && MinNode == MaxNode && NodeSizeOK &&
+          MyNode >= 0 && MyNode < NumNodes &&
+          DefEnv->getTaskNode(DefTask) == MyNode &&
+          DefEnv->getTaskNode(WorldSize) == -1)
+         std::cout << "DefaultEnv node layout test: PASS" << std::endl;
+      else {
+         std::cout << "DefaultEnv node layout test: FAIL "
+                   << "TaskCount, NumNodes, MyNode = " << TaskCount << " "
+                   << NumNodes << " " << MyNode << std::endl;
+      }
+   }
+
    //---------------------------------------------------------------------------
    // Test setting of compile-time vector length
 
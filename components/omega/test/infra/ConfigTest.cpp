@@ -614,6 +614,86 @@ int main(int argc, char *argv[]) {
       LOG_INFO("ConfigTest {}: retrieve string from full config FAIL", MyTask);
    }
 
+   // After readAll, every task holds a full copy of the configuration, so
+   // retrievals are local and can be made by a single task without
+   // deadlocking the others.
+   OMEGA::I4 LastTask = DefEnv->getNumTasks() - 1;
+   Err                = 0;
+   if (ConfigOmega == nullptr)
+      Err = -1;
+   if (MyTask == LastTask && Err == 0) {
+      OMEGA::Config ConfigHmixLocal("Hmix");
+      Err1 = ConfigOmega->get(ConfigHmixLocal);
+      Err2 = ConfigHmixLocal.get("HmixR8", HmixR8);
+      if (Err1 != 0 || Err2 != 0 || HmixR8 != NewHmixR8)
+         Err = -1;
+   }
+   OMEGA::Broadcast(Err, LastTask);
+   if (Err == 0) {
+      LOG_INFO("ConfigTest {}: local retrieval on single task PASS", MyTask);
+   } else {
+      LOG_INFO("ConfigTest {}: local retrieval on single task FAIL", MyTask);
+   }
+
+   // Test typed parameter handles that resolve a variable once and
+   // cache its value
+   OMEGA::ConfigParam<OMEGA::I4> HmixI4Param(ConfigHmixOmega, "HmixI4");
+   OMEGA::ConfigParam<OMEGA::R8> HmixR8Param(ConfigHmixOmega, "HmixR8");
+   OMEGA::ConfigParam<bool> HmixOnParam(ConfigHmixOmega, "HmixOn");
+   OMEGA::ConfigParam<std::string> HmixStrParam(ConfigHmixOmega, "HmixStr");
+   OMEGA::ConfigParam<OMEGA::R8> JunkParam(ConfigHmixOmega, "junk");
+
+   RefTest = HmixI4Param.isValid() && HmixR8Param.isValid() &&
+             HmixOnParam.isValid() && HmixStrParam.isValid() &&
+             !JunkParam.isValid() && HmixI4Param.get() == NewHmixI4 &&
+             HmixR8Param.get() == NewHmixR8 && HmixOnParam == NewHmixOn &&
+             HmixStrParam.get() == NewHmixStr;
+   if (RefTest) {
+      LOG_INFO("ConfigTest {}: parameter handle retrieval PASS", MyTask);
+   } else {
+      LOG_INFO("ConfigTest {}: parameter handle retrieval FAIL", MyTask);
+   }
+
+   Err1    = HmixI4Param.checkRange(NewHmixI4 - 1, NewHmixI4 + 1);
+   Err2    = HmixI4Param.checkRange(NewHmixI4 + 1, NewHmixI4 + 2);
+   Err3    = JunkParam.checkRange(0.0, 1.0);
+   RefTest = (Err1 == 0 && Err2 != 0 && Err3 != 0);
+   if (RefTest) {
+      LOG_INFO("ConfigTest {}: parameter handle range check PASS", MyTask);
+   } else {
+      LOG_INFO("ConfigTest {}: parameter handle range check FAIL", MyTask);
+   }
+
+   // The cached value only changes on refresh after a set
+   Err1        = ConfigHmixOmega.set("HmixR8", 2.0 * NewHmixR8);
+   bool Cached = (HmixR8Param.get() == NewHmixR8);
+   Err2        = HmixR8Param.refresh();
+   RefTest     = (Err1 == 0 && Err2 == 0 && Cached &&
+                  HmixR8Param.get() == 2.0 * NewHmixR8);
+
+   // Restore the original value
+   Err1 = ConfigHmixOmega.set("HmixR8", NewHmixR8);
+   Err2 = HmixR8Param.refresh();
+   if (RefTest && Err1 == 0 && Err2 == 0) {
+      LOG_INFO("ConfigTest {}: parameter handle refresh PASS", MyTask);
+   } else {
+      LOG_INFO("ConfigTest {}: parameter handle refresh FAIL", MyTask);
+   }
+
+   // Copy handle values into a flat struct as a kernel would capture
+   struct HmixParams {
+      OMEGA::I4 HmixI4;
+      OMEGA::R8 HmixR8;
+      bool HmixOn;
+   };
+   HmixParams Params{HmixI4Param, HmixR8Param, HmixOnParam};
+   if (Params.HmixI4 == NewHmixI4 && Params.HmixR8 == NewHmixR8 &&
+       Params.HmixOn == NewHmixOn) {
+      LOG_INFO("ConfigTest {}: parameter snapshot struct PASS", MyTask);
+   } else {
+      LOG_INFO("ConfigTest {}: parameter snapshot struct FAIL", MyTask);
+   }
+
    // Test removals by removing both variables and sub-configs and
    // checking the further retrievals fail
 
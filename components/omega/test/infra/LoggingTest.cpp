@@ -5,15 +5,18 @@
 ///
 /// This driver tests the logging capabilities for the OMEGA
 /// model. In particular, it tests creating a log file according to
-/// log levels and supporting YAKL data types.
+/// log levels and supporting YAKL data types, as well as the asynchronous
+/// and aggregated logging modes.
 ///
 //
 //===-----------------------------------------------------------------------===/
 
+#include <fstream>
 #include <iostream>
 
 #include "DataTypes.h"
 #include "Logging.h"
+#include "mpi.h"
 
 #include "spdlog/sinks/basic_file_sink.h"
 #include "spdlog/sinks/ringbuffer_sink.h"
@@ -122,14 +125,153 @@ int testYaklDataTypes() {
    return RetVal;
 }
 
+int testAsyncLogging() {
+
+   int RetVal                    = 0;
+   const std::string LogFilePath = "tmpasynclog.log";
+   const int NMsgs               = 100;
+
+   std::remove(LogFilePath.c_str());
+
+   // Use a small queue with the blocking policy so no messages are lost.
+   // Initializing twice reuses the thread pool of the first logger.
+   initLogging(LogFilePath, LogModeAsync, true, 16, LogOverflowBlock);
+   initLogging(LogFilePath, LogModeAsync, true, 16, LogOverflowBlock);
+   for (int I = 0; I < NMsgs; ++I) {
+      LOG_INFO("Async message {}", I);
+   }
+
+   // Shutting down drains the queue and joins the background thread
+   spdlog::shutdown();
+
+   std::ifstream LogFile(LogFilePath);
+   std::string Line;
+   int NLines = 0;
+   while (std::getline(LogFile, Line)) {
+      if (hasEnding(Line, "Async message " + std::to_string(NLines)))
+         ++NLines;
+   }
+
+   if (NLines == NMsgs) {
+      std::cout << "Async logging: PASS" << std::endl;
+   } else {
+      std::cout << "Async logging: FAIL" << std::endl;
+      RetVal = -1;
+   }
+
+   std::remove(LogFilePath.c_str());
+
+   return RetVal;
+}
+
+int testNoWriteLogging() {
+
+   int RetVal                    = 0;
+   const std::string LogFilePath = "tmpnolog.log";
+
+   std::remove(LogFilePath.c_str());
+
+   // A task that does not write should never create the log file
+   initLogging(LogFilePath, LogModeAsync, false);
+   LOG_INFO("This shouldn't be logged.");
+   spdlog::shutdown();
+
+   std::ifstream LogFile(LogFilePath);
+   if (!LogFile.good()) {
+      std::cout << "Logging disabled on task: PASS" << std::endl;
+   } else {
+      std::cout << "Logging disabled on task: FAIL" << std::endl;
+      RetVal = -1;
+   }
+
+   return RetVal;
+}
+
+int testAggregatedLogging(int MyTask, int NTasks) {
+
+   int RetVal                    = 0;
+   const std::string LogFilePath = "tmpagglog.log";
+   const int LastTask            = NTasks - 1;
+
+   // Buffer at most 3 messages per task so the last task drops one
+   RetVal = initAggregatedLogging(LogFilePath, MPI_COMM_WORLD, 0, 3);
+
+   LOG_INFO("Common message");
+   LOG_INFO("Task {} message", MyTask);
+   if (MyTask == LastTask) {
+      LOG_INFO("Extra message 1");
+      LOG_INFO("Extra message 2");
+   }
+   RetVal -= gatherLogs();
+
+   // Finalizing writes the messages logged since the last gather
+   LOG_INFO("Final message");
+   RetVal -= finalizeAggregatedLogging();
+
+   if (MyTask == 0) {
+      std::vector<std::string> Expected;
+      if (NTasks > 1) {
+         Expected.push_back("[info] " + std::to_string(NTasks) +
+                            " tasks reported: Common message");
+      } else {
+         Expected.push_back("[info] task 0 reported: Common message");
+      }
+      for (int Task = 0; Task < NTasks; ++Task) {
+         Expected.push_back("[info] task " + std::to_string(Task) +
+                            " reported: Task " + std::to_string(Task) +
+                            " message");
+      }
+      Expected.push_back("[info] task " + std::to_string(LastTask) +
+                         " reported: Extra message 1");
+      Expected.push_back("[warning] task " + std::to_string(LastTask) +
+                         " reported: 1 log messages dropped (buffer full)");
+      if (NTasks > 1) {
+         Expected.push_back("[info] " + std::to_string(NTasks) +
+                            " tasks reported: Final message");
+      } else {
+         Expected.push_back("[info] task 0 reported: Final message");
+      }
+
+      std::ifstream LogFile(LogFilePath);
+      std::string Line;
+      std::size_t NMatch = 0;
+      std::size_t NLines = 0;
+      while (std::getline(LogFile, Line)) {
+         if (NLines < Expected.size() && Line == Expected[NLines])
+            ++NMatch;
+         ++NLines;
+      }
+      if (NMatch != Expected.size() || NLines != Expected.size())
+         RetVal = -1;
+   }
+   MPI_Bcast(&RetVal, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+   if (RetVal == 0) {
+      std::cout << "Aggregated logging: PASS" << std::endl;
+   } else {
+      std::cout << "Aggregated logging: FAIL" << std::endl;
+   }
+
+   if (MyTask == 0)
+      std::remove(LogFilePath.c_str());
+
+   return RetVal;
+}
+
 int main(int argc, char **argv) {
 
    int RetVal                    = 0;
    const std::string LogFilePath = "tmplog.log";
 
+   MPI_Init(&argc, &argv);
+   int MyTask, NTasks;
+   MPI_Comm_rank(MPI_COMM_WORLD, &MyTask);
+   MPI_Comm_size(MPI_COMM_WORLD, &NTasks);
+
    try {
 
-      std::remove(LogFilePath.c_str());
+      if (MyTask == 0)
+         std::remove(LogFilePath.c_str());
 
       std::vector<spdlog::sink_ptr> sinks;
       sinks.push_back(
@@ -141,8 +283,14 @@ int main(int argc, char **argv) {
 
       initLogging(logger);
 
-      RetVal -= testDefaultLogLevel();
-      RetVal -= testYaklDataTypes();
+      // The single-task tests share files so only run them on one task
+      if (MyTask == 0) {
+         RetVal -= testDefaultLogLevel();
+         RetVal -= testYaklDataTypes();
+         RetVal -= testAsyncLogging();
+         RetVal -= testNoWriteLogging();
+      }
+      RetVal -= testAggregatedLogging(MyTask, NTasks);
 
       // std::remove(LogFilePath.c_str());
 
@@ -154,5 +302,7 @@ int main(int argc, char **argv) {
       RetVal -= -1;
    }
 
+   MPI_Finalize();
+
    return RetVal;
 }
@@ -0,0 +1,191 @@
+//===-- Test driver for OMEGA Timer ------------------------------*- C++ -*-===/
+//
+/// \file
+/// \brief Test driver for OMEGA timers
+///
+/// This driver tests the OMEGA hierarchical timers. It times a set of
+/// nested regions, checks the local call counts and times, checks that
+/// timers are not recorded when disabled and that mismatched stops are
+/// detected, and finally checks the cross-task summary for regions that
+/// are only timed on some tasks and have a known load imbalance.
+///
+//
+//===-----------------------------------------------------------------------===/
+
+#include "Timer.h"
+#include "DataTypes.h"
+#include "Logging.h"
+#include "MachEnv.h"
+#include "mpi.h"
+
+#include <string>
+#include <vector>
+
+using namespace OMEGA;
+
+//------------------------------------------------------------------------------
+// Waits for the given number of seconds
+void busyWait(R8 Seconds // [in] time to wait
+) {
+   R8 Begin = MPI_Wtime();
+   while (MPI_Wtime() - Begin < Seconds) {
+   }
+} // end busyWait
+
+//------------------------------------------------------------------------------
+// Logs the result of a single test and increments the error count on failure
+void checkResult(bool Pass,                   // [in] result of test
+                 const std::string &TestName, // [in] name of test
+                 int &NumErrs                 // [inout] error count
+) {
+   if (Pass) {
+      LOG_INFO("TimerTest: {} PASS", TestName);
+   } else {
+      LOG_INFO("TimerTest: {} FAIL", TestName);
+      ++NumErrs;
+   }
+} // end checkResult
+
+//------------------------------------------------------------------------------
+// The test driver for Timer
+//
+int main(int argc, char *argv[]) {
+
+   int Err     = 0;
+   int NumErrs = 0;
+
+   // Initialize the global MPI environment
+   MPI_Init(&argc, &argv);
+
+   // Initialize the Machine Environment and retrieve the default environment
+   MachEnv::init(MPI_COMM_WORLD);
+   MachEnv *DefEnv = MachEnv::getDefaultEnv();
+   I4 MyTask       = DefEnv->getMyTask();
+   I4 NumTasks     = DefEnv->getNumTasks();
+
+   // Timers are not recorded before they are initialized
+   {
+      TimerScope Scope("Uninit");
+   }
+   checkResult(!Timer::isEnabled(), "disabled before init", NumErrs);
+
+   Timer::init(DefEnv->getComm());
+   checkResult(Timer::isEnabled(), "enabled after init", NumErrs);
+
+   // Time a set of nested regions, with the same inner name used under
+   // two different parents
+   const I4 NumIter = 4;
+   {
+      TimerScope Outer("Outer");
+      for (int Iter = 0; Iter < NumIter; ++Iter) {
+         TimerScope Inner("Inner");
+         busyWait(0.001);
+      }
+      {
+         TimerScope Other("Other");
+         TimerScope Inner("Inner");
+         busyWait(0.001);
+      }
+   }
+
+   checkResult(Timer::getCount("Outer") == 1, "outer count", NumErrs);
+   checkResult(Timer::getCount("Outer/Inner") == NumIter, "inner count",
+               NumErrs);
+   checkResult(Timer::getCount("Outer/Other/Inner") == 1, "nested name",
+               NumErrs);
+   checkResult(Timer::getCount("Inner") == 0 &&
+                   Timer::getTime("Outer/Missing") == 0.0,
+               "missing region", NumErrs);
+   checkResult(Timer::getTime("Outer/Inner") >= NumIter * 0.001 &&
+                   Timer::getTime("Outer") >= Timer::getTime("Outer/Inner") +
+                                                  Timer::getTime("Outer/Other"),
+               "nested times", NumErrs);
+
+   // Explicit start and stop, including a mismatched stop
+   Timer::start("Explicit");
+   Err = Timer::stop("Wrong");
+   checkResult(Err != 0, "mismatched stop", NumErrs);
+   Err = Timer::stop("Explicit");
+   checkResult(Err == 0 && Timer::getCount("Explicit") == 1, "explicit stop",
+               NumErrs);
+   Err = Timer::stop("Explicit");
+   checkResult(Err != 0, "stop with no running region", NumErrs);
+
+   // Regions are not recorded while disabled, but a region started before
+   // disabling is still stopped
+   Timer::start("Toggle");
+   Timer::disable();
+   {
+      TimerScope Scope("Disabled");
+   }
+   Err = Timer::stop("Toggle");
+   Timer::enable();
+   checkResult(Err == 0 && Timer::getCount("Toggle") == 1 &&
+                   Timer::getCount("Toggle/Disabled") == 0,
+               "disabled timers", NumErrs);
+
+   // Time a region with a known imbalance on the odd tasks only
+   R8 Wait = 0.01 * (MyTask + 1);
+   if (MyTask % 2 == 1) {
+      TimerScope Scope("OddTasks");
+      busyWait(Wait);
+   }
+
+   std::vector<TimerSummary> Summary;
+   Err = Timer::summarize(Summary);
+   checkResult(Err == 0, "summarize", NumErrs);
+
+   // Regions must be in tree order with the same list on all tasks
+   // (assumes at least two tasks so that OddTasks was timed somewhere)
+   const I4 NumRegions           = 7;
+   const char *Paths[NumRegions] = {"Explicit",    "OddTasks",
+                                    "Outer",       "Outer/Inner",
+                                    "Outer/Other", "Outer/Other/Inner",
+                                    "Toggle"};
+   bool OrderOK = Summary.size() == NumRegions;
+   for (int N = 0; OrderOK && N < NumRegions; ++N)
+      OrderOK = Summary[N].Path == Paths[N];
+   checkResult(OrderOK && Summary[5].Depth == 2, "summary order", NumErrs);
+
+   // Check the reduced values for the imbalanced region
+   I4 NumOdd = NumTasks / 2;
+   if (NumOdd > 0 && OrderOK) {
+      const TimerSummary &Odd = Summary[1];
+      R8 MaxWait = 0.01 * (NumTasks % 2 == 0 ? NumTasks : NumTasks - 1);
+      checkResult(Odd.NumTasks == NumOdd && Odd.Count == NumOdd,
+                  "summary tasks", NumErrs);
+      checkResult(Odd.MinTime >= 0.02 && Odd.MaxTime >= MaxWait &&
+                      Odd.MinTime <= Odd.MeanTime &&
+                      Odd.MeanTime <= Odd.MaxTime,
+                  "summary times", NumErrs);
+      checkResult(NumOdd == 1 ? Odd.Imbalance >= 0.0 : Odd.Imbalance > 0.0,
+                  "summary imbalance", NumErrs);
+   }
+
+   checkResult(OrderOK && Summary[2].NumTasks == NumTasks &&
+                   Summary[2].Count == NumTasks,
+               "summary all tasks", NumErrs);
+
+   // Clearing fails while a region is running
+   Timer::start("Running");
+   Err = Timer::clear();
+   checkResult(Err != 0, "clear while running", NumErrs);
+   Timer::stop("Running");
+
+   // Finalize writes the summary and disables the timers
+   Err = Timer::finalize();
+   checkResult(Err == 0 && !Timer::isEnabled() &&
+                   Timer::getCount("Outer") == 0,
+               "finalize", NumErrs);
+
+   if (NumErrs == 0) {
+      LOG_INFO("TimerTest: Successful completion");
+   }
+
+   // Finalize environments
+   MPI_Finalize();
+
+   return NumErrs;
+
+} // end of main
+//===-----------------------------------------------------------------------===/